@@ -57,6 +57,7 @@
 
 #include "Transaction.h"   // Transaction class - represents individual data entries (posts, likes, etc.)
                            // Each block can contain multiple transactions bundled together
+#include "../utils/Probes.h"  // BITEA_PROBE* - mine__start/mine__progress USDT probes
 
 // ============================================================================
 // BLOCK CLASS DEFINITION
@@ -246,9 +247,10 @@ private:
     int difficulty;
 
     // ========================================================================
-    // PRIVATE HELPER METHODS (Internal Cryptographic Operations)
+    // HASHING (Public: read-only, also exercised by benchmarks)
     // ========================================================================
-    
+
+public:
     /**
      * @brief Calculates the SHA-256 hash of this block's contents
      * @return std::string - 64-character hexadecimal hash
@@ -289,6 +291,11 @@ private:
         return sha256(ss.str());
     }
 
+    // ========================================================================
+    // PRIVATE HELPER METHODS (Internal Cryptographic Operations)
+    // ========================================================================
+
+private:
     /**
      * @brief Computes SHA-256 cryptographic hash of input data
      * @param data Input string to hash
@@ -506,11 +513,13 @@ public:
         // Create target pattern: string of zeros matching difficulty
         // Example: difficulty=4 → target="0000"
         std::string target(difficulty, '0');
+        BITEA_PROBE2(mine__start, index, difficulty);
         
         // Proof-of-Work loop: increment nonce until valid hash found
         do {
             nonce++;  // Try next nonce value
             hash = calculateHash();  // Recalculate hash with new nonce
+            if ((nonce & 0xFFF) == 0) BITEA_PROBE2(mine__progress, index, nonce);
             
             // Loop continues while hash doesn't start with required zeros
         } while (hash.substr(0, difficulty) != target);
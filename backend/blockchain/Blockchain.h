@@ -63,10 +63,10 @@
 #include <memory>      // std::shared_ptr, std::make_shared - smart pointers for memory management
                        // WHY: Automatic memory cleanup, shared ownership of blocks, exception safety
 
-#include <mutex>       // std::mutex, std::lock_guard - thread synchronization primitives
+#include <mutex>       // std::mutex - underlying lock of chainMutex (ProfiledMutex)
                        // WHY: Protects blockchain from race conditions during concurrent access
 
-#include <iostream>    // std::cout, std::endl - console output for logging
+#include <iostream>    // std::cout, std::endl - printChain() console dump
                        // WHY: User feedback during mining, debugging information
 
 // ============================================================================
@@ -75,6 +75,10 @@
 
 #include "Block.h"        // Block class - individual blockchain blocks with mining capability
 #include "Transaction.h"  // Transaction class - data entries stored in blocks
+#include "../utils/Logger.h"  // BITEA_LOG_* - asynchronous logging (mining, validation)
+#include "../utils/Trace.h"   // TraceScope - mining/validation spans in request traces
+#include "../utils/ProfiledMutex.h" // chainMutex with wait/hold statistics
+#include "../utils/Probes.h"   // BITEA_PROBE* - mempool__add/block__sealed USDT probes
 
 // ============================================================================
 // BLOCKCHAIN CLASS DEFINITION
@@ -229,7 +233,7 @@ private:
     
     /**
      * @brief Mutex for thread-safe access to blockchain state
-     * @type std::mutex (mutual exclusion lock)
+     * @type ProfiledMutex (std::mutex + wait/hold statistics, /debug/locks)
      * 
      * PURPOSE: Prevents race conditions when multiple threads access blockchain
      * 
@@ -246,7 +250,7 @@ private:
      * Without mutex, these could corrupt blockchain state
      * 
      * USAGE PATTERN:
-     * std::lock_guard<std::mutex> lock(chainMutex);
+     * ProfiledLock lock(chainMutex, "siteName");
      * - Automatically locks mutex on construction
      * - Automatically unlocks on destruction (RAII pattern)
      * - Exception-safe (unlocks even if exception thrown)
@@ -260,7 +264,7 @@ private:
      * Only one mutex used, so no deadlock possible
      * Lock held for minimal time (avoid long operations while locked)
      */
-    std::mutex chainMutex;
+    ProfiledMutex chainMutex{"blockchain"};
     
     /**
      * @brief Maximum number of transactions allowed per block
@@ -432,7 +436,7 @@ public:
      * PURPOSE: Accepts user actions (posts, likes) and queues them for mining
      * 
      * THREAD SAFETY:
-     * std::lock_guard<std::mutex> lock(chainMutex);
+     * ProfiledLock lock(chainMutex, "addTransaction");
      * - Acquires exclusive lock on entry
      * - Releases lock on function exit (RAII pattern)
      * - Prevents concurrent modification of pendingTransactions
@@ -471,11 +475,14 @@ public:
      * Current: void (fire-and-forget, transaction always accepted)
      */
     void addTransaction(const Transaction& transaction) {
+        TraceScope phase("blockchain.addTransaction");
+
         // Acquire lock to protect pendingTransactions from concurrent access
-        std::lock_guard<std::mutex> lock(chainMutex);
+        ProfiledLock lock(chainMutex, "addTransaction");
         
         // Add transaction to pending pool
         pendingTransactions.push_back(transaction);
+        BITEA_PROBE1(mempool__add, pendingTransactions.size());
         
         // Auto-mine if we have enough pending transactions
         // size_t (unsigned) >= int (signed) comparison works via implicit conversion
@@ -552,9 +559,11 @@ public:
      * This design allows efficient calling from addTransaction (already locked).
      */
     void minePendingTransactions() {
+        TraceScope phase("blockchain.mine");
+
         // Early return if no transactions to mine
         if (pendingTransactions.empty()) {
-            std::cout << "No pending transactions to mine." << std::endl;
+            BITEA_LOG_DEBUG("Blockchain", "No pending transactions to mine");
             return;
         }
 
@@ -581,14 +590,15 @@ public:
         );
         
         // Log mining start for monitoring
-        std::cout << "Mining block " << newBlock->getIndex() << " with " 
-                  << blockTransactions.size() << " transactions..." << std::endl;
+        BITEA_LOG_INFO("Blockchain", "Mining block %d with %zu transactions...",
+                       newBlock->getIndex(), blockTransactions.size());
         
         // Perform Proof-of-Work mining (CPU-intensive, may take time)
         newBlock->mineBlock();
         
         // Add successfully mined block to the end of the chain
         chain.push_back(newBlock);
+        BITEA_PROBE3(block__sealed, newBlock->getIndex(), newBlock->getNonce(), txCount);
         
         // Remove mined transactions from pending pool
         // Erase range: [begin, begin+txCount)
@@ -596,7 +606,7 @@ public:
                                   pendingTransactions.begin() + txCount);
         
         // Log successful mining with resulting hash
-        std::cout << "Block mined successfully! Hash: " << newBlock->getHash() << std::endl;
+        BITEA_LOG_INFO("Blockchain", "Block mined successfully! Hash: %s", newBlock->getHash().c_str());
     }
 
     /**
@@ -619,10 +629,10 @@ public:
      * - Testing: Trigger mining on demand
      * 
      * THREAD SAFETY:
-     * std::lock_guard automatically locks chainMutex for entire scope
+     * ProfiledLock automatically locks chainMutex for entire scope
      */
     void minePendingTransactionsPublic() {
-        std::lock_guard<std::mutex> lock(chainMutex);  // Acquire lock
+        ProfiledLock lock(chainMutex, "mine");         // Acquire lock
         minePendingTransactions();                     // Call internal mining logic
     }
 
@@ -707,6 +717,8 @@ public:
      * - Periodic integrity audits
      */
     bool isChainValid() const {
+        TraceScope phase("blockchain.validate");
+
         // Validate each block starting from index 1 (skip genesis)
         for (size_t i = 1; i < chain.size(); i++) {
             const auto& currentBlock = chain[i];    // Block being validated
@@ -714,13 +726,13 @@ public:
 
             // CHECK 1: Verify block's Proof-of-Work and data integrity
             if (!currentBlock->isValid()) {
-                std::cout << "Block " << i << " has invalid hash." << std::endl;
+                BITEA_LOG_WARN("Blockchain", "Block %zu has invalid hash", i);
                 return false;  // Block failed validation
             }
 
             // CHECK 2: Verify chain link (previousHash matches previous block's hash)
             if (currentBlock->getPreviousHash() != previousBlock->getHash()) {
-                std::cout << "Block " << i << " has invalid previous hash." << std::endl;
+                BITEA_LOG_WARN("Blockchain", "Block %zu has invalid previous hash", i);
                 return false;  // Chain link broken
             }
         }
@@ -0,0 +1,110 @@
+#ifndef FEEDCURSOR_H
+#define FEEDCURSOR_H
+
+/*
+ * ============================================================================
+ * FeedCursor - Keyset Pagination Position for the Post Feed
+ * ============================================================================
+ *
+ * PURPOSE:
+ * Marks where a feed page ended so the next page can continue from there
+ * without OFFSET/skip. The feed is ordered newest first by
+ * (timestamp DESC, postId DESC); postId breaks ties between posts created
+ * in the same second.
+ *
+ * WHY KEYSET INSTEAD OF PAGE NUMBERS:
+ * - skip(n) makes the database walk and discard n documents: O(offset)
+ * - Seeking to (timestamp, postId) on a matching index is O(log n + page)
+ * - Posts inserted while a client pages do not shift later pages
+ *
+ * WIRE FORMAT (opaque to clients):
+ * base64url("<timestamp>:<postId>") without padding, e.g.
+ *   1729600000:alice-1729600000  →  "MTcyOTYwMDAwMDphbGljZS0xNzI5NjAwMDAw"
+ * Clients must treat it as an opaque token and only echo it back.
+ *
+ * USED BY:
+ * - MongoClient::getPostsPage() (real and mock backends)
+ * - GET /api/posts?limit=N&cursor=TOKEN (main.cpp)
+ *
+ * Also defines FeedChanges, the result of the delta sync query
+ * (MongoClient::getPostChanges, GET /api/posts/changes).
+ * ============================================================================
+ */
+
+#include <cstdint>      // int64_t - timestamp
+#include <string>       // std::string - post ID, encoded token
+#include <string_view>  // std::string_view - token parsing
+#include <vector>       // std::vector - page contents
+#include <charconv>     // std::from_chars - timestamp parsing
+#include "../models/Post.h"  // Post - page contents, cursor source
+#include "../utils/Base64Url.h"  // base64UrlEncode/Decode - token format
+
+struct FeedCursor {
+    int64_t timestamp = 0;  // Timestamp of the last post already returned
+    std::string postId;     // Its ID; empty = start from the newest post
+
+    /** @brief True for the first page (no position yet) */
+    bool isStart() const { return postId.empty(); }
+
+    /** @brief Position just after the given post */
+    static FeedCursor after(const Post& post) {
+        FeedCursor cursor;
+        cursor.timestamp = static_cast<int64_t>(post.getTimestamp());
+        cursor.postId = post.getId();
+        return cursor;
+    }
+
+    /** @brief Opaque token handed to clients */
+    std::string encode() const {
+        return base64UrlEncode(std::to_string(timestamp) + ":" + postId);
+    }
+
+    /**
+     * @brief Parses a client-supplied token
+     * @return false if the token is malformed (caller answers 400)
+     */
+    static bool decode(std::string_view token, FeedCursor& out) {
+        if (token.size() > 512) return false;
+
+        std::string raw;
+        if (!base64UrlDecode(token, raw)) return false;
+
+        size_t colon = raw.find(':');
+        if (colon == std::string::npos || colon + 1 >= raw.size()) return false;
+        int64_t timestamp = 0;
+        auto result = std::from_chars(raw.data(), raw.data() + colon, timestamp);
+        if (result.ec != std::errc() || result.ptr != raw.data() + colon) return false;
+
+        out.timestamp = timestamp;
+        out.postId = raw.substr(colon + 1);
+        return true;
+    }
+};
+
+/*
+ * One page of the feed
+ * - posts: at most 'limit' posts, newest first
+ * - nextCursor: token for the following page, empty on the last page
+ */
+struct FeedPage {
+    std::vector<Post> posts;
+    std::string nextCursor;
+};
+
+/*
+ * Posts created or modified after a change sequence number
+ * - posts: changed posts in change order (oldest change first), each once
+ * - version: sequence of the last change included; pass it as ?since= next
+ * - hasMore: more changes exist beyond 'limit' (ask again with 'version')
+ *
+ * Every insertPost()/updatePost() takes the next value of a per-database
+ * counter and stores it on the post, so a post appears once, at its latest
+ * change.
+ */
+struct FeedChanges {
+    std::vector<Post> posts;
+    uint64_t version = 0;
+    bool hasMore = false;
+};
+
+#endif // FEEDCURSOR_H
@@ -36,8 +36,11 @@
  * 6. Blockchain.minePendingTransactions() creates immutable block
  * 
  * THREAD SAFETY:
- * All public methods use mongoMutex to prevent race conditions when multiple
- * HTTP requests access the database simultaneously.
+ * Real driver: every public method checks a client out of a mongocxx::pool
+ * for the duration of one operation, so storage threads query MongoDB in
+ * parallel (up to maxPoolSize; see setPoolSize()). Only post writes share
+ * changeMutex, which keeps delta-sync sequence numbers in commit order.
+ * Mock: one mongoMutex guards the in-memory maps.
  * 
  * CONDITIONAL COMPILATION:
  * - If HAS_MONGODB is defined: Uses real MongoDB C++ driver
@@ -47,16 +50,20 @@
 
 #include <string>
 #include <memory>
-#include <iostream>
 #include <vector>
 #include <algorithm>
-#include <mutex>
 #include "../models/User.h"  // User model with username, email, password, profile data
 #include "../models/Post.h"  // Post model with content, author, timestamp, likes
+#include "FeedCursor.h"        // FeedCursor, FeedPage - keyset pagination for the feed
+#include <atomic>  // std::atomic - pooled clients in use
+#include "../utils/Logger.h"  // BITEA_LOG_* - asynchronous logging (never blocks under a lock)
+#include "../utils/Metrics.h" // BITEA_TIME_DB_CALL, pool wait histogram
+#include "../utils/ProfiledMutex.h" // changeMutex / mock mongoMutex with wait/hold statistics
 
 #ifdef HAS_MONGODB
 #include <mongocxx/client.hpp>
 #include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/uri.hpp>
 #include <bsoncxx/json.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
@@ -67,12 +74,85 @@ private:
     std::string connectionString;  // MongoDB URI (e.g., "mongodb://localhost:27017")
     std::string databaseName;      // Database name (default: "bitea")
     bool connected;                // Connection status flag
-    std::mutex mongoMutex;         // Thread safety: Protects all MongoDB operations from concurrent HTTP requests
+    size_t minPoolSize;            // Clients kept when idle (URI minPoolSize)
+    size_t maxPoolSize;            // Clients at most; acquire() waits beyond (URI maxPoolSize)
     
     // ========== MONGODB DRIVER OBJECTS ==========
     static mongocxx::instance instance; // MongoDB driver instance (MUST be initialized once globally)
-    std::unique_ptr<mongocxx::client> client;  // MongoDB connection client
-    mongocxx::database database;               // Active database handle
+    std::unique_ptr<mongocxx::pool> pool;  // Thread-safe client pool, one client per operation
+    mutable std::atomic<int> leasedClients{0};  // Clients currently checked out
+    
+    // Post writes only: change sequence allocation + the write that stores it
+    // (see nextChangeSeq); contention stats: /debug/locks
+    ProfiledMutex changeMutex{"mongodb.changes"};
+
+    /*
+     * HELPER CLASS: Lease - one pooled client, checked out for one operation
+     * 
+     * Returns the client to the pool when it goes out of scope (the
+     * pool::entry deleter) and keeps leasedClients up to date for /metrics.
+     * mongocxx::client is not thread-safe: a lease must stay on the
+     * thread that acquired it.
+     */
+    class Lease {
+    public:
+        Lease(mongocxx::pool::entry entry, std::atomic<int>& leased)
+            : entry(std::move(entry)), leased(leased) {
+            leased.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~Lease() { leased.fetch_sub(1, std::memory_order_relaxed); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        mongocxx::client& operator*() { return *entry; }
+
+    private:
+        mongocxx::pool::entry entry;
+        std::atomic<int>& leased;
+    };
+
+    /*
+     * HELPER METHOD: Check out a client for one operation
+     * 
+     * Blocks while maxPoolSize clients are in use (throws after the URI's
+     * waitQueueTimeoutMS, if set; callers' try blocks turn that into a
+     * failed operation). The wait is observed into the
+     * bitea_mongodb_pool_wait_seconds histogram and shows up as a
+     * "mongodb.acquire" span in the request trace.
+     */
+    Lease acquire() const {
+        static const int waitSeries = [] {
+            Metrics::instance().describe("bitea_mongodb_pool_wait_seconds", MetricType::HISTOGRAM,
+                                         "Time spent waiting for a pooled MongoDB client");
+            return Metrics::instance().series("bitea_mongodb_pool_wait_seconds", "");
+        }();
+        mongocxx::pool::entry entry;
+        {
+            ScopedLatency wait(waitSeries);
+            TraceScope phase("mongodb.acquire");
+            entry = pool->acquire();
+        }
+        return Lease(std::move(entry), leasedClients);
+    }
+
+    /*
+     * HELPER METHOD: Connection URI with the pool size options appended
+     * (they take precedence over the same options in connectionString)
+     */
+    std::string poolUri() const {
+        std::string uri = connectionString;
+        size_t hosts = uri.find("://");
+        hosts = hosts == std::string::npos ? 0 : hosts + 3;
+        if (uri.find('?') != std::string::npos) {
+            uri += '&';
+        } else {
+            if (uri.find('/', hosts) == std::string::npos) uri += '/';
+            uri += '?';
+        }
+        uri += "minPoolSize=" + std::to_string(minPoolSize) +
+               "&maxPoolSize=" + std::to_string(maxPoolSize);
+        return uri;
+    }
 
     /*
      * HELPER METHOD: Convert User to BSON Document
@@ -177,7 +257,7 @@ private:
      * - likesCount: Number of likes (updated when users like)
      * - commentsCount: Number of comments
      */
-    bsoncxx::document::value postToBson(const Post& post) {
+    bsoncxx::document::value postToBson(const Post& post, int64_t changeSeq) {
         using bsoncxx::builder::stream::document;
         using bsoncxx::builder::stream::finalize;
         
@@ -187,11 +267,87 @@ private:
             << "content" << post.getContent()
             << "timestamp" << static_cast<int64_t>(post.getTimestamp())
             << "likesCount" << post.getLikeCount()
-            << "commentsCount" << post.getCommentCount();
+            << "commentsCount" << post.getCommentCount()
+            << "changeSeq" << changeSeq;
         
         return doc << finalize;
     }
 
+    /*
+     * HELPER METHOD: Build a find() projection for a PostFields mask
+     * 
+     * PURPOSE: ?fields= pushdown - MongoDB only sends what the client asked for
+     * 
+     * ALWAYS INCLUDED: postId, timestamp (feed order, cursors), changeSeq
+     * (delta sync version)
+     * 
+     * PREVIEW: Without "content", "preview" projects
+     *   content: { $substrCP: ["$content", 0, PREVIEW_LENGTH] }
+     * so only the prefix crosses the network (aggregation expressions in
+     * find projections need MongoDB 4.4+)
+     */
+    bsoncxx::document::value postProjection(uint32_t fields) {
+        using bsoncxx::builder::stream::document;
+        using bsoncxx::builder::stream::finalize;
+        using bsoncxx::builder::stream::open_array;
+        using bsoncxx::builder::stream::close_array;
+        using bsoncxx::builder::stream::open_document;
+        using bsoncxx::builder::stream::close_document;
+        
+        document projection{};
+        projection << "_id" << 0 << "postId" << 1 << "timestamp" << 1 << "changeSeq" << 1;
+        if (fields & PostFields::AUTHOR) projection << "author" << 1;
+        if (fields & PostFields::CONTENT) {
+            projection << "content" << 1;
+        } else if (fields & PostFields::PREVIEW) {
+            projection << "content" << open_document
+                       << "$substrCP" << open_array
+                           << "$content" << 0 << static_cast<int32_t>(PostFields::PREVIEW_LENGTH)
+                       << close_array
+                       << close_document;
+        }
+        if (fields & PostFields::LIKES) projection << "likesCount" << 1;
+        if (fields & PostFields::COMMENTS) projection << "commentsCount" << 1;
+        return projection << finalize;
+    }
+
+    /*
+     * HELPER METHOD: Allocate the next post change sequence number
+     * 
+     * PURPOSE: Monotonic version for delta sync (getPostChanges)
+     * 
+     * IMPLEMENTATION:
+     * counters collection, document {_id: "postChanges", seq: N}, bumped with
+     * findOneAndUpdate($inc, upsert, return after): atomic on the server
+     * 
+     * ORDERING:
+     * Called with changeMutex held, in the same critical section as the
+     * write that stores the number. Within one process a reader therefore
+     * never sees seq N+1 committed while N is still pending. Several
+     * server processes sharing one database would need change streams
+     * instead. Only post writes take changeMutex; every other operation
+     * runs concurrently on its own pooled client.
+     * 
+     * RETURNS: New sequence number (throws on database error)
+     */
+    int64_t nextChangeSeq(mongocxx::database& database) {
+        using bsoncxx::builder::stream::document;
+        using bsoncxx::builder::stream::open_document;
+        using bsoncxx::builder::stream::close_document;
+        
+        document filter{};
+        filter << "_id" << "postChanges";
+        document update{};
+        update << "$inc" << open_document << "seq" << static_cast<int64_t>(1) << close_document;
+        
+        mongocxx::options::find_one_and_update opts{};
+        opts.upsert(true);
+        opts.return_document(mongocxx::options::return_document::k_after);
+        
+        auto result = database["counters"].find_one_and_update(filter.view(), update.view(), opts);
+        return result ? result->view()["seq"].get_int64().value : 0;
+    }
+
     /*
      * HELPER METHOD: Convert BSON Document to Post
      * 
@@ -203,14 +359,20 @@ private:
      * - Used in: Homepage feed, user profiles, post detail pages
      */
     Post bsonToPost(const bsoncxx::document::view& doc) {
-        std::string postId = std::string(doc["postId"].get_string().value);
-        std::string author = std::string(doc["author"].get_string().value);
-        std::string content = std::string(doc["content"].get_string().value);
+        // Fields may be missing under a projection (see postProjection)
+        auto text = [&doc](const char* key) {
+            auto element = doc[key];
+            return element ? std::string(element.get_string().value) : std::string();
+        };
+        std::string postId = text("postId");
+        std::string author = text("author");
+        std::string content = text("content");
         
         Post post(postId, author, content);
         
         if (doc["timestamp"]) {
-            // Post timestamp is set in constructor, so this is informational
+            // Constructor stamps "now"; the feed order and cursors need the stored time
+            post.setTimestamp(static_cast<time_t>(doc["timestamp"].get_int64().value));
         }
         
         return post;
@@ -233,9 +395,34 @@ public:
      */
     MongoClient(const std::string& connStr = "mongodb://localhost:27017", 
                 const std::string& dbName = "bitea")
-        : connectionString(connStr), databaseName(dbName), connected(false) {
+        : connectionString(connStr), databaseName(dbName), connected(false),
+          minPoolSize(DEFAULT_MIN_POOL_SIZE), maxPoolSize(DEFAULT_MAX_POOL_SIZE) {
     }
 
+    /*
+     * Pool size defaults: the storage executor runs at most 16 handlers at
+     * once, so 16 clients let every storage thread query concurrently
+     */
+    static constexpr size_t DEFAULT_MIN_POOL_SIZE = 2;
+    static constexpr size_t DEFAULT_MAX_POOL_SIZE = 16;
+
+    /*
+     * METHOD: setPoolSize()
+     * 
+     * PURPOSE: Configure the client pool (call before connect())
+     * - minSize: Clients kept open while idle
+     * - maxSize: Upper bound on concurrent operations; further callers wait
+     *            (bitea_mongodb_pool_wait_seconds)
+     */
+    void setPoolSize(size_t minSize, size_t maxSize) {
+        maxPoolSize = maxSize > 0 ? maxSize : 1;
+        minPoolSize = minSize < maxPoolSize ? minSize : maxPoolSize;
+    }
+
+    /* Pool occupancy for /metrics: clients checked out, configured maximum */
+    int getLeasedClients() const { return leasedClients.load(std::memory_order_relaxed); }
+    size_t getMaxPoolSize() const { return maxPoolSize; }
+
     /*
      * METHOD: connect()
      * 
@@ -247,8 +434,8 @@ public:
      * - After this: All database operations become available
      * 
      * PROCESS:
-     * 1. Creates MongoDB client with connection URI
-     * 2. Sends ping command to verify connection
+     * 1. Creates the client pool (URI + minPoolSize/maxPoolSize)
+     * 2. Sends ping command on a pooled client to verify connection
      * 3. Calls createIndexes() to optimize database performance
      * 
      * RETURNS: true if connected successfully, false otherwise
@@ -257,23 +444,26 @@ public:
      */
     bool connect() {
         try {
-            mongocxx::uri uri(connectionString);
-            client = std::make_unique<mongocxx::client>(uri);
-            database = (*client)[databaseName];
+            mongocxx::uri uri(poolUri());
+            pool = std::make_unique<mongocxx::pool>(uri);
             
             // Test connection by running a ping command
-            auto admin = (*client)["admin"];
-            auto result = admin.run_command(bsoncxx::from_json(R"({"ping": 1})"));
+            {
+                auto client = acquire();
+                auto admin = (*client)["admin"];
+                admin.run_command(bsoncxx::from_json(R"({"ping": 1})"));
+            }
             
             connected = true;
-            std::cout << "[MongoDB] Connected to " << connectionString << "/" << databaseName << std::endl;
+            BITEA_LOG_INFO("MongoDB", "Connected to %s/%s (pool %zu-%zu clients)",
+                           connectionString.c_str(), databaseName.c_str(), minPoolSize, maxPoolSize);
             
             // Create indexes
             createIndexes();
             
             return true;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Connection failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Connection failed: %s", e.what());
             connected = false;
             return false;
         }
@@ -292,6 +482,9 @@ public:
      * 1. users.username (unique) - Fast login, profile lookups
      * 2. posts.postId (unique) - Fast individual post retrieval
      * 3. posts.author - Fast user profile post listing
+     * 4. posts.{timestamp: -1, postId: -1} - Feed order; getPostsPage()
+     *    seeks to the cursor and reads one page off this index
+     * 5. posts.changeSeq - Delta sync; getPostChanges() range scan
      * 
      * PERFORMANCE IMPACT:
      * Without indexes: O(n) linear scan of entire collection
@@ -303,6 +496,8 @@ public:
      */
     void createIndexes() {
         try {
+            auto client = acquire();
+            auto database = (*client)[databaseName];
             auto users_collection = database["users"];
             auto posts_collection = database["posts"];
             
@@ -328,9 +523,19 @@ public:
             author_index << "author" << 1;
             posts_collection.create_index(author_index.view());
             
-            std::cout << "[MongoDB] Indexes created" << std::endl;
+            // Compound index matching the feed sort (keyset pagination)
+            document feed_index{};
+            feed_index << "timestamp" << -1 << "postId" << -1;
+            posts_collection.create_index(feed_index.view());
+            
+            // Index on change sequence for delta sync
+            document change_index{};
+            change_index << "changeSeq" << 1;
+            posts_collection.create_index(change_index.view());
+            
+            BITEA_LOG_INFO("MongoDB", "Indexes created");
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Index creation warning: " << e.what() << std::endl;
+            BITEA_LOG_WARN("MongoDB", "Index creation warning: %s", e.what());
         }
     }
 
@@ -343,8 +548,8 @@ public:
      */
     void disconnect() {
         connected = false;
-        client.reset();
-        std::cout << "[MongoDB] Disconnected" << std::endl;
+        pool.reset();
+        BITEA_LOG_INFO("MongoDB", "Disconnected");
     }
 
     /*
@@ -373,7 +578,7 @@ public:
      * - Frontend: User fills registration form (username, email, password)
      * - Flow: Frontend → HttpServer → insertUser() → MongoDB
      * 
-     * THREAD SAFETY: Uses mongoMutex lock for concurrent registrations
+     * THREAD SAFETY: Runs on its own pooled client, concurrently with others
      * 
      * USER FLOW EXAMPLE:
      * 1. User submits registration form
@@ -385,17 +590,18 @@ public:
      * RETURNS: true if inserted, false if username already exists or error
      */
     bool insertUser(const User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "insertUser");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             auto doc = userToBson(user);
             collection.insert_one(doc.view());
-            std::cout << "[MongoDB] Inserted user: " << user.getUsername() << std::endl;
+            BITEA_LOG_DEBUG("MongoDB", "Inserted user: %s", user.getUsername().c_str());
             return true;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Insert user failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Insert user failed: %s", e.what());
             return false;
         }
     }
@@ -428,11 +634,12 @@ public:
      * RETURNS: true if user found, false otherwise
      */
     bool findUser(const std::string& username, User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "findUser");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -447,7 +654,7 @@ public:
             }
             return false;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Find user failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Find user failed: %s", e.what());
             return false;
         }
     }
@@ -475,11 +682,12 @@ public:
      * RETURNS: true if user found and updated, false otherwise
      */
     bool updateUser(const User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "updateUser");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -501,12 +709,12 @@ public:
             
             auto result = collection.update_one(filter.view(), update.view());
             if (result && result->modified_count() > 0) {
-                std::cout << "[MongoDB] Updated user: " << user.getUsername() << std::endl;
+                BITEA_LOG_DEBUG("MongoDB", "Updated user: %s", user.getUsername().c_str());
                 return true;
             }
             return false;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Update user failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Update user failed: %s", e.what());
             return false;
         }
     }
@@ -531,11 +739,12 @@ public:
      * RETURNS: true if user found and deleted, false otherwise
      */
     bool deleteUser(const std::string& username) {
+        BITEA_TIME_DB_CALL("mongodb", "deleteUser");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -545,12 +754,12 @@ public:
             
             auto result = collection.delete_one(filter.view());
             if (result && result->deleted_count() > 0) {
-                std::cout << "[MongoDB] Deleted user: " << username << std::endl;
+                BITEA_LOG_DEBUG("MongoDB", "Deleted user: %s", username.c_str());
                 return true;
             }
             return false;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Delete user failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Delete user failed: %s", e.what());
             return false;
         }
     }
@@ -587,17 +796,20 @@ public:
      * RETURNS: true if inserted, false if postId collision or error
      */
     bool insertPost(const Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "insertPost");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
+            auto client = acquire();
+            auto database = (*client)[databaseName];
             auto collection = database["posts"];
-            auto doc = postToBson(post);
+            ProfiledLock lock(changeMutex, "insertPost");
+            auto doc = postToBson(post, nextChangeSeq(database));
             collection.insert_one(doc.view());
-            std::cout << "[MongoDB] Inserted post: " << post.getId() << std::endl;
+            BITEA_LOG_DEBUG("MongoDB", "Inserted post: %s", post.getId().c_str());
             return true;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Insert post failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Insert post failed: %s", e.what());
             return false;
         }
     }
@@ -620,11 +832,12 @@ public:
      * RETURNS: true if post found, false otherwise
      */
     bool findPost(const std::string& postId, Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "findPost");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["posts"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -639,7 +852,7 @@ public:
             }
             return false;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Find post failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Find post failed: %s", e.what());
             return false;
         }
     }
@@ -666,10 +879,12 @@ public:
      * RETURNS: true if post found and updated, false otherwise
      */
     bool updatePost(const Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "updatePost");
         if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
+            auto client = acquire();
+            auto database = (*client)[databaseName];
             auto collection = database["posts"];
             
             using bsoncxx::builder::stream::document;
@@ -678,21 +893,23 @@ public:
             document filter{};
             filter << "postId" << post.getId();
             
+            ProfiledLock lock(changeMutex, "updatePost");
             document update{};
             update << "$set" << bsoncxx::builder::stream::open_document
                    << "content" << post.getContent()
                    << "likesCount" << post.getLikeCount()
                    << "commentsCount" << post.getCommentCount()
+                   << "changeSeq" << nextChangeSeq(database)  // Post shows up in delta sync again
                    << bsoncxx::builder::stream::close_document;
             
             auto result = collection.update_one(filter.view(), update.view());
             if (result && result->modified_count() > 0) {
-                std::cout << "[MongoDB] Updated post: " << post.getId() << std::endl;
+                BITEA_LOG_DEBUG("MongoDB", "Updated post: %s", post.getId().c_str());
                 return true;
             }
             return false;
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Update post failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Update post failed: %s", e.what());
             return false;
         }
     }
@@ -718,18 +935,19 @@ public:
      * 5. Frontend (app.js) renders posts in feed
      * 
      * PERFORMANCE:
-     * - Uses MongoDB sort with timestamp index
-     * - Consider pagination for large databases (limit + skip)
+     * - Sorts and materializes the whole collection: O(n)
+     * - The HTTP feed uses getPostsPage() instead
      * 
      * RETURNS: Vector of Post objects (empty if no posts or error)
      */
     std::vector<Post> getAllPosts() {
+        BITEA_TIME_DB_CALL("mongodb", "getAllPosts");
         std::vector<Post> result;
         if (!connected) return result;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["posts"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -747,12 +965,168 @@ public:
                 result.push_back(bsonToPost(doc));
             }
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Get all posts failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Get all posts failed: %s", e.what());
         }
         
         return result;
     }
 
+    /*
+     * METHOD: getPostsPage()
+     * 
+     * PURPOSE: Retrieve one page of the feed, newest first
+     * 
+     * INTERACTION WITH BITEA:
+     * - Called by: HttpServer for GET /api/posts?limit=N&cursor=TOKEN
+     * 
+     * QUERY (keyset pagination, no skip):
+     *   filter: { $or: [ { timestamp: { $lt: ts } },
+     *                    { timestamp: ts, postId: { $lt: id } } ] }
+     *   sort:   { timestamp: -1, postId: -1 }   ← matches the feed index
+     *   limit:  limit + 1   (the extra document only tells us a next page exists)
+     * 
+     * PERFORMANCE:
+     * - O(log n + limit) index seek, independent of collection size
+     *   and of how deep the client has paged
+     * 
+     * PARAMETERS:
+     * - after: Position after the last post of the previous page
+     *          (FeedCursor{} for the first page)
+     * - limit: Maximum posts to return (caller clamps it)
+     * - page: Receives posts and the cursor for the following page
+     * - fields: PostFields the caller will serialize (find() projection)
+     * 
+     * RETURNS: true on success, false on database error
+     */
+    bool getPostsPage(const FeedCursor& after, size_t limit, FeedPage& page,
+                      uint32_t fields = PostFields::SUMMARY) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostsPage");
+        page.posts.clear();
+        page.nextCursor.clear();
+        if (!connected) return false;
+        
+        try {
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
+            
+            using bsoncxx::builder::stream::document;
+            using bsoncxx::builder::stream::finalize;
+            using bsoncxx::builder::stream::open_array;
+            using bsoncxx::builder::stream::close_array;
+            using bsoncxx::builder::stream::open_document;
+            using bsoncxx::builder::stream::close_document;
+            
+            document filter{};
+            if (!after.isStart()) {
+                filter << "$or" << open_array
+                       << open_document
+                           << "timestamp" << open_document << "$lt" << after.timestamp << close_document
+                       << close_document
+                       << open_document
+                           << "timestamp" << after.timestamp
+                           << "postId" << open_document << "$lt" << after.postId << close_document
+                       << close_document
+                       << close_array;
+            }
+            
+            document sort_order{};
+            sort_order << "timestamp" << -1 << "postId" << -1;
+            
+            auto projection = postProjection(fields);
+            
+            mongocxx::options::find opts{};
+            opts.sort(sort_order.view());
+            opts.limit(static_cast<int64_t>(limit + 1));
+            opts.projection(projection.view());
+            
+            auto cursor = collection.find(filter.view(), opts);
+            
+            bool more = false;
+            for (auto&& doc : cursor) {
+                if (page.posts.size() == limit) {
+                    more = true;
+                    break;
+                }
+                page.posts.push_back(bsonToPost(doc));
+            }
+            if (more && !page.posts.empty()) {
+                page.nextCursor = FeedCursor::after(page.posts.back()).encode();
+            }
+            return true;
+        } catch (const std::exception& e) {
+            BITEA_LOG_ERROR("MongoDB", "Get posts page failed: %s", e.what());
+            return false;
+        }
+    }
+
+    /*
+     * METHOD: getPostChanges()
+     * 
+     * PURPOSE: Posts created or modified after a change sequence number
+     * 
+     * INTERACTION WITH BITEA:
+     * - Called by: HttpServer for GET /api/posts/changes?since=N
+     * - Frontend: Refreshes by fetching deltas instead of the whole feed
+     * 
+     * QUERY:
+     *   filter: { changeSeq: { $gt: since } }
+     *   sort:   { changeSeq: 1 }   ← changeSeq index
+     *   limit:  limit + 1
+     * 
+     * PERFORMANCE:
+     * - O(log n + changes): proportional to activity since 'since',
+     *   not to the size of the collection
+     * 
+     * PROJECTION: 'fields' as in getPostsPage()
+     * 
+     * RETURNS: true on success, false on database error
+     */
+    bool getPostChanges(uint64_t since, size_t limit, FeedChanges& changes,
+                        uint32_t fields = PostFields::SUMMARY) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostChanges");
+        changes.posts.clear();
+        changes.version = since;
+        changes.hasMore = false;
+        if (!connected) return false;
+        
+        try {
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
+            
+            using bsoncxx::builder::stream::document;
+            using bsoncxx::builder::stream::open_document;
+            using bsoncxx::builder::stream::close_document;
+            
+            document filter{};
+            filter << "changeSeq" << open_document << "$gt" << static_cast<int64_t>(since) << close_document;
+            
+            document sort_order{};
+            sort_order << "changeSeq" << 1;
+            
+            auto projection = postProjection(fields);
+            
+            mongocxx::options::find opts{};
+            opts.sort(sort_order.view());
+            opts.limit(static_cast<int64_t>(limit + 1));
+            opts.projection(projection.view());
+            
+            auto cursor = collection.find(filter.view(), opts);
+            
+            for (auto&& doc : cursor) {
+                if (changes.posts.size() == limit) {
+                    changes.hasMore = true;
+                    break;
+                }
+                changes.posts.push_back(bsonToPost(doc));
+                changes.version = static_cast<uint64_t>(doc["changeSeq"].get_int64().value);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            BITEA_LOG_ERROR("MongoDB", "Get post changes failed: %s", e.what());
+            return false;
+        }
+    }
+
     /*
      * METHOD: getPostsByAuthor()
      * 
@@ -780,12 +1154,13 @@ public:
      * RETURNS: Vector of Post objects (empty if user has no posts)
      */
     std::vector<Post> getPostsByAuthor(const std::string& author) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostsByAuthor");
         std::vector<Post> result;
         if (!connected) return result;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["posts"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
             
             using bsoncxx::builder::stream::document;
             using bsoncxx::builder::stream::finalize;
@@ -805,7 +1180,7 @@ public:
                 result.push_back(bsonToPost(doc));
             }
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Get posts by author failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Get posts by author failed: %s", e.what());
         }
         
         return result;
@@ -833,19 +1208,20 @@ public:
      * RETURNS: Vector of User objects (empty if no users or error)
      */
     std::vector<User> getAllUsers() {
+        BITEA_TIME_DB_CALL("mongodb", "getAllUsers");
         std::vector<User> result;
         if (!connected) return result;
         
-        std::lock_guard<std::mutex> lock(mongoMutex);
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             auto cursor = collection.find({});
             
             for (auto&& doc : cursor) {
                 result.push_back(bsonToUser(doc));
             }
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Get all users failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Get all users failed: %s", e.what());
         }
         
         return result;
@@ -870,14 +1246,15 @@ public:
      * RETURNS: Number of users, or 0 if error/disconnected
      */
     int getUserCount() const {
+        BITEA_TIME_DB_CALL("mongodb", "getUserCount");
         if (!connected) return 0;
         
-        std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(mongoMutex));
         try {
-            auto collection = database["users"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["users"];
             return static_cast<int>(collection.count_documents({}));
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Get user count failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Get user count failed: %s", e.what());
             return 0;
         }
     }
@@ -904,14 +1281,15 @@ public:
      * RETURNS: Number of posts, or 0 if error/disconnected
      */
     int getPostCount() const {
+        BITEA_TIME_DB_CALL("mongodb", "getPostCount");
         if (!connected) return 0;
         
-        std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(mongoMutex));
         try {
-            auto collection = database["posts"];
+            auto client = acquire();
+            auto collection = (*client)[databaseName]["posts"];
             return static_cast<int>(collection.count_documents({}));
         } catch (const std::exception& e) {
-            std::cerr << "[MongoDB] Get post count failed: " << e.what() << std::endl;
+            BITEA_LOG_ERROR("MongoDB", "Get post count failed: %s", e.what());
             return 0;
         }
     }
@@ -945,6 +1323,8 @@ mongocxx::instance MongoClient::instance{};
  * ============================================================================
  */
 #include <map>
+#include <set>
+#include <functional>
 
 class MongoClient {
 private:
@@ -958,21 +1338,54 @@ private:
     std::map<std::string, User> users;  // "users" collection
     std::map<std::string, Post> posts;  // "posts" collection
 
+    // Feed index: (timestamp, postId) in feed order (newest first), the
+    // mock's equivalent of the {timestamp: -1, postId: -1} Mongo index
+    using FeedKey = std::pair<int64_t, std::string>;
+    std::set<FeedKey, std::greater<FeedKey>> feedIndex;
+
+    // Delta sync: change sequence → postId (latest change of each post
+    // only) and the reverse mapping, the mock's changeSeq field + index
+    uint64_t changeSeq = 0;
+    std::map<uint64_t, std::string> changeLog;
+    std::map<std::string, uint64_t> postChangeSeq;
+
+    /** @brief Stamps a post with the next change sequence (mongoMutex held) */
+    void recordChange(const std::string& postId) {
+        auto previous = postChangeSeq.find(postId);
+        if (previous != postChangeSeq.end()) changeLog.erase(previous->second);
+        changeLog[++changeSeq] = postId;
+        postChangeSeq[postId] = changeSeq;
+    }
+
+    // Storage threads call in concurrently, same contract as the real client
+    mutable ProfiledMutex mongoMutex{"mongodb"};
+    size_t maxPoolSize = DEFAULT_MAX_POOL_SIZE;
+
 public:
     MongoClient(const std::string& connStr = "mongodb://localhost:27017", 
                 const std::string& dbName = "bitea")
         : connectionString(connStr), databaseName(dbName), connected(false) {
     }
 
+    // Same configuration surface as the real client; the mock has no
+    // connections, so the pool size is only reported
+    static constexpr size_t DEFAULT_MIN_POOL_SIZE = 2;
+    static constexpr size_t DEFAULT_MAX_POOL_SIZE = 16;
+    void setPoolSize([[maybe_unused]] size_t minSize, size_t maxSize) {
+        maxPoolSize = maxSize > 0 ? maxSize : 1;
+    }
+    int getLeasedClients() const { return 0; }
+    size_t getMaxPoolSize() const { return maxPoolSize; }
+
     bool connect() {
         connected = true;
-        std::cout << "[MongoDB MOCK] Connected to " << connectionString << "/" << databaseName << std::endl;
+        BITEA_LOG_INFO("MongoDB MOCK", "Connected to %s/%s", connectionString.c_str(), databaseName.c_str());
         return true;
     }
 
     void disconnect() {
         connected = false;
-        std::cout << "[MongoDB MOCK] Disconnected" << std::endl;
+        BITEA_LOG_INFO("MongoDB MOCK", "Disconnected");
     }
 
     bool isConnected() const {
@@ -980,13 +1393,17 @@ public:
     }
 
     bool insertUser(const User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "insertUser");
+        ProfiledLock lock(mongoMutex, "insertUser");
         if (!connected) return false;
         users[user.getUsername()] = user;
-        std::cout << "[MongoDB MOCK] Inserted user: " << user.getUsername() << std::endl;
+        BITEA_LOG_DEBUG("MongoDB MOCK", "Inserted user: %s", user.getUsername().c_str());
         return true;
     }
 
     bool findUser(const std::string& username, User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "findUser");
+        ProfiledLock lock(mongoMutex, "findUser");
         if (!connected) return false;
         auto it = users.find(username);
         if (it != users.end()) {
@@ -997,35 +1414,49 @@ public:
     }
 
     bool updateUser(const User& user) {
+        BITEA_TIME_DB_CALL("mongodb", "updateUser");
+        ProfiledLock lock(mongoMutex, "updateUser");
         if (!connected) return false;
         auto it = users.find(user.getUsername());
         if (it != users.end()) {
             it->second = user;
-            std::cout << "[MongoDB MOCK] Updated user: " << user.getUsername() << std::endl;
+            BITEA_LOG_DEBUG("MongoDB MOCK", "Updated user: %s", user.getUsername().c_str());
             return true;
         }
         return false;
     }
 
     bool deleteUser(const std::string& username) {
+        BITEA_TIME_DB_CALL("mongodb", "deleteUser");
+        ProfiledLock lock(mongoMutex, "deleteUser");
         if (!connected) return false;
         auto it = users.find(username);
         if (it != users.end()) {
             users.erase(it);
-            std::cout << "[MongoDB MOCK] Deleted user: " << username << std::endl;
+            BITEA_LOG_DEBUG("MongoDB MOCK", "Deleted user: %s", username.c_str());
             return true;
         }
         return false;
     }
 
     bool insertPost(const Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "insertPost");
+        ProfiledLock lock(mongoMutex, "insertPost");
         if (!connected) return false;
+        auto existing = posts.find(post.getId());
+        if (existing != posts.end()) {
+            feedIndex.erase({static_cast<int64_t>(existing->second.getTimestamp()), existing->first});
+        }
         posts[post.getId()] = post;
-        std::cout << "[MongoDB MOCK] Inserted post: " << post.getId() << std::endl;
+        feedIndex.insert({static_cast<int64_t>(post.getTimestamp()), post.getId()});
+        recordChange(post.getId());
+        BITEA_LOG_DEBUG("MongoDB MOCK", "Inserted post: %s", post.getId().c_str());
         return true;
     }
 
     bool findPost(const std::string& postId, Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "findPost");
+        ProfiledLock lock(mongoMutex, "findPost");
         if (!connected) return false;
         auto it = posts.find(postId);
         if (it != posts.end()) {
@@ -1036,17 +1467,22 @@ public:
     }
 
     bool updatePost(const Post& post) {
+        BITEA_TIME_DB_CALL("mongodb", "updatePost");
+        ProfiledLock lock(mongoMutex, "updatePost");
         if (!connected) return false;
         auto it = posts.find(post.getId());
         if (it != posts.end()) {
             it->second = post;
-            std::cout << "[MongoDB MOCK] Updated post: " << post.getId() << std::endl;
+            recordChange(post.getId());
+            BITEA_LOG_DEBUG("MongoDB MOCK", "Updated post: %s", post.getId().c_str());
             return true;
         }
         return false;
     }
 
     std::vector<Post> getAllPosts() {
+        BITEA_TIME_DB_CALL("mongodb", "getAllPosts");
+        ProfiledLock lock(mongoMutex, "getAllPosts");
         std::vector<Post> result;
         if (!connected) return result;
         
@@ -1062,7 +1498,49 @@ public:
         return result;
     }
 
+    // Projection is a no-op here (posts are already in memory); the
+    // serializer still honors 'fields'
+    bool getPostsPage(const FeedCursor& after, size_t limit, FeedPage& page,
+                      [[maybe_unused]] uint32_t fields = PostFields::SUMMARY) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostsPage");
+        ProfiledLock lock(mongoMutex, "getPostsPage");
+        page.posts.clear();
+        page.nextCursor.clear();
+        if (!connected) return false;
+        
+        // Seek past the cursor, then read at most one page: O(log n + limit)
+        auto it = after.isStart() ? feedIndex.begin()
+                                  : feedIndex.upper_bound({after.timestamp, after.postId});
+        for (; it != feedIndex.end() && page.posts.size() < limit; ++it) {
+            page.posts.push_back(posts.at(it->second));
+        }
+        if (it != feedIndex.end() && !page.posts.empty()) {
+            page.nextCursor = FeedCursor::after(page.posts.back()).encode();
+        }
+        return true;
+    }
+
+    bool getPostChanges(uint64_t since, size_t limit, FeedChanges& changes,
+                        [[maybe_unused]] uint32_t fields = PostFields::SUMMARY) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostChanges");
+        ProfiledLock lock(mongoMutex, "getPostChanges");
+        changes.posts.clear();
+        changes.version = since;
+        changes.hasMore = false;
+        if (!connected) return false;
+        
+        auto it = changeLog.upper_bound(since);
+        for (; it != changeLog.end() && changes.posts.size() < limit; ++it) {
+            changes.posts.push_back(posts.at(it->second));
+            changes.version = it->first;
+        }
+        changes.hasMore = it != changeLog.end();
+        return true;
+    }
+
     std::vector<Post> getPostsByAuthor(const std::string& author) {
+        BITEA_TIME_DB_CALL("mongodb", "getPostsByAuthor");
+        ProfiledLock lock(mongoMutex, "getPostsByAuthor");
         std::vector<Post> result;
         if (!connected) return result;
         
@@ -1081,6 +1559,8 @@ public:
     }
 
     std::vector<User> getAllUsers() {
+        BITEA_TIME_DB_CALL("mongodb", "getAllUsers");
+        ProfiledLock lock(mongoMutex, "getAllUsers");
         std::vector<User> result;
         if (!connected) return result;
         
@@ -1092,10 +1572,14 @@ public:
     }
 
     int getUserCount() const {
+        BITEA_TIME_DB_CALL("mongodb", "getUserCount");
+        ProfiledLock lock(mongoMutex, "getUserCount");
         return users.size();
     }
 
     int getPostCount() const {
+        BITEA_TIME_DB_CALL("mongodb", "getPostCount");
+        ProfiledLock lock(mongoMutex, "getPostCount");
         return posts.size();
     }
 };
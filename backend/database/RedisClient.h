@@ -47,8 +47,11 @@
  * - TTL: Seconds until expiration (Redis handles automatically)
  * 
  * THREAD SAFETY:
- * All public methods use redisMutex to prevent race conditions when multiple
- * HTTP requests check sessions simultaneously.
+ * Real client: every public method checks a hiredis context out of a small
+ * pool for one command, so concurrent requests talk to Redis over separate
+ * sockets (up to poolSize; see setPoolSize()). redisPoolMutex only guards
+ * the pool bookkeeping and is never held during network I/O.
+ * Mock: one cacheMutex guards the in-memory maps.
  * 
  * CONDITIONAL COMPILATION:
  * - If HAS_REDIS is defined: Uses real Redis (hiredis library)
@@ -57,23 +60,399 @@
  */
 
 #include <string>
-#include <mutex>
-#include <iostream>
 #include <sstream>
 #include <ctime>
+#include <cstddef>   // size_t - pool bounds
+#include <cstdint>   // uint64_t - session touch counters, token expiry
+#include <cstdlib>   // std::atoll - revoked token scores
+#include <utility>   // std::pair - revoked token entries
+#include <vector>    // std::vector - revoked token entries
+#include <chrono>    // std::chrono - pool idle age/backoff, touch flush interval
 #include "../models/Session.h"  // Session model with sessionId, username, expiry
+#include "../utils/Logger.h"   // BITEA_LOG_* - asynchronous logging (never blocks under a lock)
+#include "../utils/Metrics.h"  // BITEA_TIME_DB_CALL - per-operation latency histograms, pool wait histogram
+#include "../utils/ProfiledMutex.h" // pool / mock mutex with wait/hold statistics
 
 #ifdef HAS_REDIS
 #include <hiredis/hiredis.h>
+#include <algorithm>                // std::min - backoff cap
+#include <atomic>                   // std::atomic - contexts in use, touch counters
+#include <condition_variable>       // std::condition_variable_any - wait for a free context
+#include <mutex>                    // std::unique_lock, std::adopt_lock
+#include <thread>                   // std::thread - session touch flusher
+#include <unordered_set>            // std::unordered_set - queued session touches
+#include <vector>                   // std::vector - idle contexts, touch batches
 
 class RedisClient {
+public:
+    /*
+     * Pool defaults: the storage executor runs at most 16 handlers at once,
+     * and Redis commands take well under a millisecond, so 8 sockets
+     * rarely make anyone wait
+     */
+    static constexpr size_t DEFAULT_POOL_SIZE = 8;
+
+    // Sliding session window: an active session's TTL is pushed back to
+    // this (Session's default lifetime)
+    static constexpr long long SESSION_LIFETIME_SECONDS = 86400;
+
+    // Lazy refresh defaults: reset the TTL once half the lifetime has
+    // passed (about two writes a day per active session), and send queued
+    // refreshes once a second
+    static constexpr double DEFAULT_REFRESH_FRACTION = 0.5;
+    static constexpr std::chrono::milliseconds DEFAULT_TOUCH_FLUSH_INTERVAL{1000};
+    static constexpr size_t TOUCH_BATCH_MAX = 512;  // Flush early at this many
+
+    // Sorted set of revoked signed-token IDs, scored by token expiry
+    static constexpr const char* REVOKED_TOKENS_KEY = "revoked-tokens";
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // Reconnect backoff after a failed dial: doubles from MIN up to MAX
+    static constexpr std::chrono::milliseconds RECONNECT_DELAY_MIN{100};
+    static constexpr std::chrono::milliseconds RECONNECT_DELAY_MAX{5000};
+    // Contexts idle for longer are PINGed before reuse (server timeouts,
+    // NAT and load-balancer idle resets close quiet sockets)
+    static constexpr std::chrono::seconds IDLE_CHECK_AFTER{30};
+    // Longest acquire() waits for a free context before the command fails
+    static constexpr std::chrono::milliseconds ACQUIRE_TIMEOUT{1500};
+
     // ========== CONNECTION PROPERTIES ==========
     std::string host;          // Redis server hostname (default: 127.0.0.1)
     int port;                  // Redis server port (default: 6379)
-    bool connected;            // Connection status flag
-    std::mutex redisMutex;     // Thread safety: Protects all Redis operations
-    redisContext* context;     // Hiredis connection context (low-level C library)
+    bool connected;            // Connection status flag (pool usable)
+    size_t poolSize;           // Contexts at most; acquire() waits beyond
+
+    // ========== CONTEXT POOL ==========
+    // Everything below is guarded by redisPoolMutex (contention stats:
+    // /debug/locks); mutable so const statistics queries can borrow a context
+    struct IdleContext {
+        redisContext* context;
+        Clock::time_point since;   // Returned to the pool at (health-check age)
+    };
+    mutable ProfiledMutex redisPoolMutex{"redis.pool"};
+    mutable std::condition_variable_any poolCv;     // Context released or dial finished
+    mutable std::vector<IdleContext> idle;          // LIFO: warmest socket reused first
+    mutable size_t openContexts = 0;                // Idle + checked out + being dialled
+    mutable std::atomic<int> leasedContexts{0};     // Checked out (for /metrics)
+    mutable Clock::duration reconnectDelay = RECONNECT_DELAY_MIN;  // Next backoff step
+    mutable Clock::time_point nextDialAt{};         // No new socket before this (backoff)
+
+    // ========== LAZY SESSION REFRESH ==========
+    // A session's TTL is only reset once less than refreshFraction of
+    // SESSION_LIFETIME_SECONDS remains; the EXPIREs are queued here
+    // (one per session, however many requests asked) and sent in batches
+    // by touchFlusher. pendingTouches and touchFlusherStopping are guarded
+    // by touchMutex.
+    double refreshFraction = DEFAULT_REFRESH_FRACTION;
+    std::chrono::milliseconds touchFlushInterval = DEFAULT_TOUCH_FLUSH_INTERVAL;
+    ProfiledMutex touchMutex{"redis.touches"};
+    std::condition_variable_any touchCv;            // Batch full or stopping
+    std::unordered_set<std::string> pendingTouches; // Session keys awaiting EXPIRE
+    bool touchFlusherStopping = false;
+    std::thread touchFlusher;
+    std::atomic<uint64_t> touchesSkipped{0};    // TTL still above the threshold
+    std::atomic<uint64_t> touchesQueued{0};     // First request to ask for a session
+    std::atomic<uint64_t> touchesCoalesced{0};  // Already queued by another request
+    std::atomic<uint64_t> touchesWritten{0};    // EXPIREs acknowledged by Redis
+    std::atomic<uint64_t> touchesFailed{0};     // Dropped or failed in a batch
+
+    /*
+     * HELPER CLASS: Lease - one pooled context, checked out for one command
+     * 
+     * Returns the context to the pool when it goes out of scope. An empty
+     * lease (operator bool false) means no context could be had: Redis is
+     * down and backing off, or the pool stayed full for ACQUIRE_TIMEOUT.
+     * A redisContext is not thread-safe: a lease must stay on the thread
+     * that acquired it.
+     */
+    class Lease {
+    public:
+        Lease(const RedisClient& owner, redisContext* context) : owner(owner), context(context) {}
+        ~Lease() {
+            if (context) owner.release(context);
+        }
+        Lease(Lease&& other) noexcept : owner(other.owner), context(other.context) {
+            other.context = nullptr;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        explicit operator bool() const { return context != nullptr; }
+        redisContext* get() const { return context; }
+
+    private:
+        const RedisClient& owner;
+        redisContext* context;
+    };
+
+    /*
+     * HELPER METHOD: Open and verify one connection
+     * 
+     * Connects with a 1.5 second timeout, applies the same timeout to every
+     * later command (a hung server fails the command instead of pinning a
+     * storage thread) and checks the socket with PING.
+     * 
+     * RETURNS: the new context, or nullptr (error logged)
+     */
+    redisContext* dial() const {
+        struct timeval timeout = { 1, 500000 }; // 1.5 seconds
+        redisContext* context = redisConnectWithTimeout(host.c_str(), port, timeout);
+        
+        if (context == nullptr || context->err) {
+            if (context) {
+                BITEA_LOG_ERROR("Redis", "Connection error: %s", context->errstr);
+                redisFree(context);
+            } else {
+                BITEA_LOG_ERROR("Redis", "Connection error: can't allocate redis context");
+            }
+            return nullptr;
+        }
+        redisSetTimeout(context, timeout);
+        
+        if (!ping(context)) {
+            BITEA_LOG_ERROR("Redis", "PING failed on new connection to %s:%d", host.c_str(), port);
+            redisFree(context);
+            return nullptr;
+        }
+        return context;
+    }
+
+    /*
+     * HELPER METHOD: Health check - true if the server answers PONG
+     */
+    bool ping(redisContext* context) const {
+        redisReply* reply = (redisReply*)redisCommand(context, "PING");
+        std::string pong = getReplyString(reply);
+        if (reply) freeReplyObject(reply);
+        return pong == "PONG";
+    }
+
+    /*
+     * HELPER METHOD: Check out a context for one command
+     * 
+     * 1. Reuse the most recently returned idle context (PING it first if it
+     *    sat idle longer than IDLE_CHECK_AFTER; drop it if that fails)
+     * 2. Otherwise dial a new one if below poolSize and not backing off.
+     *    A failed dial pushes the next attempt out by reconnectDelay, which
+     *    doubles up to RECONNECT_DELAY_MAX and resets on success, so a Redis
+     *    outage costs one connect timeout per backoff step instead of one
+     *    per request
+     * 3. Otherwise wait for a release, up to ACQUIRE_TIMEOUT
+     * 
+     * Fails fast (empty lease) while no connection is open and the backoff
+     * has not elapsed. The wait is observed into the
+     * bitea_redis_pool_wait_seconds histogram and shows up as a
+     * "redis.acquire" span in the request trace.
+     */
+    Lease acquire() const {
+        static const int waitSeries = [] {
+            Metrics::instance().describe("bitea_redis_pool_wait_seconds", MetricType::HISTOGRAM,
+                                         "Time spent waiting for a pooled Redis connection");
+            return Metrics::instance().series("bitea_redis_pool_wait_seconds", "");
+        }();
+        ScopedLatency wait(waitSeries);
+        TraceScope phase("redis.acquire");
+        
+        const Clock::time_point deadline = Clock::now() + ACQUIRE_TIMEOUT;
+        redisPoolMutex.lock("acquire");
+        std::unique_lock<ProfiledMutex> lock(redisPoolMutex, std::adopt_lock);
+        while (true) {
+            if (!idle.empty()) {
+                IdleContext entry = idle.back();
+                idle.pop_back();
+                if (Clock::now() - entry.since < IDLE_CHECK_AFTER) return lease(entry.context);
+                
+                lock.unlock();
+                bool healthy = ping(entry.context);
+                if (!healthy) redisFree(entry.context);
+                lock.lock();
+                if (healthy) return lease(entry.context);
+                BITEA_LOG_WARN("Redis", "Dropped idle connection that failed its health check");
+                openContexts--;
+                continue;
+            }
+            
+            const Clock::time_point now = Clock::now();
+            if (openContexts < poolSize && now >= nextDialAt) {
+                openContexts++;
+                lock.unlock();
+                redisContext* context = dial();
+                lock.lock();
+                if (context) {
+                    reconnectDelay = RECONNECT_DELAY_MIN;
+                    return lease(context);
+                }
+                openContexts--;
+                nextDialAt = Clock::now() + reconnectDelay;
+                reconnectDelay = std::min<Clock::duration>(reconnectDelay * 2, RECONNECT_DELAY_MAX);
+                poolCv.notify_all();   // Waiters re-check the backoff
+                return Lease(*this, nullptr);
+            }
+            
+            if (openContexts == 0 || now >= deadline) return Lease(*this, nullptr);
+            Clock::time_point wakeAt = deadline;
+            if (openContexts < poolSize && nextDialAt < wakeAt) wakeAt = nextDialAt;
+            poolCv.wait_until(lock, wakeAt);
+        }
+    }
+
+    /* Wraps a context just taken from the pool (redisPoolMutex held) */
+    Lease lease(redisContext* context) const {
+        leasedContexts.fetch_add(1, std::memory_order_relaxed);
+        return Lease(*this, context);
+    }
+
+    /*
+     * HELPER METHOD: Return a context to the pool (called by ~Lease)
+     * 
+     * A context whose socket failed (hiredis sets context->err on I/O and
+     * protocol errors and never clears it) is freed instead; the next
+     * acquire() dials a replacement.
+     */
+    void release(redisContext* context) const {
+        leasedContexts.fetch_sub(1, std::memory_order_relaxed);
+        bool broken = context->err != 0;
+        if (broken) {
+            BITEA_LOG_WARN("Redis", "Dropping broken connection: %s", context->errstr);
+            redisFree(context);
+        }
+        {
+            ProfiledLock lock(redisPoolMutex, "release");
+            if (broken) {
+                openContexts--;
+            } else {
+                idle.push_back({context, Clock::now()});
+            }
+        }
+        poolCv.notify_one();
+    }
+
+    /*
+     * HELPER METHOD: Read a key and its remaining TTL in one round trip
+     * 
+     * GET and TTL pipelined: both commands are sent together and both
+     * replies read together, and neither writes. A failed pipeline leaves
+     * context->err set, so release() drops the connection instead of
+     * reusing a socket with an unread reply on it.
+     * 
+     * RETURNS: true and value/ttlSeconds filled if the key exists
+     * (ttlSeconds -1 = no expiry); false if it does not, or on error (logged)
+     */
+    bool readWithTtl(redisContext* context, const std::string& key, std::string& value,
+                     long long& ttlSeconds) const {
+        redisAppendCommand(context, "GET %s", key.c_str());
+        redisAppendCommand(context, "TTL %s", key.c_str());
+        redisReply* getReply = nullptr;
+        redisReply* ttlReply = nullptr;
+        bool ok = redisGetReply(context, (void**)&getReply) == REDIS_OK &&
+                  redisGetReply(context, (void**)&ttlReply) == REDIS_OK;
+        bool found = ok && getReply->type == REDIS_REPLY_STRING;
+        if (found) {
+            value.assign(getReply->str, getReply->len);
+            ttlSeconds = ttlReply->type == REDIS_REPLY_INTEGER ? ttlReply->integer : -1;
+        }
+        if (getReply) freeReplyObject(getReply);
+        if (ttlReply) freeReplyObject(ttlReply);
+        if (!ok) BITEA_LOG_ERROR("Redis", "Pipelined GET + TTL failed");
+        return found;
+    }
+
+    /*
+     * HELPER METHOD: Queue a sliding-expiry refresh for the flusher
+     * 
+     * Concurrent requests on the same session collapse into one queued
+     * EXPIRE. Wakes the flusher early once a full batch is waiting.
+     */
+    void queueTouch(const std::string& key) {
+        ProfiledLock lock(touchMutex, "queueTouch");
+        if (!pendingTouches.insert(key).second) {
+            touchesCoalesced.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        touchesQueued.fetch_add(1, std::memory_order_relaxed);
+        if (pendingTouches.size() >= TOUCH_BATCH_MAX) touchCv.notify_one();
+    }
+
+    /*
+     * HELPER METHOD: Background flusher - drains pendingTouches every
+     * touchFlushInterval (sooner when TOUCH_BATCH_MAX are waiting), and
+     * once more when stopped
+     */
+    void touchFlushLoop() {
+        touchMutex.lock("touchFlushLoop");
+        std::unique_lock<ProfiledMutex> lock(touchMutex, std::adopt_lock);
+        bool stopping = false;
+        while (!stopping) {
+            touchCv.wait_for(lock, touchFlushInterval, [this] {
+                return touchFlusherStopping || pendingTouches.size() >= TOUCH_BATCH_MAX;
+            });
+            stopping = touchFlusherStopping;
+            if (pendingTouches.empty()) continue;
+            
+            std::vector<std::string> batch(pendingTouches.begin(), pendingTouches.end());
+            pendingTouches.clear();
+            lock.unlock();
+            flushTouches(batch);
+            lock.lock();
+        }
+    }
+
+    /*
+     * HELPER METHOD: Send one batch of EXPIREs as a single pipeline
+     * 
+     * Touches are best effort: if no connection is available the batch is
+     * dropped (logged). Each session still has most of its TTL left, so
+     * its next request simply queues the touch again.
+     */
+    void flushTouches(const std::vector<std::string>& keys) {
+        auto connection = acquire();
+        if (!connection) {
+            touchesFailed.fetch_add(keys.size(), std::memory_order_relaxed);
+            BITEA_LOG_WARN("Redis", "Dropped %zu session TTL refreshes: no connection", keys.size());
+            return;
+        }
+        
+        for (const std::string& key : keys) {
+            redisAppendCommand(connection.get(), "EXPIRE %s %lld", key.c_str(), SESSION_LIFETIME_SECONDS);
+        }
+        size_t written = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+            redisReply* reply = nullptr;
+            if (redisGetReply(connection.get(), (void**)&reply) != REDIS_OK) break;
+            if (reply->type == REDIS_REPLY_INTEGER) written++;
+            freeReplyObject(reply);
+        }
+        touchesWritten.fetch_add(written, std::memory_order_relaxed);
+        if (written < keys.size()) {
+            touchesFailed.fetch_add(keys.size() - written, std::memory_order_relaxed);
+            BITEA_LOG_WARN("Redis", "Session TTL refresh batch: %zu of %zu failed",
+                           keys.size() - written, keys.size());
+        } else {
+            BITEA_LOG_DEBUG("Redis", "Refreshed %zu session TTLs in one pipeline", written);
+        }
+    }
+
+    /* Starts / stops (after a final flush) the touch flusher thread */
+    void startTouchFlusher() {
+        {
+            ProfiledLock lock(touchMutex, "startTouchFlusher");
+            touchFlusherStopping = false;
+        }
+        touchFlusher = std::thread(&RedisClient::touchFlushLoop, this);
+    }
+
+    void stopTouchFlusher() {
+        if (!touchFlusher.joinable()) return;
+        {
+            ProfiledLock lock(touchMutex, "stopTouchFlusher");
+            touchFlusherStopping = true;
+        }
+        touchCv.notify_one();
+        touchFlusher.join();
+    }
 
     /*
      * HELPER METHOD: Get Redis reply as string
@@ -81,11 +460,11 @@ private:
      * PURPOSE: Safely extract string from Redis reply structure
      * 
      * INTERACTION WITH BITEA:
-     * - Called by: connect() to parse PING response
+     * - Called by: ping() to parse PING response
      * - Uses: Hiredis library reply structures
      * - Handles: NULL replies and type checking
      */
-    std::string getReplyString(redisReply* reply) {
+    static std::string getReplyString(redisReply* reply) {
         if (reply && (reply->type == REDIS_REPLY_STRING || reply->type == REDIS_REPLY_STATUS)) {
             return std::string(reply->str, reply->len);
         }
@@ -98,7 +477,7 @@ private:
      * PURPOSE: Convert Session object to storable string format
      * 
      * INTERACTION WITH BITEA:
-     * - Called by: createSession(), refreshSession()
+     * - Called by: createSession()
      * - Format: "sessionId|username|createdAt|expiresAt"
      * - Example: "abc123|alice|1729600000|1729686400"
      * 
@@ -161,7 +540,7 @@ public:
      * CALLED BY: main.cpp during application startup
      */
     RedisClient(const std::string& host = "127.0.0.1", int port = 6379)
-        : host(host), port(port), connected(false), context(nullptr) {
+        : host(host), port(port), connected(false), poolSize(DEFAULT_POOL_SIZE) {
     }
 
     /*
@@ -176,6 +555,48 @@ public:
         disconnect();
     }
 
+    RedisClient(const RedisClient&) = delete;
+    RedisClient& operator=(const RedisClient&) = delete;
+
+    /*
+     * METHOD: setPoolSize()
+     * 
+     * PURPOSE: Configure how many connections may be open (call before connect())
+     * Further concurrent commands wait (bitea_redis_pool_wait_seconds).
+     */
+    void setPoolSize(size_t size) {
+        poolSize = size > 0 ? size : 1;
+    }
+
+    /* Pool occupancy for /metrics: contexts checked out, idle, configured maximum */
+    int getLeasedContexts() const { return leasedContexts.load(std::memory_order_relaxed); }
+    size_t getIdleContexts() const {
+        ProfiledLock lock(redisPoolMutex, "getIdleContexts");
+        return idle.size();
+    }
+    size_t getPoolSize() const { return poolSize; }
+
+    /*
+     * METHOD: setSessionRefresh()
+     * 
+     * PURPOSE: Configure lazy session refresh (call before connect())
+     * - fraction: reset a session's TTL only when less than this fraction
+     *   of SESSION_LIFETIME_SECONDS remains (0 = never slide, 1 = on every
+     *   request, still batched)
+     * - flushInterval: how often queued refreshes are sent
+     */
+    void setSessionRefresh(double fraction, std::chrono::milliseconds flushInterval) {
+        refreshFraction = fraction < 0 ? 0 : (fraction > 1 ? 1 : fraction);
+        touchFlushInterval = flushInterval.count() > 0 ? flushInterval : std::chrono::milliseconds(1);
+    }
+
+    /* Session refresh counters for /metrics (see the touches* members) */
+    uint64_t getTouchesSkipped() const { return touchesSkipped.load(std::memory_order_relaxed); }
+    uint64_t getTouchesQueued() const { return touchesQueued.load(std::memory_order_relaxed); }
+    uint64_t getTouchesCoalesced() const { return touchesCoalesced.load(std::memory_order_relaxed); }
+    uint64_t getTouchesWritten() const { return touchesWritten.load(std::memory_order_relaxed); }
+    uint64_t getTouchesFailed() const { return touchesFailed.load(std::memory_order_relaxed); }
+
     /*
      * METHOD: connect()
      * 
@@ -187,9 +608,12 @@ public:
      * - After this: Session management becomes available
      * 
      * PROCESS:
-     * 1. Creates Redis connection with 1.5 second timeout
+     * 1. Opens the first pooled connection with 1.5 second timeout
      * 2. Sends PING command to verify Redis is responding
      * 3. Expects PONG response
+     * Further connections are opened on demand, up to poolSize; if Redis
+     * restarts later, broken connections are dropped and redialled with
+     * backoff instead of failing this client for good.
      * 
      * STARTUP DEPENDENCY:
      * Redis must be running: `redis-server` or `brew services start redis`
@@ -199,67 +623,47 @@ public:
      * ERROR HANDLING: Catches connection failures and logs errors
      */
     bool connect() {
-        std::lock_guard<std::mutex> lock(redisMutex);
-        
-        struct timeval timeout = { 1, 500000 }; // 1.5 seconds
-        context = redisConnectWithTimeout(host.c_str(), port, timeout);
-        
-        if (context == nullptr || context->err) {
-            if (context) {
-                std::cerr << "[Redis] Connection error: " << context->errstr << std::endl;
-                redisFree(context);
-                context = nullptr;
-            } else {
-                std::cerr << "[Redis] Connection error: can't allocate redis context" << std::endl;
-            }
-            connected = false;
-            return false;
-        }
-        
-        // Test connection with PING
-        redisReply* reply = (redisReply*)redisCommand(context, "PING");
-        if (reply == nullptr) {
-            std::cerr << "[Redis] PING failed" << std::endl;
-            redisFree(context);
-            context = nullptr;
+        redisContext* context = dial();
+        if (context == nullptr) {
             connected = false;
             return false;
         }
         
-        std::string pong = getReplyString(reply);
-        freeReplyObject(reply);
-        
-        if (pong != "PONG") {
-            std::cerr << "[Redis] Unexpected PING response: " << pong << std::endl;
-            redisFree(context);
-            context = nullptr;
-            connected = false;
-            return false;
+        {
+            ProfiledLock lock(redisPoolMutex, "connect");
+            openContexts++;
+            idle.push_back({context, Clock::now()});
         }
         
         connected = true;
-        std::cout << "[Redis] Connected to " << host << ":" << port << std::endl;
+        startTouchFlusher();
+        BITEA_LOG_INFO("Redis", "Connected to %s:%d (pool up to %zu connections)", host.c_str(), port, poolSize);
         return true;
     }
 
     /*
      * METHOD: disconnect()
      * 
-     * PURPOSE: Closes Redis connection and cleans up resources
+     * PURPOSE: Closes Redis connections and cleans up resources
      * 
      * CALLED BY: Destructor during application shutdown (Ctrl+C)
-     * CLEANUP: Frees hiredis context to prevent memory leaks
+     * CLEANUP: Flushes queued session refreshes, then frees idle hiredis
+     * contexts to prevent memory leaks; must not race with commands still
+     * in flight
      */
     void disconnect() {
-        std::lock_guard<std::mutex> lock(redisMutex);
+        stopTouchFlusher();  // Sends the last queued refreshes first
         
-        if (context) {
-            redisFree(context);
-            context = nullptr;
+        ProfiledLock lock(redisPoolMutex, "disconnect");
+        
+        for (IdleContext& entry : idle) {
+            redisFree(entry.context);
         }
+        openContexts -= idle.size();
+        idle.clear();
         
         connected = false;
-        std::cout << "[Redis] Disconnected" << std::endl;
+        BITEA_LOG_INFO("Redis", "Disconnected");
     }
 
     /*
@@ -291,14 +695,16 @@ public:
      * RETURNS: true if stored successfully, false otherwise
      */
     bool set(const std::string& key, const std::string& value) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "set");
+        if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(redisMutex);
+        auto connection = acquire();
+        if (!connection) return false;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "SET %s %s", 
-                                                       key.c_str(), value.c_str());
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "SET %s %s", 
+                                                                key.c_str(), value.c_str());
         if (reply == nullptr) {
-            std::cerr << "[Redis] SET command failed" << std::endl;
+            BITEA_LOG_ERROR("Redis", "SET command failed");
             return false;
         }
         
@@ -323,13 +729,15 @@ public:
      * RETURNS: true if key found, false if not found or error
      */
     bool get(const std::string& key, std::string& value) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "get");
+        if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(redisMutex);
+        auto connection = acquire();
+        if (!connection) return false;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "GET %s", key.c_str());
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "GET %s", key.c_str());
         if (reply == nullptr) {
-            std::cerr << "[Redis] GET command failed" << std::endl;
+            BITEA_LOG_ERROR("Redis", "GET command failed");
             return false;
         }
         
@@ -354,13 +762,15 @@ public:
      * RETURNS: true if key existed and was deleted, false otherwise
      */
     bool del(const std::string& key) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "del");
+        if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(redisMutex);
+        auto connection = acquire();
+        if (!connection) return false;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "DEL %s", key.c_str());
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "DEL %s", key.c_str());
         if (reply == nullptr) {
-            std::cerr << "[Redis] DEL command failed" << std::endl;
+            BITEA_LOG_ERROR("Redis", "DEL command failed");
             return false;
         }
         
@@ -380,13 +790,15 @@ public:
      * RETURNS: true if key exists, false otherwise
      */
     bool exists(const std::string& key) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "exists");
+        if (!connected) return false;
         
-        std::lock_guard<std::mutex> lock(redisMutex);
+        auto connection = acquire();
+        if (!connection) return false;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "EXISTS %s", key.c_str());
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "EXISTS %s", key.c_str());
         if (reply == nullptr) {
-            std::cerr << "[Redis] EXISTS command failed" << std::endl;
+            BITEA_LOG_ERROR("Redis", "EXISTS command failed");
             return false;
         }
         
@@ -429,27 +841,29 @@ public:
      * RETURNS: true if session created, false if expired or error
      */
     bool createSession(const Session& session) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "createSession");
+        if (!connected) return false;
         
         std::string key = "session:" + session.getSessionId();
         std::string value = serializeSession(session);
         
-        std::lock_guard<std::mutex> lock(redisMutex);
-        
         // Calculate TTL (time to live) in seconds
         time_t now = std::time(nullptr);
         time_t expiresAt = session.getExpiresAt();
         int64_t ttl = expiresAt - now;
         
         if (ttl <= 0) {
-            std::cerr << "[Redis] Session already expired" << std::endl;
+            BITEA_LOG_WARN("Redis", "Session already expired");
             return false;
         }
         
-        redisReply* reply = (redisReply*)redisCommand(context, "SETEX %s %lld %s",
-                                                       key.c_str(), ttl, value.c_str());
+        auto connection = acquire();
+        if (!connection) return false;
+        
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "SETEX %s %lld %s",
+                                                                key.c_str(), ttl, value.c_str());
         if (reply == nullptr) {
-            std::cerr << "[Redis] SETEX command failed" << std::endl;
+            BITEA_LOG_ERROR("Redis", "SETEX command failed");
             return false;
         }
         
@@ -458,8 +872,8 @@ public:
         freeReplyObject(reply);
         
         if (success) {
-            std::cout << "[Redis] Created session: " << session.getSessionId() 
-                      << " for user: " << session.getUsername() << std::endl;
+            BITEA_LOG_DEBUG("Redis", "Created session: %s for user: %s",
+                        session.getSessionId().c_str(), session.getUsername().c_str());
         }
         
         return success;
@@ -483,9 +897,11 @@ public:
      * 7. OR: [HttpServer] Returns 401 Unauthorized if invalid
      * 
      * VALIDATION CHECKS:
-     * 1. Does key exist in Redis? (If not, session expired or never existed)
-     * 2. Has session expired? (Check timestamp)
-     * 3. If expired: Delete from Redis
+     * Does key exist in Redis? (If not, session expired or never existed)
+     * The key's TTL is the session's expiry: refreshSession() and
+     * getAndRefreshSession() slide it without rewriting the value, so
+     * the expiresAt stored in the value is the original login deadline
+     * and is not checked.
      * 
      * EXAMPLE:
      * User creates post → Frontend sends "session:abc123" →
@@ -499,20 +915,14 @@ public:
      * RETURNS: true if session valid, false if expired/not found/error
      */
     bool getSession(const std::string& sessionId, Session& session) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "getSession");
+        if (!connected) return false;
         
         std::string key = "session:" + sessionId;
         std::string value;
         
         if (get(key, value)) {
             session = deserializeSession(value);
-            
-            // Check if session is expired
-            if (session.isExpired()) {
-                del(key);
-                return false;
-            }
-            
             return true;
         }
         
@@ -544,12 +954,13 @@ public:
      * RETURNS: true if session existed and deleted, false otherwise
      */
     bool deleteSession(const std::string& sessionId) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "deleteSession");
+        if (!connected) return false;
         
         std::string key = "session:" + sessionId;
         
         if (del(key)) {
-            std::cout << "[Redis] Deleted session: " << sessionId << std::endl;
+            BITEA_LOG_DEBUG("Redis", "Deleted session: %s", sessionId.c_str());
             return true;
         }
         
@@ -562,7 +973,8 @@ public:
      * PURPOSE: Extend session expiration time (keep user logged in)
      * 
      * INTERACTION WITH BITEA:
-     * - Called by: HttpServer on authenticated requests (optional feature)
+     * - Called by: anything that extends a session without reading it
+     *   (validateSession() uses getAndRefreshSession() instead)
      * - Prevents: Session expiring while user is actively using the app
      * 
      * EXAMPLE USE CASE:
@@ -572,54 +984,161 @@ public:
      * User doesn't get logged out while actively using site
      * 
      * IMPLEMENTATION:
-     * 1. Retrieves current session
-     * 2. Calls session.refresh() to update expiry timestamp
-     * 3. Stores back in Redis with new TTL
-     * 
-     * NOTE: Currently may not be actively used in Bitea, but available
+     * One EXPIRE resets the key's TTL to SESSION_LIFETIME_SECONDS. The stored
+     * value (and its original expiresAt) is left untouched: the Redis TTL
+     * is what expires a session.
      * 
      * RETURNS: true if refreshed, false if session not found/error
      */
     bool refreshSession(const std::string& sessionId) {
-        if (!connected || !context) return false;
+        BITEA_TIME_DB_CALL("redis", "refreshSession");
+        if (!connected) return false;
         
-        Session session;
-        if (getSession(sessionId, session)) {
-            session.refresh();
-            
-            // Update the session in Redis
-            std::string key = "session:" + sessionId;
-            std::string value = serializeSession(session);
-            
-            std::lock_guard<std::mutex> lock(redisMutex);
-            
-            // Calculate new TTL
-            time_t now = std::time(nullptr);
-            time_t expiresAt = session.getExpiresAt();
-            int64_t ttl = expiresAt - now;
-            
-            if (ttl <= 0) {
-                return false;
-            }
-            
-            redisReply* reply = (redisReply*)redisCommand(context, "SETEX %s %lld %s",
-                                                           key.c_str(), ttl, value.c_str());
-            if (reply == nullptr) {
-                return false;
-            }
-            
-            bool success = (reply->type == REDIS_REPLY_STATUS && 
-                           std::string(reply->str) == "OK");
-            freeReplyObject(reply);
-            
-            if (success) {
-                std::cout << "[Redis] Refreshed session: " << sessionId << std::endl;
-            }
-            
-            return success;
+        std::string key = "session:" + sessionId;
+        
+        auto connection = acquire();
+        if (!connection) return false;
+        
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "EXPIRE %s %lld",
+                                                                key.c_str(), SESSION_LIFETIME_SECONDS);
+        if (reply == nullptr) {
+            BITEA_LOG_ERROR("Redis", "EXPIRE command failed");
+            return false;
         }
         
-        return false;
+        bool success = (reply->type == REDIS_REPLY_INTEGER && reply->integer == 1);
+        freeReplyObject(reply);
+        
+        if (success) {
+            BITEA_LOG_DEBUG("Redis", "Refreshed session: %s", sessionId.c_str());
+        }
+        
+        return success;
+    }
+
+    /*
+     * METHOD: getAndRefreshSession()
+     * 
+     * PURPOSE: Validate a session token and keep its sliding expiry alive,
+     * in ONE read-only round trip
+     * 
+     * INTERACTION WITH BITEA:
+     * - Called by: validateSession() in main.cpp on every authenticated request
+     * - Replaces: getSession() + refreshSession(), which cost three round
+     *   trips (GET, GET, SETEX) and rewrote the value each time
+     * 
+     * REDIS COMMANDS:
+     * 1. GET session:<id> and TTL session:<id>, pipelined (one round trip)
+     * 2. Only if less than refreshFraction of the lifetime remains: queue
+     *    the key for the background flusher, which sends every queued
+     *    EXPIRE in one pipeline per flush interval. Concurrent requests on
+     *    the same session queue a single EXPIRE.
+     * An active user therefore costs about one write per
+     * (1 - refreshFraction) x lifetime instead of one per request. The
+     * stored value is never rewritten; only the key's TTL moves.
+     * 
+     * RETURNS: true if session valid, false if expired/not found/error
+     */
+    bool getAndRefreshSession(const std::string& sessionId, Session& session) {
+        BITEA_TIME_DB_CALL("redis", "getAndRefreshSession");
+        if (!connected) return false;
+        
+        std::string key = "session:" + sessionId;
+        std::string value;
+        long long ttlSeconds = -1;
+        {
+            auto connection = acquire();
+            if (!connection) return false;
+            if (!readWithTtl(connection.get(), key, value, ttlSeconds)) return false;
+        }
+        
+        // No expiry check on the stored value: its expiresAt is the one from
+        // login and never moves. The key's TTL decides, and the key exists.
+        session = deserializeSession(value);
+        
+        if (ttlSeconds >= 0 && ttlSeconds < refreshFraction * SESSION_LIFETIME_SECONDS) {
+            queueTouch(key);
+        } else {
+            touchesSkipped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // ============================================================================
+    // PUBLIC API - Signed Token Revocation (utils/SessionToken.h)
+    // ============================================================================
+    
+    /*
+     * METHOD: revokeToken()
+     * 
+     * PURPOSE: Share a signed token's revocation with every process
+     * 
+     * REDIS COMMAND: ZADD revoked-tokens <expiresAt> <tokenId>
+     * Scored by expiry so loadRevokedTokens() can drop the entries whose
+     * tokens would be rejected anyway.
+     * 
+     * RETURNS: true if stored, false on error
+     */
+    bool revokeToken(const std::string& tokenId, int64_t expiresAt) {
+        BITEA_TIME_DB_CALL("redis", "revokeToken");
+        if (!connected) return false;
+        
+        auto connection = acquire();
+        if (!connection) return false;
+        
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "ZADD %s %lld %s", REVOKED_TOKENS_KEY,
+                                                      static_cast<long long>(expiresAt), tokenId.c_str());
+        if (reply == nullptr) {
+            BITEA_LOG_ERROR("Redis", "ZADD command failed");
+            return false;
+        }
+        
+        bool success = reply->type == REDIS_REPLY_INTEGER;
+        freeReplyObject(reply);
+        return success;
+    }
+
+    /*
+     * METHOD: loadRevokedTokens()
+     * 
+     * PURPOSE: Fetch the shared revocation set (RevokedTokens sync thread)
+     * 
+     * REDIS COMMANDS (pipelined, one round trip):
+     * - ZREMRANGEBYSCORE revoked-tokens -inf <now>   (prune expired tokens)
+     * - ZRANGEBYSCORE revoked-tokens (<now> +inf WITHSCORES
+     * 
+     * RETURNS: true and out filled with (tokenId, expiresAt); false on error
+     */
+    bool loadRevokedTokens(int64_t now, std::vector<std::pair<std::string, int64_t>>& out) {
+        BITEA_TIME_DB_CALL("redis", "loadRevokedTokens");
+        if (!connected) return false;
+        
+        auto connection = acquire();
+        if (!connection) return false;
+        
+        redisContext* context = connection.get();
+        redisAppendCommand(context, "ZREMRANGEBYSCORE %s -inf %lld", REVOKED_TOKENS_KEY, static_cast<long long>(now));
+        redisAppendCommand(context, "ZRANGEBYSCORE %s (%lld +inf WITHSCORES", REVOKED_TOKENS_KEY,
+                           static_cast<long long>(now));
+        redisReply* pruneReply = nullptr;
+        redisReply* rangeReply = nullptr;
+        bool ok = redisGetReply(context, (void**)&pruneReply) == REDIS_OK &&
+                  redisGetReply(context, (void**)&rangeReply) == REDIS_OK &&
+                  rangeReply->type == REDIS_REPLY_ARRAY;
+        if (ok) {
+            out.clear();
+            out.reserve(rangeReply->elements / 2);
+            for (size_t i = 0; i + 1 < rangeReply->elements; i += 2) {
+                redisReply* member = rangeReply->element[i];
+                redisReply* score = rangeReply->element[i + 1];
+                if (member->type != REDIS_REPLY_STRING || score->type != REDIS_REPLY_STRING) continue;
+                out.emplace_back(std::string(member->str, member->len), std::atoll(score->str));
+            }
+        }
+        if (pruneReply) freeReplyObject(pruneReply);
+        if (rangeReply) freeReplyObject(rangeReply);
+        if (!ok) BITEA_LOG_ERROR("Redis", "Loading revoked tokens failed");
+        return ok;
     }
 
     /*
@@ -645,7 +1164,7 @@ public:
     void cleanupExpiredSessions() {
         // Redis automatically handles expiration via TTL
         // This method is kept for API compatibility but does nothing
-        std::cout << "[Redis] Sessions auto-expire via TTL" << std::endl;
+        BITEA_LOG_DEBUG("Redis", "Sessions auto-expire via TTL");
     }
 
     /*
@@ -669,11 +1188,12 @@ public:
      * RETURNS: Number of active sessions, or 0 if error/disconnected
      */
     int getSessionCount() const {
-        if (!connected || !context) return 0;
+        if (!connected) return 0;
         
-        std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(redisMutex));
+        auto connection = acquire();
+        if (!connection) return 0;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "KEYS session:*");
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "KEYS session:*");
         if (reply == nullptr || reply->type != REDIS_REPLY_ARRAY) {
             if (reply) freeReplyObject(reply);
             return 0;
@@ -704,11 +1224,12 @@ public:
      * RETURNS: Total number of keys, or 0 if error/disconnected
      */
     int getCacheSize() const {
-        if (!connected || !context) return 0;
+        if (!connected) return 0;
         
-        std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(redisMutex));
+        auto connection = acquire();
+        if (!connection) return 0;
         
-        redisReply* reply = (redisReply*)redisCommand(context, "DBSIZE");
+        redisReply* reply = (redisReply*)redisCommand(connection.get(), "DBSIZE");
         if (reply == nullptr || reply->type != REDIS_REPLY_INTEGER) {
             if (reply) freeReplyObject(reply);
             return 0;
@@ -752,33 +1273,70 @@ public:
  * ============================================================================
  */
 #include <map>
+#include <atomic>   // std::atomic - session touch counters
 
 class RedisClient {
 private:
     std::string host;
     int port;
     bool connected;
-    std::mutex cacheMutex;  // Thread safety for concurrent requests
+    mutable ProfiledMutex cacheMutex{"redis"};  // Thread safety for concurrent requests (stats: /debug/locks)
     
     // In-memory storage (mock Redis)
     // Separate maps for generic cache and sessions for better organization
     std::map<std::string, std::string> cache;    // Generic key-value storage
-    std::map<std::string, Session> sessions;     // Session storage (sessionId → Session)
+    // Session storage (sessionId → Session). keyExpiresAt plays the Redis
+    // key TTL: refreshes move it and never touch the stored Session, so the
+    // mock expires sessions exactly like the real client
+    struct StoredSession {
+        Session session;
+        time_t keyExpiresAt;
+    };
+    std::map<std::string, StoredSession> sessions;
+    std::map<std::string, int64_t> revokedTokens; // Signed token ID → expiry (shared revocation set)
+    size_t poolSize = DEFAULT_POOL_SIZE;
+    double refreshFraction = DEFAULT_REFRESH_FRACTION;
+    std::atomic<uint64_t> touchesSkipped{0};
+    std::atomic<uint64_t> touchesQueued{0};
+    std::atomic<uint64_t> touchesWritten{0};
 
 public:
     RedisClient(const std::string& host = "127.0.0.1", int port = 6379)
         : host(host), port(port), connected(false) {
     }
 
+    // Same configuration surface as the real client; the mock has no
+    // connections, so the pool size is only reported
+    static constexpr size_t DEFAULT_POOL_SIZE = 8;
+    static constexpr long long SESSION_LIFETIME_SECONDS = 86400;
+    static constexpr double DEFAULT_REFRESH_FRACTION = 0.5;
+    static constexpr std::chrono::milliseconds DEFAULT_TOUCH_FLUSH_INTERVAL{1000};
+    void setPoolSize(size_t size) { poolSize = size > 0 ? size : 1; }
+    int getLeasedContexts() const { return 0; }
+    size_t getIdleContexts() const { return 0; }
+    size_t getPoolSize() const { return poolSize; }
+
+    // Same lazy-refresh rule as the real client, applied inline: an
+    // in-memory write costs nothing worth batching, so every queued refresh
+    // is written at once (queued == written, nothing coalesces or fails)
+    void setSessionRefresh(double fraction, [[maybe_unused]] std::chrono::milliseconds flushInterval) {
+        refreshFraction = fraction < 0 ? 0 : (fraction > 1 ? 1 : fraction);
+    }
+    uint64_t getTouchesSkipped() const { return touchesSkipped.load(std::memory_order_relaxed); }
+    uint64_t getTouchesQueued() const { return touchesQueued.load(std::memory_order_relaxed); }
+    uint64_t getTouchesCoalesced() const { return 0; }
+    uint64_t getTouchesWritten() const { return touchesWritten.load(std::memory_order_relaxed); }
+    uint64_t getTouchesFailed() const { return 0; }
+
     bool connect() {
         connected = true;
-        std::cout << "[Redis MOCK] Connected to " << host << ":" << port << std::endl;
+        BITEA_LOG_INFO("Redis MOCK", "Connected to %s:%d", host.c_str(), port);
         return true;
     }
 
     void disconnect() {
         connected = false;
-        std::cout << "[Redis MOCK] Disconnected" << std::endl;
+        BITEA_LOG_INFO("Redis MOCK", "Disconnected");
     }
 
     bool isConnected() const {
@@ -786,15 +1344,17 @@ public:
     }
 
     bool set(const std::string& key, const std::string& value) {
+        BITEA_TIME_DB_CALL("redis", "set");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "set");
         cache[key] = value;
         return true;
     }
 
     bool get(const std::string& key, std::string& value) {
+        BITEA_TIME_DB_CALL("redis", "get");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "get");
         auto it = cache.find(key);
         if (it != cache.end()) {
             value = it->second;
@@ -804,59 +1364,66 @@ public:
     }
 
     bool del(const std::string& key) {
+        BITEA_TIME_DB_CALL("redis", "del");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "del");
         return cache.erase(key) > 0;
     }
 
     bool exists(const std::string& key) {
+        BITEA_TIME_DB_CALL("redis", "exists");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "exists");
         return cache.find(key) != cache.end();
     }
 
     bool createSession(const Session& session) {
+        BITEA_TIME_DB_CALL("redis", "createSession");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
-        sessions[session.getSessionId()] = session;
-        std::cout << "[Redis MOCK] Created session: " << session.getSessionId() 
-                  << " for user: " << session.getUsername() << std::endl;
+        ProfiledLock lock(cacheMutex, "createSession");
+        sessions[session.getSessionId()] = {session, session.getExpiresAt()};
+        BITEA_LOG_DEBUG("Redis MOCK", "Created session: %s for user: %s",
+                        session.getSessionId().c_str(), session.getUsername().c_str());
         return true;
     }
 
     bool getSession(const std::string& sessionId, Session& session) {
+        BITEA_TIME_DB_CALL("redis", "getSession");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "getSession");
         auto it = sessions.find(sessionId);
         if (it != sessions.end()) {
-            session = it->second;
-            if (session.isExpired()) {
+            if (it->second.keyExpiresAt <= std::time(nullptr)) {
                 sessions.erase(it);
                 return false;
             }
+            session = it->second.session;
             return true;
         }
         return false;
     }
 
     bool deleteSession(const std::string& sessionId) {
+        BITEA_TIME_DB_CALL("redis", "deleteSession");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "deleteSession");
         auto result = sessions.erase(sessionId) > 0;
         if (result) {
-            std::cout << "[Redis MOCK] Deleted session: " << sessionId << std::endl;
+            BITEA_LOG_DEBUG("Redis MOCK", "Deleted session: %s", sessionId.c_str());
         }
         return result;
     }
 
     bool refreshSession(const std::string& sessionId) {
+        BITEA_TIME_DB_CALL("redis", "refreshSession");
         if (!connected) return false;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "refreshSession");
         auto it = sessions.find(sessionId);
         if (it != sessions.end()) {
-            if (!it->second.isExpired()) {
-                it->second.refresh();
-                std::cout << "[Redis MOCK] Refreshed session: " << sessionId << std::endl;
+            time_t now = std::time(nullptr);
+            if (it->second.keyExpiresAt > now) {
+                it->second.keyExpiresAt = now + SESSION_LIFETIME_SECONDS;
+                BITEA_LOG_DEBUG("Redis MOCK", "Refreshed session: %s", sessionId.c_str());
                 return true;
             } else {
                 sessions.erase(it);
@@ -865,14 +1432,61 @@ public:
         return false;
     }
 
+    bool getAndRefreshSession(const std::string& sessionId, Session& session) {
+        BITEA_TIME_DB_CALL("redis", "getAndRefreshSession");
+        if (!connected) return false;
+        ProfiledLock lock(cacheMutex, "getAndRefreshSession");
+        auto it = sessions.find(sessionId);
+        if (it == sessions.end()) return false;
+        time_t now = std::time(nullptr);
+        if (it->second.keyExpiresAt <= now) {
+            sessions.erase(it);
+            return false;
+        }
+        if (it->second.keyExpiresAt - now < refreshFraction * SESSION_LIFETIME_SECONDS) {
+            it->second.keyExpiresAt = now + SESSION_LIFETIME_SECONDS;
+            touchesQueued.fetch_add(1, std::memory_order_relaxed);
+            touchesWritten.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            touchesSkipped.fetch_add(1, std::memory_order_relaxed);
+        }
+        session = it->second.session;
+        return true;
+    }
+
+    bool revokeToken(const std::string& tokenId, int64_t expiresAt) {
+        BITEA_TIME_DB_CALL("redis", "revokeToken");
+        if (!connected) return false;
+        ProfiledLock lock(cacheMutex, "revokeToken");
+        revokedTokens[tokenId] = expiresAt;
+        return true;
+    }
+
+    bool loadRevokedTokens(int64_t now, std::vector<std::pair<std::string, int64_t>>& out) {
+        BITEA_TIME_DB_CALL("redis", "loadRevokedTokens");
+        if (!connected) return false;
+        ProfiledLock lock(cacheMutex, "loadRevokedTokens");
+        out.clear();
+        for (auto it = revokedTokens.begin(); it != revokedTokens.end();) {
+            if (it->second <= now) {
+                it = revokedTokens.erase(it);
+            } else {
+                out.emplace_back(it->first, it->second);
+                ++it;
+            }
+        }
+        return true;
+    }
+
     void cleanupExpiredSessions() {
         if (!connected) return;
-        std::lock_guard<std::mutex> lock(cacheMutex);
+        ProfiledLock lock(cacheMutex, "cleanupExpiredSessions");
         
+        time_t now = std::time(nullptr);
         auto it = sessions.begin();
         int cleaned = 0;
         while (it != sessions.end()) {
-            if (it->second.isExpired()) {
+            if (it->second.keyExpiresAt <= now) {
                 it = sessions.erase(it);
                 cleaned++;
             } else {
@@ -881,15 +1495,17 @@ public:
         }
         
         if (cleaned > 0) {
-            std::cout << "[Redis MOCK] Cleaned up " << cleaned << " expired sessions" << std::endl;
+            BITEA_LOG_INFO("Redis MOCK", "Cleaned up %d expired sessions", cleaned);
         }
     }
 
     int getSessionCount() const {
+        ProfiledLock lock(cacheMutex, "getSessionCount");
         return sessions.size();
     }
 
     int getCacheSize() const {
+        ProfiledLock lock(cacheMutex, "getCacheSize");
         return cache.size();
     }
 };
@@ -84,15 +84,23 @@
  * - System Design: Microservices, separation of concerns
  ******************************************************************************/
 
-#include <iostream>    // std::cout, std::cerr - logging and output
+#include <atomic>      // std::atomic - failed revocation counter
+#include <charconv>    // std::from_chars - query parameter parsing
+#include <cstdlib>     // std::getenv - optional runtime switches
+#include <ctime>       // std::time - signed token issue/expiry times
+#include <iostream>    // std::cout - startup banner, chain info
 #include <memory>      // std::unique_ptr, std::make_unique - smart pointers
-#include <sstream>     // std::stringstream - JSON building
+#include <mutex>       // std::mutex - batch sub-request completion
+#include <sstream>     // std::istringstream - URL percent-decoding
 
 // ============================================================================
 // PROJECT COMPONENT INCLUDES
 // ============================================================================
 
 #include "server/HttpServer.h"        // HTTP web server with routing
+#include "server/TaskExecutor.h"      // Worker pool for blocking storage calls
+#include "server/AdmissionController.h" // Load shedding on storage queue delay
+#include "server/ResponseCache.h"     // Coalescing + short TTL for hot post reads
 #include "blockchain/Blockchain.h"    // Blockchain ledger management
 #include "database/MongoClient.h"     // MongoDB client for data storage
 #include "database/RedisClient.h"     // Redis client for session storage
@@ -100,6 +108,19 @@
 #include "models/Post.h"              // Social media post model
 #include "models/Session.h"           // Authentication session model
 #include "utils/InputValidator.h"     // Input validation utilities
+#include "utils/JsonParser.h"         // Request body parsing (JsonDocument)
+#include "utils/JsonWriter.h"         // Response serialization (JsonWriter)
+#include "utils/Logger.h"             // Asynchronous logger, BITEA_LOG_LEVEL
+#include "utils/Metrics.h"            // Prometheus registry for GET /metrics
+#include "utils/Trace.h"              // Request phase spans, GET /debug/traces
+#include "utils/ProfiledMutex.h"      // Lock contention report, GET /debug/locks
+#include "utils/CpuProfiler.h"        // Sampling profiler, GET /debug/profile
+#include "utils/AllocTracker.h"       // Optional per-route allocation counters
+#include "utils/SessionToken.h"       // Signed session tokens, revocation set
+
+// Replacement operator new/delete (BITEA_ALLOC_TRACKING builds only;
+// expands to nothing otherwise). Must live in exactly one translation unit.
+BITEA_ALLOC_HOOKS();
 
 // ============================================================================
 // BITEA APPLICATION CLASS
@@ -202,6 +223,65 @@ private:
      */
     std::unique_ptr<RedisClient> redis;
 
+    /**
+     * @brief Executor for blocking storage work (MongoDB, Redis, mining)
+     * @type std::unique_ptr<TaskExecutor>
+     * 
+     * PURPOSE: Async routes run their handler body here, so HTTP workers
+     * are released while a request waits on a database round trip
+     * 
+     * SIZE: 16 threads (upper bound on concurrent storage-bound handlers)
+     */
+    std::unique_ptr<TaskExecutor> storageExecutor;
+
+    /**
+     * @brief Single-thread executor for long-running diagnostics
+     * 
+     * PURPOSE: GET /debug/profile sleeps for the whole profiling window;
+     * running it here keeps HTTP workers and storage threads free
+     */
+    std::unique_ptr<TaskExecutor> debugExecutor;
+
+    /**
+     * @brief CoDel admission control for the storage executor queue
+     * 
+     * PURPOSE: When MongoDB/Redis fall behind, requests that waited too long
+     * for a storage thread are answered 503 instead of piling up further
+     * (separate from HttpServer's controller, which watches its own queue)
+     */
+    AdmissionController storageAdmission;
+
+    /**
+     * @brief Single-flight coalescing and short-lived cache for post reads
+     * 
+     * PURPOSE: A burst of identical GET /api/posts or /api/posts/:id
+     * requests costs one MongoDB query and one serialization; see
+     * onStorageCoalesced(). Post writes call invalidate().
+     * 
+     * TTL: 250ms by default, BITEA_READ_CACHE_MS overrides (0 = coalesce only)
+     */
+    ResponseCache readCache;
+
+    /**
+     * @brief Optional stateless session tokens (utils/SessionToken.h)
+     * 
+     * PURPOSE: With BITEA_TOKEN_KEYS set, /api/login issues HMAC-signed
+     * tokens that validateSession() checks without a Redis round trip;
+     * Redis session IDs issued earlier keep working. Logout lists the
+     * token in revokedTokens, which syncs with Redis every
+     * BITEA_TOKEN_REVOCATION_SYNC_MS (declared after redis: its sync
+     * thread stops before the client is destroyed).
+     * 
+     * LIFETIME: BITEA_TOKEN_TTL_SECONDS (default 86400), not sliding
+     * 
+     * revocationsFailed: logouts whose token could not be added to the
+     * shared Redis set (revoked in this process only; answered 503)
+     */
+    SessionTokenSigner tokenSigner;
+    RevokedTokens revokedTokens;
+    int64_t tokenLifetimeSeconds = 86400;
+    std::atomic<uint64_t> revocationsFailed{0};
+
     // ========================================================================
     // PRIVATE HELPER METHODS (Utilities for Route Handlers)
     // ========================================================================
@@ -251,11 +331,13 @@ private:
      * 
      * VALIDATION WORKFLOW:
      * 1. Extract session ID from Authorization header
-     * 2. Lookup session in Redis
+     *    (signed token: verify HMAC, expiry, revocation locally and stop)
+     * 2. Lookup session and its remaining TTL in Redis in one read-only
+     *    round trip; near expiry, a batched background refresh is queued
+     *    (sliding window, see getAndRefreshSession())
      * 3. Check if session exists and not expired
      * 4. Retrieve username from session
-     * 5. Refresh session expiration (sliding window)
-     * 6. Return true if valid, false otherwise
+     * 5. Return true if valid, false otherwise
      * 
      * USAGE PATTERN:
      * std::string username;
@@ -265,21 +347,34 @@ private:
      * // Authenticated - username contains current user
      * 
      * SIDE EFFECT:
-     * Refreshes session on each use (extends expiration)
+     * Extends the session's expiration (batched) once less than
+     * BITEA_SESSION_REFRESH_FRACTION of its lifetime remains
      * 
      * CALLED BY: All protected route handlers
      */
     bool validateSession(const HttpRequest& req, std::string& username) {
+        TraceScope phase("auth.validateSession");
+
         // Extract session ID from request
         std::string sessionId = getSessionId(req);
         if (sessionId.empty()) return false;
 
-        // Lookup session in Redis
+        // Signed token: signature, expiry and revocation checked locally
+        if (tokenSigner.enabled() && SessionTokenSigner::looksSigned(sessionId)) {
+            TokenClaims claims;
+            if (!tokenSigner.verify(sessionId, static_cast<int64_t>(std::time(nullptr)), claims) ||
+                revokedTokens.contains(claims.tokenId)) {
+                return false;
+            }
+            username = claims.username;
+            return true;
+        }
+
+        // Lookup session in Redis, extending its expiration
         Session session;
-        if (redis->getSession(sessionId, session)) {
+        if (redis->getAndRefreshSession(sessionId, session)) {
             // Session found and valid
             username = session.getUsername();
-            redis->refreshSession(sessionId);  // Extend expiration
             return true;
         }
         
@@ -336,54 +431,395 @@ private:
     }
 
     /**
-     * @brief Extracts value from JSON string (simplified parser)
-     * @param json JSON string
-     * @param key Key to extract
-     * @return std::string - Value for key, or empty string
+     * @brief Parses a JSON request body, answering 400 if it is malformed
+     * @param req Request whose body is parsed (must outlive body's views)
+     * @param res Response, filled with 400 on failure
+     * @param body Parsed document (utils/JsonParser.h)
+     * @return bool - false if the handler should return immediately
      * 
-     * PURPOSE: Simple JSON parsing without external library
+     * PURPOSE: One pass over the body; handlers then read each field in O(1)
      * 
-     * PATTERN: Finds "key":"value" in JSON
+     * USAGE:
+     * JsonDocument body;
+     * if (!parseJsonBody(req, res, body)) return;
+     * std::string username = field(body, "username");
      * 
-     * EXAMPLE:
-     * JSON: {"username":"alice","email":"alice@example.com"}
-     * getJsonValue(json, "username") → "alice"
+     * STRINGS: Escapes are decoded (\" \n \uXXXX, ...), so content is stored
+     * as the user typed it; models escape again when serializing
+     */
+    static bool parseJsonBody(const HttpRequest& req, HttpResponse& res, JsonDocument& body) {
+        if (body.parse(req.body)) return true;
+        res.statusCode = 400;
+        res.json("{\"error\":\"Invalid JSON body\"}");
+        return false;
+    }
+
+    /**
+     * @brief String field of a parsed body as std::string ("" if absent)
+     */
+    static std::string field(const JsonDocument& body, std::string_view key) {
+        return std::string(body.getString(key));
+    }
+
+    // Feed page size: default when ?limit= is absent, and upper bound
+    static constexpr size_t FEED_DEFAULT_LIMIT = 50;
+    static constexpr size_t FEED_MAX_LIMIT = 200;
+
+    /**
+     * @brief Parses an unsigned integer query parameter, answering 400 if bad
+     * @param name Parameter name (value left untouched when absent)
+     * @return bool - false if the handler should return immediately
+     */
+    template <typename T>
+    static bool parseQueryNumber(const HttpRequest& req, HttpResponse& res,
+                                 const char* name, T& value) {
+        auto param = req.query.find(name);
+        if (param == req.query.end()) return true;
+        const std::string& text = param->second;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec == std::errc() && result.ptr == text.data() + text.size()) return true;
+        res.statusCode = 400;
+        res.json("{\"error\":\"Invalid " + std::string(name) + "\"}");
+        return false;
+    }
+
+    /**
+     * @brief Reads ?limit= (1..FEED_MAX_LIMIT, default FEED_DEFAULT_LIMIT)
+     * @return bool - false if the handler should return immediately
+     */
+    static bool parseLimit(const HttpRequest& req, HttpResponse& res, size_t& limit) {
+        limit = FEED_DEFAULT_LIMIT;
+        if (!parseQueryNumber(req, res, "limit", limit)) return false;
+        if (limit == 0 || limit > FEED_MAX_LIMIT) {
+            res.statusCode = 400;
+            res.json("{\"error\":\"limit must be between 1 and " + std::to_string(FEED_MAX_LIMIT) + "\"}");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads ?fields= (PostFields names, comma separated)
+     * @return bool - false if the handler should return immediately
      * 
-     * LIMITATIONS:
-     * - Very simplified (not a real JSON parser)
-     * - Only handles string values (not numbers, booleans, objects)
-     * - Doesn't handle escaped quotes in values
-     * - Doesn't validate JSON structure
+     * Absent: PostFields::SUMMARY (every summary field, as before)
+     * EXAMPLE: ?fields=id,author,preview,likes,comments
+     */
+    static bool parseFields(const HttpRequest& req, HttpResponse& res, uint32_t& fields) {
+        fields = PostFields::SUMMARY;
+        auto param = req.query.find("fields");
+        if (param == req.query.end() || PostFields::parse(param->second, fields)) return true;
+        res.statusCode = 400;
+        res.json("{\"error\":\"Invalid fields (allowed: id, author, content, preview, "
+                 "timestamp, likes, comments, isOnChain)\"}");
+        return false;
+    }
+
+    /**
+     * @brief Reads ?limit= and ?cursor= for the feed, answering 400 if bad
+     * @return bool - false if the handler should return immediately
      * 
-     * PRODUCTION:
-     * Use proper JSON library (nlohmann/json, RapidJSON)
+     * cursor: token from a previous page's X-Next-Cursor (FeedCursor)
+     */
+    static bool parsePageParams(const HttpRequest& req, HttpResponse& res,
+                                size_t& limit, FeedCursor& cursor) {
+        if (!parseLimit(req, res, limit)) return false;
+        auto cursorParam = req.query.find("cursor");
+        if (cursorParam != req.query.end() && !FeedCursor::decode(cursorParam->second, cursor)) {
+            res.statusCode = 400;
+            res.json("{\"error\":\"Invalid cursor\"}");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Builds the Link rel="next" header for a feed page
+     * @param nextCursor X-Next-Cursor of the page just served
      * 
-     * USAGE:
-     * Extract request body parameters in route handlers
-     * std::string username = getJsonValue(req.body, "username");
+     * Same path and query as the request (limit, fields, ...) with only
+     * cursor replaced, so following the link keeps the page shape.
+     * Query values are kept as received (parseQueryString does not decode).
+     */
+    static std::string nextPageLink(const HttpRequest& req, const std::string& nextCursor) {
+        std::string link = "<" + req.path + "?";
+        for (const auto& [key, value] : req.query) {
+            if (key == "cursor") continue;
+            link += key + "=" + value + "&";
+        }
+        link += "cursor=" + nextCursor + ">; rel=\"next\"";
+        return link;
+    }
+
+    /**
+     * @brief Wraps a synchronous handler so it runs on the storage executor
+     * @param handler Ordinary route handler (may block on MongoDB/Redis)
+     * @param shed Apply storage load shedding (false for coalesced fetches)
+     * @return AsyncRouteHandler - Handler suitable for getAsync()/postAsync()
+     * 
+     * PURPOSE: Storage-bound routes suspend instead of pinning an HTTP worker
+     * 
+     * FLOW:
+     * 1. HTTP worker matches route, creates AsyncContext, calls this wrapper
+     * 2. Wrapper queues handler body on storageExecutor and returns
+     * 3. Storage thread runs handler, then ctx->complete() sends the response
      * 
-     * WHY SIMPLIFIED:
-     * Educational/MVP - demonstrates concept
-     * Avoids external dependency
-     * Works for basic use cases
+     * LOAD SHEDDING:
+     * Before running the handler, the time spent queued on storageExecutor
+     * goes through storageAdmission with the route's RequestClass
+     * 
+     * ERRORS:
+     * - Executor shutting down: 503 immediately
+     * - Shed under overload: 503 with Retry-After
+     * - Handler throws: AsyncContext destructor answers 500
      */
-    std::string getJsonValue(const std::string& json, const std::string& key) {
-        // Build search pattern: "key":"
-        std::string pattern = "\"" + key + "\":\"";
-        
-        // Find pattern in JSON
-        size_t start = json.find(pattern);
-        if (start == std::string::npos) return "";  // Key not found
-        
-        // Move past pattern to start of value
-        start += pattern.length();
-        
-        // Find closing quote
-        size_t end = json.find("\"", start);
-        if (end == std::string::npos) return "";  // Malformed JSON
-        
-        // Extract value between quotes
-        return json.substr(start, end - start);
+    AsyncRouteHandler onStorage(RouteHandler handler, bool shed = true) {
+        return [this, handler, shed](std::shared_ptr<AsyncContext> ctx) {
+            auto queuedAt = TaskExecutor::Clock::now();
+            bool queued = storageExecutor->submit([this, ctx, handler, shed, queuedAt] {
+                auto startedAt = TaskExecutor::Clock::now();
+                TraceBinding binding(ctx->trace.get());
+                if (ctx->trace) ctx->trace->add("storage.queue", queuedAt, startedAt);
+
+                auto sojourn = startedAt - queuedAt;
+                if (shed && !storageAdmission.admit(ctx->requestClass, sojourn)) {
+                    ctx->response.statusCode = 503;
+                    ctx->response.headers["Retry-After"] = "1";
+                    ctx->response.json("{\"error\":\"Server overloaded, retry later\"}");
+                } else {
+                    TraceScope phase("handler");
+                    handler(ctx->request, ctx->response);
+                }
+                ctx->complete();
+            });
+            if (!queued) {
+                ctx->response.statusCode = 503;
+                ctx->response.json("{\"error\":\"Server shutting down\"}");
+                ctx->complete();
+            }
+        };
+    }
+
+    /**
+     * @brief onStorage() for cacheable reads: identical requests share a fetch
+     * @param handler Read-only handler whose output depends only on path,
+     *                query and encoding (ResponseCache key)
+     * @return AsyncRouteHandler - Handler suitable for getAsync()
+     * 
+     * FLOW:
+     * - Cached and fresh: answered right here, no storage thread used
+     * - Same request already being fetched: parked until that fetch ends
+     * - Otherwise: the handler runs via onStorage() in a socket-less
+     *   AsyncContext whose completion answers every parked request
+     * 
+     * LOAD SHEDDING: The fetch skips storageAdmission. It answers every
+     * request parked on it, so shedding it would turn one late query into
+     * a 503 for the whole burst; storage load is already bounded to one
+     * fetch per distinct request.
+     */
+    AsyncRouteHandler onStorageCoalesced(RouteHandler handler) {
+        AsyncRouteHandler fetch = onStorage(std::move(handler), false);
+        return [this, fetch](std::shared_ptr<AsyncContext> ctx) {
+            std::string key = ResponseCache::keyFor(ctx->request, ctx->response.format);
+            std::shared_ptr<ResponseCache::Flight> flight;
+            switch (readCache.lookupOrJoin(key, ctx, flight)) {
+                case ResponseCache::Outcome::HIT:
+                    ctx->complete();
+                    return;
+                case ResponseCache::Outcome::COALESCED:
+                    return;
+                case ResponseCache::Outcome::MISS:
+                    break;
+            }
+
+            auto leader = std::make_shared<AsyncContext>(-1, ctx->request);
+            leader->response.format = ctx->response.format;
+            leader->requestClass = ctx->requestClass;
+            leader->trace = ctx->trace;
+            leader->onComplete = [this, flight](const HttpResponse& res) {
+                readCache.publish(flight, res);
+            };
+            fetch(leader);
+        };
+    }
+
+    // Sub-requests accepted by one POST /api/batch
+    static constexpr size_t BATCH_MAX_REQUESTS = 20;
+
+    /**
+     * @struct BatchRun
+     * @brief One POST /api/batch while its sub-requests execute
+     * 
+     * Each sub-response is stored in its own slot by whichever thread
+     * finishes it; taking the mutex afterwards orders those writes before
+     * the final response is built.
+     */
+    struct BatchRun {
+        std::shared_ptr<AsyncContext> ctx;    // The batch request itself
+        std::vector<HttpRequest> requests;    // Moved out when started
+        std::vector<HttpResponse> responses;  // Same order as requests
+        std::mutex mutex;
+        size_t next = 0;     // First sub-request not started yet
+        size_t pending = 0;  // Started in the current stage, not finished
+    };
+
+    /**
+     * @brief Converts one "requests" entry into an HttpRequest
+     * @param text Raw JSON object {"method","path","headers"?,"body"?}
+     * @param parent The batch request (its Authorization is inherited)
+     * @param error Reason, set when false is returned
+     * @return bool - false if the entry is malformed
+     */
+    static bool parseBatchEntry(std::string_view text, const HttpRequest& parent,
+                                HttpRequest& out, std::string& error) {
+        JsonDocument entry;
+        if (!entry.parse(text)) {
+            error = "must be an object";
+            return false;
+        }
+
+        // parseMethod() falls back to GET: insist on an exact name
+        std::string method(entry.getString("method"));
+        out.method = HttpServer::parseMethod(method);
+        if (out.method == HttpMethod::OPTIONS || method != HttpServer::methodName(out.method)) {
+            error = "invalid method";
+            return false;
+        }
+
+        std::string_view path = entry.getString("path");
+        if (path.empty() || path[0] != '/') {
+            error = "path must start with '/'";
+            return false;
+        }
+        size_t queryPos = path.find('?');
+        out.path = std::string(path.substr(0, queryPos));
+        if (queryPos != std::string_view::npos) {
+            HttpServer::parseQueryString(std::string(path.substr(queryPos + 1)), out.query);
+        }
+        if (out.path == "/api/batch") {
+            error = "batches cannot be nested";
+            return false;
+        }
+
+        auto auth = parent.headers.find("Authorization");
+        if (auth != parent.headers.end()) out.headers[auth->first] = auth->second;
+        if (const JsonField* headers = entry.find("headers")) {
+            JsonDocument headerDoc;
+            if (headers->type != JsonType::OBJECT || !headerDoc.parse(headers->value)) {
+                error = "headers must be an object";
+                return false;
+            }
+            for (size_t i = 0; i < headerDoc.size(); i++) {
+                const JsonField& header = headerDoc.field(i);
+                if (header.type != JsonType::STRING) {
+                    error = "header values must be strings";
+                    return false;
+                }
+                out.headers[std::string(header.key)] = std::string(header.value);
+            }
+        }
+
+        // Objects/arrays are forwarded as their JSON text, strings as-is
+        if (const JsonField* body = entry.find("body")) {
+            if (body->type != JsonType::OBJECT && body->type != JsonType::ARRAY &&
+                body->type != JsonType::STRING) {
+                error = "body must be an object, array or string";
+                return false;
+            }
+            out.body = std::string(body->value);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Starts the next stage of a batch, or answers once none is left
+     * 
+     * STAGES:
+     * - A run of consecutive GETs starts at once; async routes among them
+     *   run in parallel on their executors
+     * - Any other method runs alone, after every entry listed before it
+     *   and before any listed after it
+     * So reads are overlapped while writes keep the effects (and the
+     * read-your-writes order) of sending the entries one by one.
+     * 
+     * Called again by the sub-request that finishes a stage, on whichever
+     * thread completed it.
+     */
+    void runBatchStage(const std::shared_ptr<BatchRun>& run) {
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            begin = end = run->next;
+            if (end < run->requests.size()) {
+                bool reads = run->requests[end++].method == HttpMethod::GET;
+                while (reads && end < run->requests.size() &&
+                       run->requests[end].method == HttpMethod::GET) {
+                    end++;
+                }
+            }
+            run->next = end;
+            run->pending = end - begin;
+        }
+
+        if (begin == end) {
+            writeBatchResponse(*run);
+            run->ctx->complete();
+            return;
+        }
+
+        WireFormat format = run->ctx->response.format;
+        for (size_t i = begin; i < end; i++) {
+            server->dispatchAsync(std::move(run->requests[i]), format,
+                [this, run, i](const HttpResponse& response) {
+                    run->responses[i] = response;
+                    bool stageDone;
+                    {
+                        std::lock_guard<std::mutex> lock(run->mutex);
+                        stageDone = --run->pending == 0;
+                    }
+                    if (stageDone) runBatchStage(run);
+                });
+        }
+    }
+
+    /**
+     * @brief Writes {"responses":[{"status","headers","body"}, ...]}
+     * 
+     * - body: embedded as-is when the sub-response uses the batch's own
+     *   encoding, as a string otherwise (json() errors are always JSON
+     *   text), null when empty
+     * - headers: those the handler set beyond the server defaults
+     *   (X-Next-Cursor, Link, Retry-After, ...)
+     */
+    static void writeBatchResponse(BatchRun& run) {
+        HttpResponse& res = run.ctx->response;
+        const std::string contentType = wireFormatContentType(res.format);
+        JsonWriter writer(res.jsonBuffer(), res.format);
+        writer.beginObject().key("responses").beginArray();
+        for (const auto& sub : run.responses) {
+            writer.beginObject()
+                  .field("status", sub.statusCode)
+                  .key("headers").beginObject();
+            for (const auto& header : sub.headers) {
+                if (header.first == "Content-Type" || header.first == "Vary" ||
+                    header.first.compare(0, 15, "Access-Control-") == 0) {
+                    continue;
+                }
+                writer.field(header.first, header.second);
+            }
+            writer.endObject().key("body");
+
+            auto type = sub.headers.find("Content-Type");
+            if (sub.body.empty()) {
+                writer.null();
+            } else if (type != sub.headers.end() && type->second == contentType) {
+                writer.raw(sub.body);
+            } else {
+                writer.value(sub.body);
+            }
+            writer.endObject();
+        }
+        writer.endArray().endObject();
     }
 
     // ========================================================================
@@ -425,6 +861,12 @@ public:
         // Create database clients (connect later in run())
         mongodb = std::make_unique<MongoClient>();
         redis = std::make_unique<RedisClient>();
+
+        // Storage executor for async routes (16 threads)
+        storageExecutor = std::make_unique<TaskExecutor>("storage", 16);
+
+        // Diagnostics executor (one profile at a time anyway)
+        debugExecutor = std::make_unique<TaskExecutor>("debug", 1);
     }
 
     // ========================================================================
@@ -451,6 +893,11 @@ public:
      * Protected routes call validateSession() first
      * Returns 401 Unauthorized if session invalid
      * 
+     * ASYNC ROUTES:
+     * Routes that touch MongoDB/Redis (or mine) are registered with
+     * getAsync()/postAsync() + onStorage(), so their blocking work runs on
+     * storageExecutor and HTTP workers stay free for other requests
+     * 
      * DUAL STORAGE PATTERN:
      * Most write operations:
      * 1. Store in database (fast retrieval)
@@ -497,23 +944,141 @@ public:
          * - Monitoring: Track blockchain growth
          * - Admin: Quick system overview
          */
-        server->get("/api", [this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
-            std::stringstream ss;
-            ss << "{";
-            ss << "\"name\":\"Bitea API\",";
-            ss << "\"version\":\"1.0.0\",";
-            ss << "\"blockchain\":{";
-            ss << "\"blocks\":" << blockchain->getChainLength() << ",";
-            ss << "\"pending\":" << blockchain->getPendingTransactionCount() << ",";
-            ss << "\"valid\":" << (blockchain->isChainValid() ? "true" : "false");
-            ss << "},";
-            ss << "\"database\":{";
-            ss << "\"users\":" << mongodb->getUserCount() << ",";
-            ss << "\"posts\":" << mongodb->getPostCount();
-            ss << "},";
-            ss << "\"sessions\":" << redis->getSessionCount();
-            ss << "}";
-            res.json(ss.str());
+        server->getAsync("/api", onStorage([this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.beginObject()
+                  .field("name", "Bitea API")
+                  .field("version", "1.0.0");
+            writer.key("blockchain").beginObject()
+                  .field("blocks", blockchain->getChainLength())
+                  .field("pending", blockchain->getPendingTransactionCount())
+                  .field("valid", blockchain->isChainValid())
+                  .endObject();
+            writer.key("database").beginObject()
+                  .field("users", mongodb->getUserCount())
+                  .field("posts", mongodb->getPostCount())
+                  .endObject();
+            writer.field("sessions", redis->getSessionCount())
+                  .endObject();
+        }));
+
+        /**
+         * ENDPOINT: GET /metrics
+         * PURPOSE: Prometheus scrape target
+         * AUTH: None (bind to a private interface or filter at the proxy)
+         * 
+         * RESPONSE: Prometheus text format 0.0.4 (see utils/Metrics.h)
+         * - Request latency histograms per method/route/status
+         * - Open connections, worker and storage queue depth
+         * - Mempool size, chain height
+         * - MongoDB/Redis call latency histograms
+         * 
+         * SYNCHRONOUS: Only reads in-memory counters, never touches storage
+         */
+        server->get("/metrics", []([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+            res.text(Metrics::instance().render());
+            res.headers["Content-Type"] = "text/plain; version=0.0.4";
+        });
+
+        /**
+         * ENDPOINT: GET /debug/traces
+         * PURPOSE: Recent sampled and slow request traces
+         * AUTH: None (bind to a private interface or filter at the proxy)
+         * 
+         * RESPONSE: Chrome trace-event JSON, one row per request with its
+         * phases (queue, parse, handler, redis.*, mongodb.*, blockchain.*,
+         * write). Save and open in chrome://tracing or ui.perfetto.dev.
+         */
+        server->get("/debug/traces", []([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+            res.json(Tracer::instance().exportChromeJson());
+        });
+
+        /**
+         * ENDPOINT: GET /debug/locks
+         * PURPOSE: Contention profile of every ProfiledMutex (changeMutex, Redis pool, chainMutex, ...)
+         * AUTH: None (bind to a private interface or filter at the proxy)
+         * 
+         * RESPONSE (times in microseconds, see utils/ProfiledMutex.h):
+         * {"profiling":true,"locks":[{"name":"mongodb","acquisitions":..,
+         *  "contended":..,"wait_us_total":..,"wait_us_max":..,"wait_us_p50":..,
+         *  "wait_us_p99":..,"hold_us_total":..,"hold_us_max":..,
+         *  "sites":[{"site":"insertPost",...}]}]}
+         * 
+         * READ-ONLY: zeroing the counters is POST /debug/locks/reset
+         */
+        server->get("/debug/locks", []([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+            res.json(LockRegistry::instance().reportJson());
+        });
+
+        /**
+         * ENDPOINT: POST /debug/locks/reset
+         * PURPOSE: Start a fresh contention window
+         * AUTH: None (bind to a private interface or filter at the proxy)
+         * 
+         * RESPONSE: The numbers up to now (same JSON as GET /debug/locks),
+         * taken just before every counter is zeroed
+         */
+        server->post("/debug/locks/reset", []([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+            res.json(LockRegistry::instance().reportJson());
+            LockRegistry::instance().resetAll();
+        });
+
+        /**
+         * ENDPOINT: GET /debug/profile[?seconds=10&hz=99]
+         * PURPOSE: On-demand CPU profile of the whole server
+         * AUTH: None (bind to a private interface or filter at the proxy)
+         * 
+         * RESPONSE: text/plain folded stacks ("thread;outer;...;leaf count"),
+         * ready for flamegraph.pl or speedscope; headers X-Profile-Samples and
+         * X-Profile-Dropped report how much was captured
+         * 
+         * LIMITS (see utils/CpuProfiler.h):
+         * - seconds 1..60 (default 10), hz 1..1000 (default 99); anything
+         *   else, including non-numbers, is answered 400
+         * - One profile at a time: 409 while another is running (requests
+         *   racing in before it starts queue behind it on debugExecutor)
+         * 
+         * ASYNC: The window is spent on debugExecutor, not an HTTP worker
+         */
+        server->getAsync("/debug/profile", [this](std::shared_ptr<AsyncContext> ctx) {
+            int seconds = 10;
+            int hz = 99;
+            if (!parseQueryNumber(ctx->request, ctx->response, "seconds", seconds) ||
+                !parseQueryNumber(ctx->request, ctx->response, "hz", hz)) {
+                ctx->complete();
+                return;
+            }
+            if (seconds < 1 || seconds > CpuProfiler::MAX_SECONDS || hz < 1 || hz > CpuProfiler::MAX_HZ) {
+                ctx->response.statusCode = 400;
+                ctx->response.json("{\"error\":\"seconds must be between 1 and " +
+                                   std::to_string(CpuProfiler::MAX_SECONDS) + ", hz between 1 and " +
+                                   std::to_string(CpuProfiler::MAX_HZ) + "\"}");
+                ctx->complete();
+                return;
+            }
+            if (CpuProfiler::instance().isRunning()) {
+                ctx->response.statusCode = 409;
+                ctx->response.json("{\"error\":\"A profile is already running\"}");
+                ctx->complete();
+                return;
+            }
+            bool queued = debugExecutor->submit([ctx, seconds, hz] {
+                ProfileResult result;
+                if (!CpuProfiler::instance().profile(seconds, hz, result)) {
+                    ctx->response.statusCode = 409;
+                    ctx->response.json("{\"error\":\"A profile is already running\"}");
+                } else {
+                    ctx->response.text(result.folded);
+                    ctx->response.headers["X-Profile-Samples"] = std::to_string(result.samples);
+                    ctx->response.headers["X-Profile-Dropped"] = std::to_string(result.dropped);
+                }
+                ctx->complete();
+            });
+            if (!queued) {
+                ctx->response.statusCode = 503;
+                ctx->response.json("{\"error\":\"Server shutting down\"}");
+                ctx->complete();
+            }
         });
 
         // ====================================================================
@@ -555,10 +1120,12 @@ public:
          * ERROR RESPONSES:
          * - 400: Invalid input (missing fields, format errors, duplicate username)
          */
-        server->post("/api/register", [this](const HttpRequest& req, HttpResponse& res) {
-            std::string username = InputValidator::trimWhitespace(getJsonValue(req.body, "username"));
-            std::string email = InputValidator::trimWhitespace(getJsonValue(req.body, "email"));
-            std::string password = getJsonValue(req.body, "password");
+        server->postAsync("/api/register", onStorage([this](const HttpRequest& req, HttpResponse& res) {
+            JsonDocument body;
+            if (!parseJsonBody(req, res, body)) return;
+            std::string username = InputValidator::trimWhitespace(field(body, "username"));
+            std::string email = InputValidator::trimWhitespace(field(body, "email"));
+            std::string password = field(body, "password");
 
             // Extract request body fields
             if (username.empty() || email.empty() || password.empty()) {
@@ -601,15 +1168,20 @@ public:
             mongodb->insertUser(newUser);
 
             // Record registration on blockchain (immutable proof)
-            std::stringstream txData;
-            txData << "{\"action\":\"register\",\"username\":\"" << InputValidator::sanitize(username) << "\"}";
-            Transaction tx(username, TransactionType::USER_REGISTRATION, txData.str());
+            std::string txData;
+            JsonWriter txWriter(txData);
+            txWriter.beginObject()
+                    .field("action", "register")
+                    .field("username", InputValidator::sanitize(username))
+                    .endObject();
+            Transaction tx(username, TransactionType::USER_REGISTRATION, txData);
             blockchain->addTransaction(tx);
 
             // Return created user (201 Created)
             res.statusCode = 201;
-            res.json(newUser.toJson(true));  // Include private data (email, etc.)
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            newUser.writeJson(writer, true);  // Include private data (email, etc.)
+        }));
 
         /**
          * ENDPOINT: POST /api/login
@@ -636,9 +1208,11 @@ public:
          * RESPONSE: 200 OK with session ID and user data
          * ERROR: 401 Unauthorized (same message for all auth failures)
          */
-        server->post("/api/login", [this](const HttpRequest& req, HttpResponse& res) {
-            std::string username = InputValidator::trimWhitespace(getJsonValue(req.body, "username"));
-            std::string password = getJsonValue(req.body, "password");
+        server->postAsync("/api/login", onStorage([this](const HttpRequest& req, HttpResponse& res) {
+            JsonDocument body;
+            if (!parseJsonBody(req, res, body)) return;
+            std::string username = InputValidator::trimWhitespace(field(body, "username"));
+            std::string password = field(body, "password");
 
             // Validate credentials presence
             if (username.empty() || password.empty()) {
@@ -669,20 +1243,30 @@ public:
                 return;
             }
 
-            // Authentication successful - create session
-            Session session(username);  // Auto-generates random session ID
-            redis->createSession(session);
+            // Authentication successful - create session: a signed token
+            // if keys are configured, else a Redis session
+            std::string sessionId;
+            if (tokenSigner.enabled()) {
+                TokenClaims claims;
+                sessionId = tokenSigner.mint(username, static_cast<int64_t>(std::time(nullptr)),
+                                             tokenLifetimeSeconds, claims);
+            } else {
+                Session session(username);  // Auto-generates random session ID
+                redis->createSession(session);
+                sessionId = session.getSessionId();
+            }
 
             // Update user's last login timestamp
             user.updateLastLogin();
             mongodb->updateUser(user);
 
             // Return session ID and user data
-            std::stringstream ss;
-            ss << "{\"sessionId\":\"" << session.getSessionId() << "\",";
-            ss << "\"user\":" << user.toJson(true) << "}";  // Include private data
-            res.json(ss.str());
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.beginObject().field("sessionId", sessionId);
+            writer.key("user");
+            user.writeJson(writer, true);  // Include private data
+            writer.endObject();
+        }));
 
         /**
          * ENDPOINT: POST /api/logout
@@ -691,22 +1275,46 @@ public:
          * 
          * WORKFLOW:
          * 1. Extract session ID from request
-         * 2. Delete session from Redis
+         * 2. Delete session from Redis (signed token: add it to the
+         *    revocation set, locally and in Redis)
          * 3. Return success message
          * 
          * IDEMPOTENT: Safe to call even if not logged in
          * 
+         * ERRORS:
+         * - 503 (Retry-After: 1): a signed token could not be added to the
+         *   shared revocation set in Redis. It is refused by this process
+         *   already, but other processes would accept it until it expires,
+         *   so the client must retry the logout
+         * 
          * SECURITY:
          * Removes session, forcing re-authentication
          * Should be called when user clicks "logout"
          */
-        server->post("/api/logout", [this](const HttpRequest& req, HttpResponse& res) {
+        server->postAsync("/api/logout", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             std::string sessionId = getSessionId(req);
-            if (!sessionId.empty()) {
+            if (tokenSigner.enabled() && SessionTokenSigner::looksSigned(sessionId)) {
+                // Signed token: refuse it here at once, everywhere after the next sync
+                TokenClaims claims;
+                int64_t now = static_cast<int64_t>(std::time(nullptr));
+                if (tokenSigner.verify(sessionId, now, claims)) {
+                    revokedTokens.add(claims.tokenId, claims.expiresAt, now);
+                    if (!redis->revokeToken(claims.tokenId, claims.expiresAt)) {
+                        revocationsFailed.fetch_add(1, std::memory_order_relaxed);
+                        BITEA_LOG_ERROR("Auth", "Could not publish revocation of token %s; "
+                                        "other processes accept it until it expires",
+                                        claims.tokenId.c_str());
+                        res.statusCode = 503;
+                        res.headers["Retry-After"] = "1";
+                        res.json("{\"error\":\"Logout could not be completed, please retry\"}");
+                        return;
+                    }
+                }
+            } else if (!sessionId.empty()) {
                 redis->deleteSession(sessionId);  // Remove session
             }
             res.json("{\"message\":\"Logged out successfully\"}");
-        });
+        }));
 
         // ====================================================================
         // POST ENDPOINTS (Social Media Content)
@@ -748,7 +1356,7 @@ public:
          * - 401: Not authenticated
          * - 400: Invalid content
          */
-        server->post("/api/posts", [this](const HttpRequest& req, HttpResponse& res) {
+        server->postAsync("/api/posts", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             // Authenticate user
             std::string username;
             if (!validateSession(req, username)) {
@@ -758,7 +1366,9 @@ public:
             }
 
             // Extract and trim post content
-            std::string content = InputValidator::trimWhitespace(getJsonValue(req.body, "content"));
+            JsonDocument body;
+            if (!parseJsonBody(req, res, body)) return;
+            std::string content = InputValidator::trimWhitespace(field(body, "content"));
             
             // Validate content (1-5000 chars, not all whitespace)
             if (!InputValidator::isValidPostContent(content)) {
@@ -774,42 +1384,120 @@ public:
             std::string postId = username + "-" + std::to_string(std::time(nullptr));
             Post post(postId, username, content);
             mongodb->insertPost(post);  // Store in database
+            readCache.invalidate();     // Feed must show it on the next read
 
             // Record on blockchain for immutability
-            std::stringstream txData;
-            txData << "{\"action\":\"post\",\"postId\":\"" << InputValidator::sanitize(postId)
-                   << "\",\"author\":\"" << InputValidator::sanitize(username) << "\"}";
-            Transaction tx(username, TransactionType::POST, txData.str());
+            std::string txData;
+            JsonWriter txWriter(txData);
+            txWriter.beginObject()
+                    .field("action", "post")
+                    .field("postId", InputValidator::sanitize(postId))
+                    .field("author", InputValidator::sanitize(username))
+                    .endObject();
+            Transaction tx(username, TransactionType::POST, txData);
             blockchain->addTransaction(tx);  // Will auto-mine when 5 txs accumulated
 
             // Return created post (201 Created)
             res.statusCode = 201;
-            res.json(post.toJson());
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            post.writeJson(writer);
+        }));
 
         /**
          * ENDPOINT: GET /api/posts
-         * PURPOSE: Retrieve all posts (feed)
+         * PURPOSE: Retrieve one page of the feed, newest first
          * AUTH: None (public)
          * 
-         * RETURNS: JSON array of all posts
-         * OPTIMIZATION: Uses lightweight toJson() (counts only, not full comments)
+         * QUERY PARAMETERS:
+         * - limit: Posts per page (default 50, max 200)
+         * - cursor: X-Next-Cursor value from the previous page
+         * - fields: Subset of post fields (PostFields), pushed down as a
+         *           MongoDB projection, e.g. fields=id,author,preview,likes
+         * 
+         * RETURNS: JSON array of posts
+         * HEADERS: X-Next-Cursor + Link rel="next" when more posts exist
+         * 
+         * OPTIMIZATION:
+         * - Keyset pagination (MongoClient::getPostsPage): O(page), not O(all posts)
+         * - Lightweight writeJson() (counts only, not full comments),
+         *   streamed into the response body with one JsonWriter
+         * - Identical concurrent requests share one fetch, and the page is
+         *   reused for BITEA_READ_CACHE_MS (onStorageCoalesced)
          */
-        server->get("/api/posts", [this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
-            // Fetch all posts from database
-            auto posts = mongodb->getAllPosts();
+        server->getAsync("/api/posts", onStorageCoalesced([this](const HttpRequest& req, HttpResponse& res) {
+            size_t limit;
+            FeedCursor cursor;
+            uint32_t fields;
+            if (!parsePageParams(req, res, limit, cursor)) return;
+            if (!parseFields(req, res, fields)) return;
             
-            // Build JSON array
-            std::stringstream ss;
-            ss << "[";
-            for (size_t i = 0; i < posts.size(); i++) {
-                ss << posts[i].toJson();  // Lightweight version (counts only)
-                if (i < posts.size() - 1) ss << ",";
+            FeedPage page;
+            if (!mongodb->getPostsPage(cursor, limit, page, fields)) {
+                res.statusCode = 500;
+                res.json("{\"error\":\"Failed to load posts\"}");
+                return;
             }
-            ss << "]";
             
-            res.json(ss.str());
-        });
+            if (!page.nextCursor.empty()) {
+                res.headers["X-Next-Cursor"] = page.nextCursor;
+                res.headers["Link"] = nextPageLink(req, page.nextCursor);
+            }
+            res.headers["Access-Control-Expose-Headers"] = "X-Next-Cursor, Link";
+            
+            // Serialize the array straight into the response body
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.reserve(page.posts.size() * 256).beginArray();
+            for (const auto& post : page.posts) {
+                post.writeJson(writer, fields);  // Lightweight version (counts only)
+            }
+            writer.endArray();
+        }));
+
+        /**
+         * ENDPOINT: GET /api/posts/changes
+         * PURPOSE: Delta sync - posts created or modified since a version
+         * AUTH: None (public)
+         * 
+         * QUERY PARAMETERS:
+         * - since: "version" from the previous response (default 0 = everything)
+         * - limit: Changes per response (default 50, max 200)
+         * - fields: As for GET /api/posts
+         * 
+         * RETURNS: {"version":N,"hasMore":bool,"posts":[...]}
+         * Posts are in change order, each at most once (latest state).
+         * Call again with since=version while hasMore is true.
+         * 
+         * ROUTE ORDER: Registered before /api/posts/:id, which would
+         * otherwise match "changes" as a post ID
+         * 
+         * COST: Proportional to the number of changes, not to the feed size
+         */
+        server->getAsync("/api/posts/changes", onStorage([this](const HttpRequest& req, HttpResponse& res) {
+            uint64_t since = 0;
+            size_t limit;
+            uint32_t fields;
+            if (!parseQueryNumber(req, res, "since", since)) return;
+            if (!parseLimit(req, res, limit)) return;
+            if (!parseFields(req, res, fields)) return;
+            
+            FeedChanges changes;
+            if (!mongodb->getPostChanges(since, limit, changes, fields)) {
+                res.statusCode = 500;
+                res.json("{\"error\":\"Failed to load changes\"}");
+                return;
+            }
+            
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.reserve(changes.posts.size() * 256)
+                  .beginObject()
+                  .field("version", changes.version)
+                  .field("hasMore", changes.hasMore)
+                  .key("posts").beginArray();
+            for (const auto& post : changes.posts) {
+                post.writeJson(writer, fields);
+            }
+            writer.endArray().endObject();
+        }));
 
         /**
          * ENDPOINT: GET /api/posts/:id
@@ -818,8 +1506,11 @@ public:
          * 
          * PATH PARAMETER: id = post ID
          * RETURNS: Detailed post JSON (includes full comment array)
+         * 
+         * COALESCED: A burst of reads of one (viral) post costs one lookup
+         * and one serialization (onStorageCoalesced)
          */
-        server->get("/api/posts/:id", [this](const HttpRequest& req, HttpResponse& res) {
+        server->getAsync("/api/posts/:id", onStorageCoalesced([this](const HttpRequest& req, HttpResponse& res) {
             std::string postId = req.params.at("id");  // Extract :id parameter
             
             Post post;
@@ -829,8 +1520,9 @@ public:
                 return;
             }
 
-            res.json(post.toDetailedJson());  // Full details (including comments)
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            post.writeDetailedJson(writer);  // Full details (including comments)
+        }));
 
         /**
          * ENDPOINT: POST /api/posts/:id/like
@@ -846,7 +1538,7 @@ public:
          * 
          * IDEMPOTENT: Liking twice has no effect (set ensures uniqueness)
          */
-        server->post("/api/posts/:id/like", [this](const HttpRequest& req, HttpResponse& res) {
+        server->postAsync("/api/posts/:id/like", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             // Authenticate user
             std::string username;
             if (!validateSession(req, username)) {
@@ -869,16 +1561,19 @@ public:
             // Add like to post (set prevents duplicates)
             post.addLike(username);
             mongodb->updatePost(post);  // Update in database
+            readCache.invalidate();
 
             // Record like on blockchain
-            std::stringstream txData;
-            txData << "{\"action\":\"like\",\"postId\":\"" << postId << "\"}";
-            Transaction tx(username, TransactionType::LIKE, txData.str());
+            std::string txData;
+            JsonWriter txWriter(txData);
+            txWriter.beginObject().field("action", "like").field("postId", postId).endObject();
+            Transaction tx(username, TransactionType::LIKE, txData);
             blockchain->addTransaction(tx);
 
             // Return updated post
-            res.json(post.toJson());
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            post.writeJson(writer);
+        }));
 
         /**
          * ENDPOINT: POST /api/posts/:id/comment
@@ -889,7 +1584,7 @@ public:
          * VALIDATION: Content 1-1000 chars
          * STORAGE: Comment added to post's comment vector + blockchain
          */
-        server->post("/api/posts/:id/comment", [this](const HttpRequest& req, HttpResponse& res) {
+        server->postAsync("/api/posts/:id/comment", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             std::string username;
             if (!validateSession(req, username)) {
                 res.statusCode = 401;
@@ -899,7 +1594,9 @@ public:
 
             // Extract comment content
             std::string postId = req.params.at("id");
-            std::string content = InputValidator::trimWhitespace(getJsonValue(req.body, "content"));
+            JsonDocument body;
+            if (!parseJsonBody(req, res, body)) return;
+            std::string content = InputValidator::trimWhitespace(field(body, "content"));
 
             // Validate comment (1-1000 chars, shorter than posts)
             if (content.empty() || content.length() > 1000) {
@@ -922,16 +1619,22 @@ public:
             // Add comment to post
             post.addComment(username, content);
             mongodb->updatePost(post);
+            readCache.invalidate();
 
             // Record comment on blockchain
-            std::stringstream txData;
-            txData << "{\"action\":\"comment\",\"postId\":\"" << InputValidator::sanitize(postId) << "\"}";
-            Transaction tx(username, TransactionType::COMMENT, txData.str());
+            std::string txData;
+            JsonWriter txWriter(txData);
+            txWriter.beginObject()
+                    .field("action", "comment")
+                    .field("postId", InputValidator::sanitize(postId))
+                    .endObject();
+            Transaction tx(username, TransactionType::COMMENT, txData);
             blockchain->addTransaction(tx);
 
             // Return updated post with all comments
-            res.json(post.toDetailedJson());
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            post.writeDetailedJson(writer);
+        }));
 
         // ====================================================================
         // USER ENDPOINTS (Profiles and Social)
@@ -944,7 +1647,7 @@ public:
          * 
          * RETURNS: Public user data (no email, no private info)
          */
-        server->get("/api/users/:username", [this](const HttpRequest& req, HttpResponse& res) {
+        server->getAsync("/api/users/:username", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             std::string username = req.params.at("username");
             
             User user;
@@ -954,8 +1657,9 @@ public:
                 return;
             }
 
-            res.json(user.toJson(false));  // Public data only
-        });
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            user.writeJson(writer, false);  // Public data only
+        }));
 
         /**
          * ENDPOINT: POST /api/users/:username/follow
@@ -969,7 +1673,7 @@ public:
          * 
          * BLOCKCHAIN: Records FOLLOW transaction
          */
-        server->post("/api/users/:username/follow", [this](const HttpRequest& req, HttpResponse& res) {
+        server->postAsync("/api/users/:username/follow", onStorage([this](const HttpRequest& req, HttpResponse& res) {
             std::string currentUser;
             if (!validateSession(req, currentUser)) {
                 res.statusCode = 401;
@@ -997,13 +1701,14 @@ public:
             mongodb->updateUser(targetUser);
 
             // Record follow action on blockchain
-            std::stringstream txData;
-            txData << "{\"action\":\"follow\",\"target\":\"" << targetUsername << "\"}";
-            Transaction tx(currentUser, TransactionType::FOLLOW, txData.str());
+            std::string txData;
+            JsonWriter txWriter(txData);
+            txWriter.beginObject().field("action", "follow").field("target", targetUsername).endObject();
+            Transaction tx(currentUser, TransactionType::FOLLOW, txData);
             blockchain->addTransaction(tx);
 
             res.json("{\"message\":\"Followed successfully\"}");
-        });
+        }));
 
         // ====================================================================
         // BLOCKCHAIN ENDPOINTS (Inspection and Management)
@@ -1029,24 +1734,20 @@ public:
             const auto& chain = blockchain->getChain();
             
             // Build JSON array of blocks
-            std::stringstream ss;
-            ss << "{\"blocks\":[";
-            for (size_t i = 0; i < chain.size(); i++) {
-                const auto& block = chain[i];
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.beginObject().key("blocks").beginArray();
+            for (const auto& block : chain) {
                 // Serialize block metadata (not full transaction details)
-                ss << "{";
-                ss << "\"index\":" << block->getIndex() << ",";
-                ss << "\"hash\":\"" << block->getHash() << "\",";
-                ss << "\"previousHash\":\"" << block->getPreviousHash() << "\",";
-                ss << "\"timestamp\":" << block->getTimestamp() << ",";
-                ss << "\"nonce\":" << block->getNonce() << ",";
-                ss << "\"transactions\":" << block->getTransactions().size();
-                ss << "}";
-                if (i < chain.size() - 1) ss << ",";
+                writer.beginObject()
+                      .field("index", block->getIndex())
+                      .field("hash", block->getHash())
+                      .field("previousHash", block->getPreviousHash())
+                      .field("timestamp", block->getTimestamp())
+                      .field("nonce", block->getNonce())
+                      .field("transactions", block->getTransactions().size())
+                      .endObject();
             }
-            ss << "]}";
-            
-            res.json(ss.str());
+            writer.endArray().endObject();
         });
 
         /**
@@ -1068,9 +1769,8 @@ public:
          */
         server->get("/api/blockchain/validate", [this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
             bool valid = blockchain->isChainValid();
-            std::stringstream ss;
-            ss << "{\"valid\":" << (valid ? "true" : "false") << "}";
-            res.json(ss.str());
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.beginObject().field("valid", valid).endObject();
         });
 
         /**
@@ -1093,17 +1793,190 @@ public:
          * May take seconds depending on difficulty (3 in this app)
          * Request blocks until mining complete
          */
-        server->get("/api/mine", [this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
+        server->getAsync("/api/mine", onStorage([this]([[maybe_unused]] const HttpRequest& req, HttpResponse& res) {
             // Mine all pending transactions into a block
             blockchain->minePendingTransactionsPublic();
             
             // Return mining result
-            std::stringstream ss;
-            ss << "{\"message\":\"Block mined successfully\",";
-            ss << "\"blocks\":" << blockchain->getChainLength() << ",";
-            ss << "\"pending\":" << blockchain->getPendingTransactionCount() << "}";
-            res.json(ss.str());
+            JsonWriter writer(res.jsonBuffer(), res.format);
+            writer.beginObject()
+                  .field("message", "Block mined successfully")
+                  .field("blocks", blockchain->getChainLength())
+                  .field("pending", blockchain->getPendingTransactionCount())
+                  .endObject();
+        }));
+
+        // ====================================================================
+        // BATCH ENDPOINT
+        // ====================================================================
+
+        /**
+         * ENDPOINT: POST /api/batch
+         * PURPOSE: Several API calls in one HTTP exchange (e.g. a feed page
+         *          plus the profile of each author)
+         * AUTH: Per sub-request; the batch's Authorization header is passed
+         *       on unless an entry sets its own
+         * 
+         * REQUEST BODY:
+         * {"requests":[
+         *   {"method":"GET","path":"/api/posts?limit=20"},
+         *   {"method":"GET","path":"/api/users/alice"},
+         *   {"method":"POST","path":"/api/posts","body":{"content":"Hi"}}
+         * ]}
+         * - 1 to BATCH_MAX_REQUESTS entries; /api/batch cannot be nested
+         * - headers (optional): string values, override inherited ones
+         * - body (optional): object/array sent as its JSON text, string as-is
+         * 
+         * EXECUTION: Every entry goes through the normal route table and
+         * handlers (HttpServer::dispatchAsync). Consecutive GETs run in
+         * parallel, other methods one at a time in order (runBatchStage).
+         * 
+         * RETURNS: 200 {"responses":[{"status":200,"headers":{},"body":...}]}
+         * in request order and in the batch's negotiated encoding; each
+         * entry carries its own status. 400 if the batch itself is malformed
+         * (nothing is executed then).
+         * 
+         * Not wrapped in onStorage: this handler only parses and fans out,
+         * the sub-requests use their routes' executors.
+         */
+        server->postAsync("/api/batch", [this](std::shared_ptr<AsyncContext> ctx) {
+            HttpResponse& res = ctx->response;
+            JsonDocument body;
+            if (!parseJsonBody(ctx->request, res, body)) {
+                ctx->complete();
+                return;
+            }
+
+            JsonDocument entries;
+            const JsonField* requests = body.find("requests");
+            if (!requests || requests->type != JsonType::ARRAY || !entries.parseArray(requests->value) ||
+                entries.size() == 0 || entries.size() > BATCH_MAX_REQUESTS) {
+                res.statusCode = 400;
+                res.json("{\"error\":\"requests must be an array of 1 to " +
+                         std::to_string(BATCH_MAX_REQUESTS) + " entries\"}");
+                ctx->complete();
+                return;
+            }
+
+            auto run = std::make_shared<BatchRun>();
+            run->requests.resize(entries.size());
+            run->responses.resize(entries.size());
+            for (size_t i = 0; i < entries.size(); i++) {
+                std::string error;
+                if (!parseBatchEntry(entries.field(i).value, ctx->request, run->requests[i], error)) {
+                    res.statusCode = 400;
+                    res.json("{\"error\":\"requests[" + std::to_string(i) + "]: " + error + "\"}");
+                    ctx->complete();
+                    return;
+                }
+            }
+            run->ctx = std::move(ctx);
+            runBatchStage(run);
         });
+
+        // ====================================================================
+        // LOAD-SHEDDING CLASSES
+        // ====================================================================
+
+        // GET defaults to READ and POST to WRITE; under overload the explorer
+        // is shed first and authentication is kept ahead of ordinary reads
+        server->setRequestClass("/api/blockchain", RequestClass::EXPLORER);
+        server->setRequestClass("/api/blockchain/validate", RequestClass::EXPLORER);
+        server->setRequestClass("/api/register", RequestClass::AUTH);
+        server->setRequestClass("/api/login", RequestClass::AUTH);
+        server->setRequestClass("/api/logout", RequestClass::AUTH);
+        server->setRequestClass("/api/mine", RequestClass::WRITE);
+    }
+
+    /**
+     * @brief Registers application gauges for GET /metrics
+     * 
+     * All values are read at scrape time; nothing here runs per request.
+     * Route and storage latency series are created lazily by HttpServer and
+     * the database clients.
+     */
+    void registerMetrics() {
+        server->registerMetrics();
+
+        Metrics& metrics = Metrics::instance();
+        metrics.describe("bitea_storage_queue_depth", MetricType::GAUGE,
+                         "Async handlers waiting for a storage thread");
+        metrics.callback("bitea_storage_queue_depth", "",
+                         [this] { return static_cast<double>(storageExecutor->queueDepth()); });
+        metrics.describe("bitea_storage_workers_busy", MetricType::GAUGE,
+                         "Storage threads currently running a handler");
+        metrics.callback("bitea_storage_workers_busy", "",
+                         [this] { return static_cast<double>(storageExecutor->activeCount()); });
+        metrics.describe("bitea_storage_shed_total", MetricType::COUNTER,
+                         "Async requests rejected with 503 by storage-queue load shedding");
+        for (size_t i = 0; i < REQUEST_CLASS_COUNT; i++) {
+            RequestClass cls = static_cast<RequestClass>(i);
+            metrics.callback("bitea_storage_shed_total", std::string("class=\"") + requestClassName(cls) + "\"",
+                             [this, cls] { return static_cast<double>(storageAdmission.shedCount(cls)); });
+        }
+
+        metrics.describe("bitea_mongodb_pool_clients", MetricType::GAUGE,
+                         "MongoDB clients checked out of the pool (state=in_use) and its size limit (state=max)");
+        metrics.callback("bitea_mongodb_pool_clients", "state=\"in_use\"",
+                         [this] { return static_cast<double>(mongodb->getLeasedClients()); });
+        metrics.callback("bitea_mongodb_pool_clients", "state=\"max\"",
+                         [this] { return static_cast<double>(mongodb->getMaxPoolSize()); });
+        metrics.describe("bitea_redis_pool_connections", MetricType::GAUGE,
+                         "Redis connections checked out (state=in_use), open and idle (state=idle), and the pool limit (state=max)");
+        metrics.callback("bitea_redis_pool_connections", "state=\"in_use\"",
+                         [this] { return static_cast<double>(redis->getLeasedContexts()); });
+        metrics.callback("bitea_redis_pool_connections", "state=\"idle\"",
+                         [this] { return static_cast<double>(redis->getIdleContexts()); });
+        metrics.callback("bitea_redis_pool_connections", "state=\"max\"",
+                         [this] { return static_cast<double>(redis->getPoolSize()); });
+        metrics.describe("bitea_session_token_checks_total", MetricType::COUNTER,
+                         "Signed session token checks by result (valid signature and expiry, invalid, revoked)");
+        metrics.callback("bitea_session_token_checks_total", "result=\"valid\"",
+                         [this] { return static_cast<double>(tokenSigner.acceptedCount()); });
+        metrics.callback("bitea_session_token_checks_total", "result=\"invalid\"",
+                         [this] { return static_cast<double>(tokenSigner.rejectedCount()); });
+        metrics.callback("bitea_session_token_checks_total", "result=\"revoked\"",
+                         [this] { return static_cast<double>(revokedTokens.hitCount()); });
+        metrics.describe("bitea_revoked_tokens", MetricType::GAUGE,
+                         "Unexpired signed session tokens in this process's revocation set");
+        metrics.callback("bitea_revoked_tokens", "",
+                         [this] { return static_cast<double>(revokedTokens.size()); });
+        metrics.describe("bitea_token_revocations_failed_total", MetricType::COUNTER,
+                         "Logouts whose signed token could not be added to the shared Redis revocation set");
+        metrics.callback("bitea_token_revocations_failed_total", "",
+                         [this] { return static_cast<double>(revocationsFailed.load(std::memory_order_relaxed)); });
+        metrics.describe("bitea_session_refresh_total", MetricType::COUNTER,
+                         "Session TTL refreshes by result (skipped: TTL still fresh, queued, coalesced onto a queued one, written, failed)");
+        metrics.callback("bitea_session_refresh_total", "result=\"skipped\"",
+                         [this] { return static_cast<double>(redis->getTouchesSkipped()); });
+        metrics.callback("bitea_session_refresh_total", "result=\"queued\"",
+                         [this] { return static_cast<double>(redis->getTouchesQueued()); });
+        metrics.callback("bitea_session_refresh_total", "result=\"coalesced\"",
+                         [this] { return static_cast<double>(redis->getTouchesCoalesced()); });
+        metrics.callback("bitea_session_refresh_total", "result=\"written\"",
+                         [this] { return static_cast<double>(redis->getTouchesWritten()); });
+        metrics.callback("bitea_session_refresh_total", "result=\"failed\"",
+                         [this] { return static_cast<double>(redis->getTouchesFailed()); });
+
+        metrics.describe("bitea_read_cache_requests_total", MetricType::COUNTER,
+                         "Coalesced post reads by result (hit, coalesced onto a running fetch, miss)");
+        metrics.callback("bitea_read_cache_requests_total", "result=\"hit\"",
+                         [this] { return static_cast<double>(readCache.hitCount()); });
+        metrics.callback("bitea_read_cache_requests_total", "result=\"coalesced\"",
+                         [this] { return static_cast<double>(readCache.coalescedCount()); });
+        metrics.callback("bitea_read_cache_requests_total", "result=\"miss\"",
+                         [this] { return static_cast<double>(readCache.missCount()); });
+
+        metrics.describe("bitea_blockchain_height", MetricType::GAUGE, "Blocks in the chain, genesis included");
+        metrics.callback("bitea_blockchain_height", "",
+                         [this] { return static_cast<double>(blockchain->getChainLength()); });
+        metrics.describe("bitea_mempool_size", MetricType::GAUGE, "Pending transactions waiting to be mined");
+        metrics.callback("bitea_mempool_size", "",
+                         [this] { return static_cast<double>(blockchain->getPendingTransactionCount()); });
+        metrics.describe("bitea_log_dropped_total", MetricType::COUNTER,
+                         "Log lines dropped because a thread's ring buffer was full");
+        metrics.callback("bitea_log_dropped_total", "",
+                         [] { return static_cast<double>(Logger::instance().getDroppedCount()); });
     }
 
     // ========================================================================
@@ -1116,11 +1989,15 @@ public:
      * PURPOSE: Main application entry point
      * 
      * STARTUP SEQUENCE:
+     * 0. Apply BITEA_LOG_LEVEL (debug|info|warn|error|off, default info),
+     *    BITEA_SLOW_REQUEST_MS (default 250), BITEA_TRACE_SAMPLE (default 100)
+     *    and BITEA_LOCK_PROFILE (default 1)
      * 1. Connect to MongoDB (users, posts)
      * 2. Connect to Redis (sessions)
      * 3. Display blockchain info (genesis block)
-     * 4. Setup all API routes
-     * 5. Start HTTP server (blocking)
+     * 4. Setup all API routes and /metrics gauges
+     * 5. Enable traffic capture if BITEA_CAPTURE_FILE is set
+     * 6. Start HTTP server (blocking)
      * 
      * ERROR HANDLING:
      * - MongoDB connection failure: Exit
@@ -1136,24 +2013,101 @@ public:
         std::cout << "=== Bitea Social Media Blockchain ===" << std::endl;
         std::cout << "Initializing..." << std::endl;
 
+        // Log verbosity (per-operation storage messages are DEBUG)
+        Logger::instance().setLevel(Logger::parseLevel(std::getenv("BITEA_LOG_LEVEL")));
+
+        // Slow-request log threshold and trace sampling (utils/Trace.h)
+        if (const char* slowMs = std::getenv("BITEA_SLOW_REQUEST_MS")) {
+            Tracer::instance().setSlowThresholdMillis(std::strtoull(slowMs, nullptr, 10));
+        }
+        if (const char* sample = std::getenv("BITEA_TRACE_SAMPLE")) {
+            Tracer::instance().setSampleEvery(static_cast<uint32_t>(std::strtoul(sample, nullptr, 10)));
+        }
+
+        // Post read cache lifetime in milliseconds (0 = coalescing only)
+        if (const char* cacheMs = std::getenv("BITEA_READ_CACHE_MS")) {
+            readCache.setTtl(std::chrono::milliseconds(std::strtoull(cacheMs, nullptr, 10)));
+        }
+
+        // Lock contention statistics (on unless BITEA_LOCK_PROFILE=0)
+        if (const char* lockProfile = std::getenv("BITEA_LOCK_PROFILE")) {
+            ProfiledMutex::setProfilingEnabled(std::string(lockProfile) != "0");
+        }
+
+        // MongoDB client pool bounds (defaults: 2-16 clients)
+        size_t poolMin = MongoClient::DEFAULT_MIN_POOL_SIZE;
+        size_t poolMax = MongoClient::DEFAULT_MAX_POOL_SIZE;
+        if (const char* value = std::getenv("BITEA_MONGO_POOL_MIN")) poolMin = std::strtoull(value, nullptr, 10);
+        if (const char* value = std::getenv("BITEA_MONGO_POOL_MAX")) poolMax = std::strtoull(value, nullptr, 10);
+        mongodb->setPoolSize(poolMin, poolMax);
+
+        // Redis connection pool bound (default: 8 connections)
+        if (const char* value = std::getenv("BITEA_REDIS_POOL_SIZE")) {
+            redis->setPoolSize(std::strtoull(value, nullptr, 10));
+        }
+
+        // Lazy session refresh: slide a session's TTL only once less than
+        // this fraction of its lifetime remains, in batches (default 0.5, 1000ms)
+        double refreshFraction = RedisClient::DEFAULT_REFRESH_FRACTION;
+        std::chrono::milliseconds touchFlush = RedisClient::DEFAULT_TOUCH_FLUSH_INTERVAL;
+        if (const char* value = std::getenv("BITEA_SESSION_REFRESH_FRACTION")) refreshFraction = std::strtod(value, nullptr);
+        if (const char* value = std::getenv("BITEA_SESSION_TOUCH_FLUSH_MS")) {
+            touchFlush = std::chrono::milliseconds(std::strtoull(value, nullptr, 10));
+        }
+        redis->setSessionRefresh(refreshFraction, touchFlush);
+
         // Connect to MongoDB (primary data storage)
         if (!mongodb->connect()) {
-            std::cerr << "Failed to connect to MongoDB" << std::endl;
+            BITEA_LOG_ERROR("Bitea", "Failed to connect to MongoDB");
             return;  // Cannot proceed without database
         }
 
         // Connect to Redis (session storage)
         if (!redis->connect()) {
-            std::cerr << "Failed to connect to Redis" << std::endl;
+            BITEA_LOG_ERROR("Bitea", "Failed to connect to Redis");
             return;  // Cannot proceed without session store
         }
 
+        // Optional signed session tokens: load keys, then the shared revocation set
+        if (const char* keySpec = std::getenv("BITEA_TOKEN_KEYS")) {
+            std::string error;
+            if (!tokenSigner.configure(keySpec, error)) {
+                BITEA_LOG_ERROR("Bitea", "Invalid BITEA_TOKEN_KEYS: %s", error.c_str());
+                return;  // Refuse to start rather than fall back silently
+            }
+            if (const char* value = std::getenv("BITEA_TOKEN_TTL_SECONDS")) {
+                long long ttl = std::strtoll(value, nullptr, 10);
+                if (ttl > 0) tokenLifetimeSeconds = ttl;
+            }
+            std::chrono::milliseconds syncInterval(1000);
+            if (const char* value = std::getenv("BITEA_TOKEN_REVOCATION_SYNC_MS")) {
+                unsigned long long ms = std::strtoull(value, nullptr, 10);
+                if (ms > 0) syncInterval = std::chrono::milliseconds(ms);
+            }
+
+            auto loadRevoked = [this](int64_t now, RevokedTokens::Entries& out) {
+                return redis->loadRevokedTokens(now, out);
+            };
+            RevokedTokens::Entries revoked;
+            int64_t now = static_cast<int64_t>(std::time(nullptr));
+            if (loadRevoked(now, revoked)) revokedTokens.merge(revoked, now);
+            revokedTokens.startSync(loadRevoked, syncInterval);
+            BITEA_LOG_INFO("Bitea", "Signed session tokens on (signing key '%s', %zu key(s), %zu revoked)",
+                           tokenSigner.activeKeyId().c_str(), tokenSigner.keyCount(), revokedTokens.size());
+        }
+
         // Display blockchain status (genesis block already created in constructor)
         std::cout << "Blockchain initialized with genesis block" << std::endl;
         std::cout << blockchain->getChainInfo() << std::endl;
 
-        // Register all API routes
+        // Register all API routes and metric gauges
         setupRoutes();
+        registerMetrics();
+
+        // Optional traffic capture for offline replay (tools/replay)
+        if (const char* capturePath = std::getenv("BITEA_CAPTURE_FILE")) {
+            server->enableCapture(capturePath);
+        }
 
         // Start HTTP server (BLOCKING - runs until stopped)
         server->start();
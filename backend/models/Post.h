@@ -51,11 +51,15 @@
 // STANDARD LIBRARY INCLUDES
 // ============================================================================
 
+#include <cstdint>     // uint32_t - PostFields mask
 #include <string>      // std::string - text content, IDs, usernames
+#include <string_view> // std::string_view - ?fields= parsing, content preview
+#include <utility>     // std::pair - field name table
 #include <vector>      // std::vector<Comment> - ordered list of comments
 #include <set>         // std::set<std::string> - unique collection of user likes
 #include <ctime>       // time_t, std::time() - timestamp generation
-#include <sstream>     // std::stringstream - JSON serialization
+
+#include "../utils/JsonWriter.h"  // JsonWriter - JSON serialization
 
 // ============================================================================
 // COMMENT STRUCT DEFINITION
@@ -157,8 +161,8 @@ struct Comment {
     }
 
     /**
-     * @brief Serializes comment to JSON format
-     * @return std::string - JSON representation of comment
+     * @brief Appends the comment as a JSON object
+     * @param writer Destination (usually writing into a response body)
      * 
      * PURPOSE: API responses, database storage, frontend display
      * 
@@ -166,59 +170,106 @@ struct Comment {
      * {"id":"alice-1698765432","author":"alice","content":"Great post!","timestamp":1698765432}
      * 
      * CONTENT ESCAPING:
-     * Special characters in content are escaped for valid JSON
-     * Prevents JSON injection attacks
+     * JsonWriter escapes quotes, backslashes and control characters in
+     * every string, so content cannot break out of its JSON string
      * 
      * WHY const: Read-only operation, doesn't modify comment
      */
+    void writeJson(JsonWriter& writer) const {
+        writer.beginObject()
+              .field("id", id)
+              .field("author", author)
+              .field("content", content)
+              .field("timestamp", timestamp)
+              .endObject();
+    }
+
+    /**
+     * @brief Serializes comment to a standalone JSON string
+     * @return std::string - JSON representation of comment
+     */
     std::string toJson() const {
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"id\":\"" << id << "\",";
-        ss << "\"author\":\"" << author << "\",";
-        ss << "\"content\":\"" << escapeJson(content) << "\",";  // Escape special chars
-        ss << "\"timestamp\":" << timestamp;
-        ss << "}";
-        return ss.str();
+        std::string out;
+        JsonWriter writer(out);
+        writeJson(writer);
+        return out;
     }
+};
+
+// ============================================================================
+// FIELD PROJECTION
+// ============================================================================
+
+/**
+ * @struct PostFields
+ * @brief Bit mask of post summary fields a client asked for (?fields=)
+ * 
+ * PURPOSE: Feed views only need a few fields; the mask is pushed down to
+ * MongoDB as a projection and tells Post::writeJson() which keys to emit
+ * 
+ * NAMES (comma separated in ?fields=):
+ * id, author, content, preview, timestamp, likes, comments, isOnChain
+ * (isOnChain also covers blockchainHash)
+ * 
+ * "preview" is the first PREVIEW_LENGTH code points of the content,
+ * emitted under the "preview" key
+ */
+struct PostFields {
+    static constexpr uint32_t ID        = 1u << 0;
+    static constexpr uint32_t AUTHOR    = 1u << 1;
+    static constexpr uint32_t CONTENT   = 1u << 2;
+    static constexpr uint32_t PREVIEW   = 1u << 3;
+    static constexpr uint32_t TIMESTAMP = 1u << 4;
+    static constexpr uint32_t LIKES     = 1u << 5;
+    static constexpr uint32_t COMMENTS  = 1u << 6;
+    static constexpr uint32_t ON_CHAIN  = 1u << 7;
+
+    // Default summary (everything except the preview)
+    static constexpr uint32_t SUMMARY = ID | AUTHOR | CONTENT | TIMESTAMP | LIKES | COMMENTS | ON_CHAIN;
+
+    static constexpr size_t PREVIEW_LENGTH = 120;  // Code points
 
-private:
     /**
-     * @brief Escapes special characters for valid JSON strings
-     * @param str String to escape
-     * @return std::string - Escaped string safe for JSON
-     * 
-     * PURPOSE: Prevents JSON syntax errors and injection attacks
-     * 
-     * ESCAPES:
-     * " → \" (quotes must be escaped in JSON strings)
-     * \ → \\ (backslash must be escaped)
-     * \n → \\n (newline as escape sequence)
-     * \r → \\r (carriage return)
-     * \t → \\t (tab)
-     * 
-     * SECURITY:
-     * Without escaping: {"content":"User said "hello""} → Invalid JSON
-     * With escaping: {"content":"User said \"hello\""} → Valid JSON
-     * 
-     * EFFICIENCY: O(n) where n = string length
-     * Single pass through string
+     * @brief Parses "id,author,preview" into a mask
+     * @return false on an empty list or unknown name (caller answers 400)
      */
-    std::string escapeJson(const std::string& str) const {
-        std::string result;
-        // Reserve approximate space (optimization for large strings)
-        // result.reserve(str.size() * 1.1);  // Could add this
-        
-        for (char c : str) {
-            // Escape special JSON characters
-            if (c == '"') result += "\\\"";       // Quote
-            else if (c == '\\') result += "\\\\"; // Backslash
-            else if (c == '\n') result += "\\n";  // Newline
-            else if (c == '\r') result += "\\r";  // Carriage return
-            else if (c == '\t') result += "\\t";  // Tab
-            else result += c;                     // Regular character
+    static bool parse(std::string_view list, uint32_t& mask) {
+        static const std::pair<std::string_view, uint32_t> NAMES[] = {
+            {"id", ID}, {"author", AUTHOR}, {"content", CONTENT}, {"preview", PREVIEW},
+            {"timestamp", TIMESTAMP}, {"likes", LIKES}, {"comments", COMMENTS},
+            {"isOnChain", ON_CHAIN}};
+        mask = 0;
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            std::string_view name = list.substr(0, comma);
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+            if (name.empty()) continue;
+            bool known = false;
+            for (const auto& entry : NAMES) {
+                if (entry.first == name) {
+                    mask |= entry.second;
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) return false;
         }
-        return result;
+        return mask != 0;
+    }
+
+    /**
+     * @brief First PREVIEW_LENGTH code points of a UTF-8 string
+     * Cuts on a character boundary (same unit as MongoDB $substrCP)
+     */
+    static std::string_view preview(std::string_view text) {
+        size_t points = 0;
+        for (size_t i = 0; i < text.size(); i++) {
+            // Continuation bytes (10xxxxxx) do not start a code point
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80 && points++ == PREVIEW_LENGTH) {
+                return text.substr(0, i);
+            }
+        }
+        return text;
     }
 };
 
@@ -303,7 +354,7 @@ private:
      * Could extend: Markdown, HTML (sanitized), @ mentions, # hashtags
      * 
      * SANITIZATION:
-     * Escaped in toJson() to prevent JSON injection
+     * Escaped by JsonWriter in writeJson() to prevent JSON injection
      * Should also sanitize for XSS prevention in frontend
      */
     std::string content;
@@ -434,27 +485,6 @@ private:
      */
     bool isOnChain;
 
-    /**
-     * @brief Escapes special characters for valid JSON strings (same as Comment)
-     * @param str String to escape
-     * @return std::string - Escaped string safe for JSON
-     * 
-     * PURPOSE: Prevents JSON syntax errors in post content
-     * SEE: Comment::escapeJson() for detailed documentation
-     */
-    std::string escapeJson(const std::string& str) const {
-        std::string result;
-        for (char c : str) {
-            if (c == '"') result += "\\\"";
-            else if (c == '\\') result += "\\\\";
-            else if (c == '\n') result += "\\n";
-            else if (c == '\r') result += "\\r";
-            else if (c == '\t') result += "\\t";
-            else result += c;
-        }
-        return result;
-    }
-
     // ========================================================================
     // PUBLIC INTERFACE (Constructors and Methods)
     // ========================================================================
@@ -553,6 +583,17 @@ public:
         isOnChain = true;  // Automatically mark as on-chain
     }
 
+    /**
+     * @brief Restores the creation time of a post loaded from storage
+     * @param ts Unix timestamp stored with the post
+     * 
+     * CALLED BY: MongoClient::bsonToPost() - the constructor stamps the
+     * current time, which would break feed ordering and cursors
+     */
+    void setTimestamp(time_t ts) {
+        timestamp = ts;
+    }
+
     // ========================================================================
     // SOCIAL INTERACTION METHODS (Likes)
     // ========================================================================
@@ -655,8 +696,8 @@ public:
     // ========================================================================
     
     /**
-     * @brief Serializes post to compact JSON format (summary)
-     * @return std::string - JSON representation without full comment details
+     * @brief Appends the post as compact JSON (summary)
+     * @param writer Destination (e.g. a feed array in the response body)
      * 
      * PURPOSE: Lightweight JSON for lists/feeds (reduces bandwidth)
      * 
@@ -681,31 +722,44 @@ public:
      * Only included if post is on blockchain (conditional field)
      * Avoids empty string in JSON
      * 
+     * PROJECTION (?fields=):
+     * Keys not in the PostFields mask are skipped; key order is unchanged
+     * 
      * ALTERNATIVE: toDetailedJson() includes full comment array
      */
-    std::string toJson() const {
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"id\":\"" << id << "\",";
-        ss << "\"author\":\"" << author << "\",";
-        ss << "\"content\":\"" << escapeJson(content) << "\",";  // Escape for safety
-        ss << "\"timestamp\":" << timestamp << ",";
-        ss << "\"likes\":" << likes.size() << ",";              // Count only
-        ss << "\"comments\":" << comments.size() << ",";        // Count only
-        ss << "\"isOnChain\":" << (isOnChain ? "true" : "false");
-        
-        // Conditionally include blockchain hash (only if on chain)
-        if (!blockchainHash.empty()) {
-            ss << ",\"blockchainHash\":\"" << blockchainHash << "\"";
+    void writeJson(JsonWriter& writer, uint32_t fields = PostFields::SUMMARY) const {
+        writer.beginObject();
+        if (fields & PostFields::ID) writer.field("id", id);
+        if (fields & PostFields::AUTHOR) writer.field("author", author);
+        if (fields & PostFields::CONTENT) writer.field("content", content);  // Escaped by the writer
+        if (fields & PostFields::PREVIEW) writer.field("preview", PostFields::preview(content));
+        if (fields & PostFields::TIMESTAMP) writer.field("timestamp", timestamp);
+        if (fields & PostFields::LIKES) writer.field("likes", likes.size());           // Count only
+        if (fields & PostFields::COMMENTS) writer.field("comments", comments.size());  // Count only
+        if (fields & PostFields::ON_CHAIN) {
+            writer.field("isOnChain", isOnChain);
+            // Conditionally include blockchain hash (only if on chain)
+            if (!blockchainHash.empty()) {
+                writer.field("blockchainHash", blockchainHash);
+            }
         }
-        
-        ss << "}";
-        return ss.str();
+        writer.endObject();
+    }
+
+    /**
+     * @brief Serializes post summary to a standalone JSON string
+     * @return std::string - Same output as writeJson()
+     */
+    std::string toJson() const {
+        std::string out;
+        JsonWriter writer(out);
+        writeJson(writer);
+        return out;
     }
 
     /**
-     * @brief Serializes post to detailed JSON format with full comments
-     * @return std::string - JSON representation including comment array
+     * @brief Appends the post as detailed JSON with full comments
+     * @param writer Destination (usually the response body)
      * 
      * PURPOSE: Complete post data for detail view
      * 
@@ -730,8 +784,8 @@ public:
      * - Larger payload: Not suitable for list views with many posts
      * 
      * COMMENT SERIALIZATION:
-     * Calls Comment::toJson() for each comment
-     * Comma-separated array (careful with last element)
+     * Calls Comment::writeJson() for each comment into the same buffer
+     * (JsonWriter inserts the commas)
      * 
      * SIZE CONSIDERATIONS:
      * Posts with hundreds of comments produce large JSON
@@ -739,31 +793,39 @@ public:
      * 
      * ALTERNATIVE: toJson() provides lightweight summary
      */
-    std::string toDetailedJson() const {
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"id\":\"" << id << "\",";
-        ss << "\"author\":\"" << author << "\",";
-        ss << "\"content\":\"" << escapeJson(content) << "\",";
-        ss << "\"timestamp\":" << timestamp << ",";
-        ss << "\"likes\":" << likes.size() << ",";
-        ss << "\"isOnChain\":" << (isOnChain ? "true" : "false") << ",";
+    void writeDetailedJson(JsonWriter& writer) const {
+        writer.beginObject()
+              .field("id", id)
+              .field("author", author)
+              .field("content", content)
+              .field("timestamp", timestamp)
+              .field("likes", likes.size())
+              .field("isOnChain", isOnChain);
         
         // Conditionally include blockchain hash
         if (!blockchainHash.empty()) {
-            ss << "\"blockchainHash\":\"" << blockchainHash << "\",";
+            writer.field("blockchainHash", blockchainHash);
         }
         
         // Add full comments array (detailed information)
-        ss << "\"comments\":[";
-        for (size_t i = 0; i < comments.size(); i++) {
-            ss << comments[i].toJson();  // Serialize each comment
-            if (i < comments.size() - 1) ss << ",";  // Comma between elements
+        writer.key("comments").beginArray();
+        for (const auto& comment : comments) {
+            comment.writeJson(writer);  // Written in place, no per-comment string
         }
-        ss << "]";
+        writer.endArray();
         
-        ss << "}";
-        return ss.str();
+        writer.endObject();
+    }
+
+    /**
+     * @brief Serializes full post to a standalone JSON string
+     * @return std::string - Same output as writeDetailedJson()
+     */
+    std::string toDetailedJson() const {
+        std::string out;
+        JsonWriter writer(out);
+        writeDetailedJson(writer);
+        return out;
     }
 };
 
@@ -58,7 +58,9 @@
 #include <string>      // std::string - session ID, username
 #include <ctime>       // time_t, std::time() - timestamp and expiration
 #include <random>      // std::random_device, std::mt19937 - secure random generation
-#include <sstream>     // std::stringstream - ID generation and JSON
+#include <sstream>     // std::stringstream - ID generation
+
+#include "../utils/JsonWriter.h"  // JsonWriter - JSON serialization
 
 // ============================================================================
 // SESSION CLASS DEFINITION
@@ -416,8 +418,8 @@ public:
     // ========================================================================
     
     /**
-     * @brief Serializes session to JSON format
-     * @return std::string - JSON representation of session
+     * @brief Appends the session as a JSON object
+     * @param writer Destination (usually the response body)
      * 
      * PURPOSE: API responses, debugging, session management UI
      * 
@@ -449,16 +451,25 @@ public:
      * 
      * WHY const: Read-only serialization
      */
+    void writeJson(JsonWriter& writer) const {
+        writer.beginObject()
+              .field("sessionId", sessionId)
+              .field("username", username)
+              .field("createdAt", createdAt)
+              .field("expiresAt", expiresAt)
+              .field("valid", isValid())
+              .endObject();
+    }
+
+    /**
+     * @brief Serializes session to a standalone JSON string
+     * @return std::string - Same output as writeJson()
+     */
     std::string toJson() const {
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"sessionId\":\"" << sessionId << "\",";
-        ss << "\"username\":\"" << username << "\",";
-        ss << "\"createdAt\":" << createdAt << ",";
-        ss << "\"expiresAt\":" << expiresAt << ",";
-        ss << "\"valid\":" << (isValid() ? "true" : "false");
-        ss << "}";
-        return ss.str();
+        std::string out;
+        JsonWriter writer(out);
+        writeJson(writer);
+        return out;
     }
 };
 
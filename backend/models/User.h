@@ -61,7 +61,7 @@
 #include <string>      // std::string - username, email, passwords, etc.
 #include <set>         // std::set<std::string> - followers and following collections
 #include <ctime>       // time_t, std::time() - registration and login timestamps
-#include <sstream>     // std::stringstream - JSON serialization, hex formatting
+#include <sstream>     // std::stringstream - hex formatting
 
 // ============================================================================
 // EXTERNAL LIBRARY INCLUDES (OpenSSL for Cryptography)
@@ -75,6 +75,8 @@
 
 #include <iomanip>         // std::hex, std::setw, std::setfill - hexadecimal formatting
 
+#include "../utils/JsonWriter.h"  // JsonWriter - JSON serialization
+
 // ============================================================================
 // USER CLASS DEFINITION
 // ============================================================================
@@ -805,9 +807,9 @@ public:
     // ========================================================================
     
     /**
-     * @brief Serializes user to JSON format
+     * @brief Appends the user as a JSON object
+     * @param writer Destination (usually the response body)
      * @param includePrivate If true, includes email and lastLogin (default: false)
-     * @return std::string - JSON representation
      * 
      * PURPOSE: API responses with privacy control
      * 
@@ -849,24 +851,34 @@ public:
      * Could have separate toPublicJson() and toPrivateJson() methods
      * Current approach more flexible with single parameter
      */
-    std::string toJson(bool includePrivate = false) const {
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"username\":\"" << username << "\",";
-        ss << "\"displayName\":\"" << displayName << "\",";
-        ss << "\"bio\":\"" << bio << "\",";
-        ss << "\"followers\":" << followers.size() << ",";  // Count only
-        ss << "\"following\":" << following.size() << ",";  // Count only
-        ss << "\"createdAt\":" << createdAt;
+    void writeJson(JsonWriter& writer, bool includePrivate = false) const {
+        writer.beginObject()
+              .field("username", username)
+              .field("displayName", displayName)
+              .field("bio", bio)                        // Escaped by the writer
+              .field("followers", followers.size())     // Count only
+              .field("following", following.size())     // Count only
+              .field("createdAt", createdAt);
         
         // Conditionally include private fields
         if (includePrivate) {
-            ss << ",\"email\":\"" << email << "\"";
-            ss << ",\"lastLogin\":" << lastLogin;
+            writer.field("email", email)
+                  .field("lastLogin", lastLogin);
         }
         
-        ss << "}";
-        return ss.str();
+        writer.endObject();
+    }
+
+    /**
+     * @brief Serializes user to a standalone JSON string
+     * @param includePrivate Same as writeJson()
+     * @return std::string - Same output as writeJson()
+     */
+    std::string toJson(bool includePrivate = false) const {
+        std::string out;
+        JsonWriter writer(out);
+        writeJson(writer, includePrivate);
+        return out;
     }
 };
 
@@ -0,0 +1,214 @@
+/*******************************************************************************
+ * ADMISSIONCONTROLLER.H - Queueing-Delay Based Load Shedding
+ *
+ * PURPOSE:
+ * Under overload a FIFO worker queue grows without bound and every request
+ * eventually times out. This header implements a CoDel-style admission
+ * controller: it watches how long requests waited in a queue (sojourn time)
+ * and, once the queue is persistently slow, rejects work that has already
+ * waited too long so the requests that ARE admitted finish quickly.
+ *
+ * ALGORITHM (CoDel adapted for request queues):
+ * - target:   acceptable standing queue delay (default 5ms)
+ * - interval: observation window (default 100ms)
+ * - Every admit() call records the sojourn time of one dequeued request.
+ * - At the end of each interval the controller looks at the MINIMUM sojourn
+ *   seen during that interval. If even the luckiest request waited longer
+ *   than target, the queue is not draining: the class is "overloaded".
+ * - Not overloaded: only requests that waited longer than interval are shed
+ *   (their client has most likely given up already).
+ * - Overloaded: any request that waited longer than target is shed.
+ *
+ * REQUEST CLASSES (shed order):
+ * Each class keeps its own CoDel state and its target/interval are scaled
+ * by 2^class, so the cheapest-to-retry work is shed first:
+ * - EXPLORER (1x): Blockchain explorer reads, trivially retryable
+ * - READ     (2x): Feed/profile reads
+ * - AUTH     (4x): Login/register/logout (user is waiting on a form)
+ * - WRITE    (8x): Posts, likes, comments, follows (user-visible state)
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - HttpServer.h: Checks HTTP worker queue delay before dispatching a route
+ * - main.cpp: Checks storage executor queue delay in onStorage()
+ * Each queue gets its own controller, since their delays are unrelated.
+ *
+ * REFERENCES:
+ * - Nichols & Jacobson, "Controlling Queue Delay" (ACM Queue, 2012)
+ * - Maurer, "Fail at Scale" (ACM Queue, 2015) - CoDel for server queues
+ ******************************************************************************/
+
+#ifndef ADMISSIONCONTROLLER_H
+#define ADMISSIONCONTROLLER_H
+
+#include <array>       // std::array - per-class state
+#include <atomic>      // std::atomic - lock-free counters
+#include <chrono>      // std::chrono::steady_clock - sojourn times
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t
+#include <mutex>       // std::mutex - per-class window state
+
+// ============================================================================
+// REQUEST CLASSIFICATION
+// ============================================================================
+
+/**
+ * @enum RequestClass
+ * @brief Shedding priority of a route (lower value = shed earlier)
+ */
+enum class RequestClass {
+    EXPLORER = 0,   // Blockchain explorer (cheapest to retry)
+    READ = 1,       // Ordinary reads
+    AUTH = 2,       // Authentication endpoints
+    WRITE = 3       // State-changing requests (most expensive to lose)
+};
+
+/** @brief Number of RequestClass values */
+constexpr size_t REQUEST_CLASS_COUNT = 4;
+
+/**
+ * @brief Lower-case name of a request class (logs, metrics labels)
+ */
+inline const char* requestClassName(RequestClass cls) {
+    switch (cls) {
+        case RequestClass::EXPLORER: return "explorer";
+        case RequestClass::READ: return "read";
+        case RequestClass::AUTH: return "auth";
+        case RequestClass::WRITE: return "write";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// ADMISSION CONTROLLER
+// ============================================================================
+
+/**
+ * @class AdmissionController
+ * @brief Per-class CoDel state deciding whether a dequeued request runs
+ *
+ * USAGE:
+ * AdmissionController admission;
+ * auto sojourn = AdmissionController::Clock::now() - enqueuedAt;
+ * if (!admission.admit(RequestClass::READ, sojourn)) {
+ *     // answer 503 without doing the work
+ * }
+ *
+ * THREAD SAFETY:
+ * admit() may be called concurrently; each class has its own small mutex
+ * (held for a handful of comparisons), counters are relaxed atomics.
+ */
+class AdmissionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @struct ClassState
+     * @brief CoDel window for one request class
+     */
+    struct ClassState {
+        std::mutex mutex;                  // Protects the window fields
+        Clock::time_point windowStart;     // Start of current interval
+        Clock::duration windowMin;         // Minimum sojourn in current interval
+        bool overloaded = false;           // Verdict of the previous interval
+        std::atomic<uint64_t> admitted{0}; // Requests let through
+        std::atomic<uint64_t> shed{0};     // Requests rejected
+    };
+
+    Clock::duration target;                // Base target delay (EXPLORER)
+    Clock::duration interval;              // Base interval (EXPLORER)
+    std::atomic<bool> enabled;             // Global on/off switch
+    std::array<ClassState, REQUEST_CLASS_COUNT> states;
+
+    /** @brief Per-class scale factor (1, 2, 4, 8) */
+    static int scaleOf(RequestClass cls) {
+        return 1 << static_cast<int>(cls);
+    }
+
+public:
+    /**
+     * @brief Creates controller with base CoDel parameters
+     * @param target Acceptable standing queue delay for the cheapest class
+     * @param interval Observation window for the cheapest class
+     */
+    explicit AdmissionController(
+        std::chrono::milliseconds target = std::chrono::milliseconds(5),
+        std::chrono::milliseconds interval = std::chrono::milliseconds(100))
+        : target(target), interval(interval), enabled(true) {
+        Clock::time_point now = Clock::now();
+        for (auto& state : states) {
+            state.windowStart = now;
+            state.windowMin = Clock::duration::max();
+        }
+    }
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /**
+     * @brief Records one sojourn sample and decides whether to run the request
+     * @param cls Class of the request
+     * @param sojourn Time the request spent queued before this call
+     * @return bool - true to run the request, false to shed it (503)
+     */
+    bool admit(RequestClass cls, Clock::duration sojourn) {
+        ClassState& state = states[static_cast<size_t>(cls)];
+        if (!enabled.load(std::memory_order_relaxed)) {
+            state.admitted.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const int scale = scaleOf(cls);
+        const Clock::duration classTarget = target * scale;
+        const Clock::duration classInterval = interval * scale;
+        const Clock::time_point now = Clock::now();
+
+        bool admitRequest;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+
+            if (sojourn < state.windowMin) state.windowMin = sojourn;
+
+            // Close the window: overloaded if even the best request was late
+            if (now - state.windowStart >= classInterval) {
+                state.overloaded = state.windowMin > classTarget;
+                state.windowStart = now;
+                state.windowMin = Clock::duration::max();
+            }
+
+            admitRequest = sojourn <= (state.overloaded ? classTarget : classInterval);
+        }
+
+        if (admitRequest) {
+            state.admitted.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            state.shed.fetch_add(1, std::memory_order_relaxed);
+        }
+        return admitRequest;
+    }
+
+    /** @brief Enables or disables shedding (disabled = admit everything) */
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+    /** @brief True if shedding is enabled */
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /** @brief Requests admitted for a class */
+    uint64_t admittedCount(RequestClass cls) const {
+        return states[static_cast<size_t>(cls)].admitted.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Requests shed for a class */
+    uint64_t shedCount(RequestClass cls) const {
+        return states[static_cast<size_t>(cls)].shed.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Verdict of the last completed interval for a class */
+    bool isOverloaded(RequestClass cls) {
+        ClassState& state = states[static_cast<size_t>(cls)];
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.overloaded;
+    }
+};
+
+#endif // ADMISSIONCONTROLLER_H
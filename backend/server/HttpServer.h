@@ -32,14 +32,40 @@
  * 
  * THREADING MODEL:
  * - Main thread: Accept loop (server.start())
- * - Worker threads: One per request (std::thread::detach())
- * - Fire-and-forget: Threads clean up automatically
- * - No thread pool: Simple but creates many threads under load
+ * - Worker threads: Fixed pool (TaskExecutor) draining accepted connections
+ * - Async handlers: Release the worker while storage I/O runs elsewhere;
+ *   the response is sent when the handler calls AsyncContext::complete()
+ * 
+ * TRAFFIC CAPTURE (optional):
+ * - enableCapture(path) appends every request (raw bytes, arrival time,
+ *   status) to a binary file that tools/replay can re-issue later
+ * 
+ * OVERLOAD PROTECTION:
+ * - AdmissionController measures how long each connection waited for a
+ *   worker and sheds (503) requests per RequestClass once the queue is
+ *   persistently slow, cheapest-to-retry classes first
+ * 
+ * METRICS:
+ * - Every response is observed into
+ *   bitea_http_request_duration_seconds{method,route,status} (accept →
+ *   response, route = pattern, "unmatched" for 404s); open connections and
+ *   worker queue depth are exposed as gauges (see registerMetrics())
+ * - BITEA_ALLOC_TRACKING builds also count heap allocations per route
+ *   (utils/AllocTracker.h)
+ * 
+ * TRACING:
+ * - Each request gets a RequestTrace (queue, read, parse, route, handler,
+ *   write + storage/blockchain spans); slow requests are logged with the
+ *   breakdown and a sample is kept for Chrome trace export (utils/Trace.h)
+ * 
+ * LOGGING:
+ * - Server messages go through utils/Logger.h (asynchronous, rate-limited
+ *   per call site), so an accept() error storm cannot stall the accept loop
  * 
  * LIMITATIONS (Educational/MVP):
  * - No HTTPS (use reverse proxy like nginx for production)
  * - No request size limits (vulnerable to large payload attacks)
- * - No rate limiting (vulnerable to DoS)
+ * - No per-client rate limiting (only queue-delay based shedding)
  * - No keep-alive connections (HTTP/1.0 style)
  * - No compression (gzip, brotli)
  * - No streaming responses
@@ -48,11 +74,10 @@
  * PRODUCTION RECOMMENDATIONS:
  * - Use established server: crow, beast, drogon, or oat++
  * - Add HTTPS with OpenSSL/TLS
- * - Implement thread pool (limit concurrent threads)
  * - Add request timeouts
  * - Implement rate limiting
  * - Use proper JSON library (nlohmann/json, RapidJSON)
- * - Add logging framework
+ * - Ship logs to a collector (utils/Logger.h writes to stdout/stderr only)
  * - Implement graceful shutdown
  * 
  * REFERENCES:
@@ -70,13 +95,16 @@
 // ============================================================================
 
 #include <string>       // std::string - URLs, headers, body
+#include <string_view>  // std::string_view - Accept header parsing
 #include <map>          // std::map - header/parameter storage (key-value)
-#include <sstream>      // std::stringstream - request/response building
+#include <unordered_map> // std::unordered_map - per-thread metric series cache
+#include <sstream>      // std::istringstream - request parsing
 #include <functional>   // std::function - route handler callbacks
 #include <vector>       // std::vector - route storage, dynamic arrays
-#include <iostream>     // std::cout, std::cerr - logging
 #include <thread>       // std::thread - multi-threaded request handling
 #include <regex>        // std::regex - URL pattern matching
+#include <memory>       // std::shared_ptr, std::unique_ptr - async contexts, worker pool
+#include <atomic>       // std::atomic - one-shot async completion flag
 
 // ============================================================================
 // POSIX SOCKET INCLUDES (Network Programming)
@@ -85,7 +113,19 @@
 #include <sys/socket.h> // socket(), bind(), listen(), accept() - TCP server
 #include <netinet/in.h> // sockaddr_in structure - IPv4 addressing
 #include <unistd.h>     // read(), write(), close() - I/O operations
-#include <cstring>      // memset() - memory operations
+#include <sys/time.h>   // struct timeval - client socket receive timeout
+#include <cstring>      // memset(), strerror() - memory operations, error text
+#include <cerrno>       // errno - accept() failure reason, EINTR retries
+
+#include "TaskExecutor.h"          // Fixed worker pool for connection handling
+#include "AdmissionController.h"   // Queueing-delay based load shedding
+#include "TrafficCapture.h"        // Optional request/response recording
+#include "../utils/Logger.h"       // BITEA_LOG_* - asynchronous, rate-limited logging
+#include "../utils/Metrics.h"      // Per-route latency histograms, connection gauge
+#include "../utils/Trace.h"        // Per-request phase spans, slow-request log
+#include "../utils/Probes.h"       // USDT request__start/route__match/request__done
+#include "../utils/AllocTracker.h" // Per-route allocation counters (optional build)
+#include "../utils/JsonWriter.h"   // WireFormat - negotiated response encoding
 
 // ============================================================================
 // HTTP METHOD ENUMERATION
@@ -254,6 +294,7 @@ struct HttpResponse {
      * - 401: Unauthorized (authentication required)
      * - 404: Not Found (resource doesn't exist)
      * - 500: Internal Server Error (server error)
+     * - 503: Service Unavailable (request shed under overload)
      * 
      * CATEGORIES:
      * - 2xx: Success
@@ -293,6 +334,19 @@ struct HttpResponse {
      */
     std::string body;
 
+    /**
+     * @brief Encoding for jsonBuffer() responses, negotiated from Accept
+     * @type WireFormat
+     * 
+     * Set by HttpServer before the handler runs. Handlers pass it to
+     * JsonWriter so one serialization path serves JSON, CBOR and
+     * MessagePack clients. Bodies set through json() stay JSON (error
+     * messages), so clients should check Content-Type.
+     * 
+     * DEFAULT: WireFormat::JSON
+     */
+    WireFormat format = WireFormat::JSON;
+
     /**
      * @brief Constructor - sets defaults and CORS headers
      * 
@@ -351,25 +405,37 @@ struct HttpResponse {
      * WHY const: Read-only serialization
      */
     std::string toString() const {
-        std::stringstream ss;
+        // One allocation: headers are small, the body dominates
+        std::string out;
+        out.reserve(body.size() + 256);
+
         // Status line: HTTP version, code, status text
-        ss << "HTTP/1.1 " << statusCode << " " << getStatusText() << "\r\n";
+        out += "HTTP/1.1 ";
+        out += std::to_string(statusCode);
+        out += ' ';
+        out += getStatusText();
+        out += "\r\n";
         
         // Headers: Each header as "Key: Value"
         for (const auto& header : headers) {
-            ss << header.first << ": " << header.second << "\r\n";
+            out += header.first;
+            out += ": ";
+            out += header.second;
+            out += "\r\n";
         }
         
         // Content-Length header (auto-calculated)
-        ss << "Content-Length: " << body.length() << "\r\n";
+        out += "Content-Length: ";
+        out += std::to_string(body.length());
+        out += "\r\n";
         
         // Blank line separates headers from body (HTTP spec requirement)
-        ss << "\r\n";
+        out += "\r\n";
         
         // Response body
-        ss << body;
+        out += body;
         
-        return ss.str();
+        return out;
     }
 
     /**
@@ -389,7 +455,9 @@ struct HttpResponse {
             case 400: return "Bad Request";
             case 401: return "Unauthorized";
             case 404: return "Not Found";
+            case 409: return "Conflict";
             case 500: return "Internal Server Error";
+            case 503: return "Service Unavailable";
             default: return "Unknown";
         }
     }
@@ -410,6 +478,24 @@ struct HttpResponse {
         headers["Content-Type"] = "application/json";
     }
 
+    /**
+     * @brief Clears the body, sets Content-Type for the negotiated format
+     * and returns the body for writing
+     * @return std::string& - Body buffer for a JsonWriter
+     * 
+     * USAGE (serializes straight into the response, no temporary string):
+     * JsonWriter writer(res.jsonBuffer(), res.format);
+     * writer.beginArray(); for (...) post.writeJson(writer); writer.endArray();
+     * 
+     * Vary: Accept tells caches the body depends on the Accept header.
+     */
+    std::string& jsonBuffer() {
+        body.clear();
+        headers["Content-Type"] = wireFormatContentType(format);
+        headers["Vary"] = "Accept";
+        return body;
+    }
+
     /**
      * @brief Sets response body as HTML and Content-Type header
      * @param htmlBody HTML string to send
@@ -464,6 +550,126 @@ struct HttpResponse {
  */
 using RouteHandler = std::function<void(const HttpRequest&, HttpResponse&)>;
 
+// ============================================================================
+// ASYNCHRONOUS HANDLER SUPPORT
+// ============================================================================
+
+/**
+ * @brief Writes an entire buffer to a socket, retrying on partial writes
+ *
+ * EINTR: retried; SIGPROF from the CPU profiler can interrupt a write on a
+ * socket with a send timeout even though SA_RESTART is set
+ * @param socketFd Connected client socket
+ * @param data Bytes to send
+ * @return bool - true if everything was written
+ */
+inline bool writeAll(int socketFd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(socketFd, data.data() + sent, data.size() - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @class AsyncContext
+ * @brief Owns one in-flight request whose response is produced later
+ *
+ * PURPOSE: Lets a handler suspend on storage I/O without blocking a worker
+ *
+ * LIFECYCLE:
+ * 1. HttpServer parses the request and creates the context (shared_ptr)
+ * 2. Async handler receives the context and returns immediately, usually
+ *    after handing the context to another executor together with its work
+ * 3. Whoever finishes the work fills ctx->response and calls complete()
+ * 4. complete() serializes the response, writes it and closes the socket,
+ *    then runs onComplete (capture, metrics, trace)
+ *
+ * IN-PROCESS REQUESTS:
+ * A context created with clientSocket = -1 (HttpServer::dispatchAsync,
+ * used for batch sub-requests) has no connection: complete() only hands
+ * the response to onComplete.
+ *
+ * SAFETY NET:
+ * If the last reference is dropped without complete() (handler bug or
+ * exception), the destructor answers 500 so the client is never left hanging.
+ *
+ * THREAD SAFETY:
+ * complete() is one-shot (atomic flag); later calls are ignored.
+ */
+class AsyncContext {
+public:
+    HttpRequest request;    // Parsed request (owned, outlives the worker)
+    HttpResponse response;  // Response to fill before complete()
+    RequestClass requestClass = RequestClass::READ;  // Shedding class of the matched route
+
+    /**
+     * @brief Phase timing for this request; bind it (TraceBinding) on the
+     * thread that continues the work so storage spans land in it
+     */
+    std::shared_ptr<RequestTrace> trace;
+
+    /**
+     * @brief Optional observer run by complete() after the response is sent
+     * USED BY: HttpServer capture, request metrics and trace finishing
+     */
+    std::function<void(const HttpResponse&)> onComplete;
+
+    AsyncContext(int clientSocket, HttpRequest req)
+        : request(std::move(req)), clientSocket(clientSocket), completed(false) {}
+
+    ~AsyncContext() {
+        if (!completed.load()) {
+            response = HttpResponse();
+            response.statusCode = 500;
+            response.json("{\"error\":\"Request was not completed\"}");
+            complete();
+        }
+    }
+
+    AsyncContext(const AsyncContext&) = delete;
+    AsyncContext& operator=(const AsyncContext&) = delete;
+
+    /**
+     * @brief Sends the response and closes the connection (one-shot)
+     */
+    void complete() {
+        if (completed.exchange(true)) return;
+        if (clientSocket >= 0) {
+            {
+                TraceScope phase("write");
+                writeAll(clientSocket, response.toString());
+            }
+            close(clientSocket);
+        }
+        if (onComplete) onComplete(response);
+    }
+
+    /** @brief True once complete() has run */
+    bool isCompleted() const { return completed.load(); }
+
+private:
+    int clientSocket;              // Connection owned by this context, -1 in-process
+    std::atomic<bool> completed;   // Guards against double send
+};
+
+/**
+ * @typedef AsyncRouteHandler
+ * @brief Handler that completes its response later via AsyncContext
+ *
+ * USAGE EXAMPLE:
+ * server.getAsync("/api/posts", [&](std::shared_ptr<AsyncContext> ctx) {
+ *     storage.submit([ctx] {
+ *         ctx->response.json(loadPosts());   // blocking DB call, off-worker
+ *         ctx->complete();
+ *     });
+ * });
+ */
+using AsyncRouteHandler = std::function<void(std::shared_ptr<AsyncContext>)>;
+
 // ============================================================================
 // HTTP SERVER CLASS
 // ============================================================================
@@ -484,13 +690,13 @@ using RouteHandler = std::function<void(const HttpRequest&, HttpResponse&)>;
  * 1. Constructor: Initialize with port number
  * 2. Route registration: server.get(), server.post(), etc.
  * 3. Start: Creates socket, binds, listens, accepts connections
- * 4. Request handling: Each request in separate thread
+ * 4. Request handling: Connections queued to a fixed worker pool
  * 5. Stop: Closes socket, stops accepting new requests
  * 
  * THREADING:
  * Main thread runs accept loop
- * Each connection handled in detached thread
- * No limit on thread count (production should use thread pool)
+ * Each connection handled by one of workerThreads pool workers
+ * Async routes hand their context off and free the worker immediately
  */
 class HttpServer {
 private:
@@ -560,6 +766,18 @@ private:
      * stop() sets running=false, causing accept loop to exit
      */
     bool running;
+
+    /**
+     * @brief Number of connection worker threads
+     * DEFAULT: 32 (set in constructor); bounds concurrent synchronous handlers
+     */
+    size_t workerThreads;
+
+    /**
+     * @brief Worker pool that runs handleClient() for accepted connections
+     * LIFECYCLE: Created in start(), drained and joined in stop()
+     */
+    std::unique_ptr<TaskExecutor> workers;
     
     /**
      * @struct Route
@@ -570,16 +788,21 @@ private:
      * COMPONENTS:
      * - pattern: Original pattern string ("/api/posts/:id")
      * - method: HTTP method (GET, POST, etc.)
-     * - handler: Callback function to execute
+     * - handler: Callback function to execute (synchronous routes)
+     * - asyncHandler: Callback for async routes (set instead of handler)
      * - regex: Compiled regex for matching
      * - paramNames: Names of path parameters (["id"])
+     * - requestClass: Load-shedding class (GET → READ, others → WRITE
+     *   unless overridden with setRequestClass())
      */
     struct Route {
         std::string pattern;              // Original pattern "/api/posts/:id"
         HttpMethod method;                // HTTP method for this route
         RouteHandler handler;             // Function to call when matched
+        AsyncRouteHandler asyncHandler;   // Set for async routes (handler empty)
         std::regex regex;                 // Compiled regex for fast matching
         std::vector<std::string> paramNames;  // ["id", "username", ...]
+        RequestClass requestClass;        // Shedding priority under overload
     };
     
     /**
@@ -596,10 +819,174 @@ private:
      */
     std::vector<Route> routes;
 
+    /**
+     * @brief CoDel admission control for the connection worker queue
+     * 
+     * SOJOURN: Time from accept() until a worker picks the connection up
+     * DECISION: Made after route matching, so the route's class applies
+     */
+    AdmissionController admission;
+
+    /**
+     * @brief Traffic recorder (nullptr unless enableCapture() succeeded)
+     * shared_ptr: async completions may still record after stop()
+     */
+    std::shared_ptr<TrafficCapture> capture;
+
+    /**
+     * @brief Connections accepted but not yet answered
+     * Incremented by the accept loop, decremented once it is answered or
+     * dropped; reported as bitea_http_open_connections
+     * shared_ptr: async completions may still finish after stop()
+     */
+    std::shared_ptr<std::atomic<int64_t>> openConnections;
+
+    /**
+     * @brief Observes one finished request and releases its connection slot
+     * @param route Matched pattern ("unmatched" when no route matched)
+     * @param status Response status code
+     * @param acceptedAt When the connection was accepted (latency origin)
+     */
+    static void recordRequestMetrics(const std::shared_ptr<std::atomic<int64_t>>& open,
+                                     const std::string& route, HttpMethod method, int status,
+                                     TaskExecutor::Clock::time_point acceptedAt) {
+        open->fetch_sub(1, std::memory_order_relaxed);
+        auto elapsed = TaskExecutor::Clock::now() - acceptedAt;
+
+        // Series id cached per thread by (route, method, status):
+        // avoids building the label string on every request
+        thread_local std::unordered_map<std::string, int> seriesCache;
+        std::string key = route;
+        key += static_cast<char>(method);
+        key += std::to_string(status);
+        auto cached = seriesCache.find(key);
+        int id;
+        if (cached != seriesCache.end()) {
+            id = cached->second;
+        } else {
+            std::string labels = "method=\"";
+            labels += methodName(method);
+            labels += "\",route=\"" + route + "\",status=\"" + std::to_string(status) + "\"";
+            id = Metrics::instance().series("bitea_http_request_duration_seconds", labels);
+            seriesCache.emplace(std::move(key), id);
+        }
+        Metrics::instance().observe(id, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    /**
+     * @brief Adds a finished request's heap allocations to its route's counters
+     * No-op unless built with BITEA_ALLOC_TRACKING (utils/AllocTracker.h)
+     */
+    static void recordAllocations(const std::string& route, const RequestTrace& trace) {
+        if (!AllocTracker::ENABLED) return;
+        thread_local std::unordered_map<std::string, std::pair<int, int>> seriesCache;
+        auto cached = seriesCache.find(route);
+        if (cached == seriesCache.end()) {
+            std::string labels = "route=\"" + route + "\"";
+            cached = seriesCache.emplace(route, std::make_pair(
+                Metrics::instance().series("bitea_http_request_allocations_total", labels),
+                Metrics::instance().series("bitea_http_request_allocated_bytes_total", labels))).first;
+        }
+        Metrics::instance().increment(cached->second.first, trace.getAllocCount());
+        Metrics::instance().increment(cached->second.second, trace.getAllocBytes());
+    }
+
+    /**
+     * @brief Appends one exchange to the capture file, if capturing
+     * @param recorder Capture at the time the request started (may be null)
+     * @param acceptedAt When the connection was accepted (replay timing)
+     * @param rawRequest Request bytes as received
+     */
+    static void recordExchange(const std::shared_ptr<TrafficCapture>& recorder,
+                               TaskExecutor::Clock::time_point acceptedAt,
+                               const std::string& rawRequest, const HttpResponse& response) {
+        if (!recorder) return;
+        auto type = response.headers.find("Content-Type");
+        recorder->record(acceptedAt, rawRequest, response.statusCode,
+                         type != response.headers.end() ? type->second : "", response.body);
+    }
+
+    /** @brief Microseconds elapsed since a point in time (request__done probe) */
+    static int64_t microsSince(TaskExecutor::Clock::time_point since) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            TaskExecutor::Clock::now() - since).count();
+    }
+
+    /**
+     * @brief Default shedding class for a newly registered route
+     * GET is a read, every other method changes state
+     */
+    static RequestClass defaultRequestClass(HttpMethod method) {
+        return method == HttpMethod::GET ? RequestClass::READ : RequestClass::WRITE;
+    }
+
     // ========================================================================
-    // PRIVATE HELPER METHODS (Request Processing)
+    // REQUEST PARSING (Public, stateless: also used by tools and benchmarks)
     // ========================================================================
-    
+
+public:
+    /**
+     * @brief Converts HttpMethod enum back to its wire name
+     * @return const char* - "GET", "POST", ...
+     */
+    static const char* methodName(HttpMethod method) {
+        switch (method) {
+            case HttpMethod::GET: return "GET";
+            case HttpMethod::POST: return "POST";
+            case HttpMethod::PUT: return "PUT";
+            case HttpMethod::DELETE: return "DELETE";
+            case HttpMethod::PATCH: return "PATCH";
+            case HttpMethod::OPTIONS: return "OPTIONS";
+        }
+        return "GET";
+    }
+
+    /**
+     * @brief Picks the response encoding from an Accept header
+     * @param accept Accept header value ("" when absent)
+     * @return WireFormat - First supported type listed, JSON otherwise
+     * 
+     * Media ranges are taken in the order the client lists them; q=0
+     * entries are skipped, other q-values are not ranked. application/json
+     * or a wildcard before any binary type keeps JSON.
+     * 
+     * EXAMPLES:
+     * "application/cbor"                              → CBOR
+     * "application/x-msgpack, application/json;q=0.5" → MSGPACK
+     * "application/cbor;q=0, text/html"               → JSON
+     */
+    static WireFormat negotiateFormat(const std::string& accept) {
+        size_t start = 0;
+        while (start < accept.size()) {
+            size_t end = accept.find(',', start);
+            if (end == std::string::npos) end = accept.size();
+            std::string_view range(accept.data() + start, end - start);
+            start = end + 1;
+
+            size_t params = range.find(';');
+            std::string_view type = range.substr(0, params);
+            while (!type.empty() && type.front() == ' ') type.remove_prefix(1);
+            while (!type.empty() && type.back() == ' ') type.remove_suffix(1);
+            if (params != std::string_view::npos) {
+                std::string_view rest = range.substr(params);
+                size_t q = rest.find("q=");
+                if (q != std::string_view::npos) {
+                    std::string_view weight = rest.substr(q + 2);
+                    weight = weight.substr(0, weight.find_first_of("; "));
+                    if (!weight.empty() && weight.find_first_not_of("0.") == std::string_view::npos) {
+                        continue;  // q=0: explicitly not acceptable
+                    }
+                }
+            }
+
+            if (type == "application/cbor") return WireFormat::CBOR;
+            if (type == "application/msgpack" || type == "application/x-msgpack") return WireFormat::MSGPACK;
+            if (type == "application/json" || type == "application/*" || type == "*/*") return WireFormat::JSON;
+        }
+        return WireFormat::JSON;
+    }
+
     /**
      * @brief Converts HTTP method string to enum
      * @param method Method string ("GET", "POST", etc.)
@@ -611,7 +998,7 @@ private:
      * 
      * CASE SENSITIVE: HTTP spec requires uppercase method names
      */
-    HttpMethod parseMethod(const std::string& method) {
+    static HttpMethod parseMethod(const std::string& method) {
         if (method == "GET") return HttpMethod::GET;
         if (method == "POST") return HttpMethod::POST;
         if (method == "PUT") return HttpMethod::PUT;
@@ -658,7 +1045,7 @@ private:
      * - Malformed requests: Best-effort parsing
      * - Production: Should validate and reject malformed requests
      */
-    HttpRequest parseRequest(const std::string& rawRequest) {
+    static HttpRequest parseRequest(const std::string& rawRequest) {
         HttpRequest request;
         std::istringstream stream(rawRequest);
         std::string line;
@@ -733,7 +1120,7 @@ private:
      * Current: No decoding (simplified)
      * Production: Use proper URL decoding
      */
-    void parseQueryString(const std::string& query, std::map<std::string, std::string>& result) {
+    static void parseQueryString(const std::string& query, std::map<std::string, std::string>& result) {
         std::istringstream stream(query);
         std::string pair;
         
@@ -748,15 +1135,21 @@ private:
         }
     }
 
+    // ========================================================================
+    // PRIVATE HELPER METHODS (Request Processing)
+    // ========================================================================
+
+private:
     /**
-     * @brief Handles incoming client connection (runs in separate thread)
+     * @brief Handles incoming client connection (runs on a pool worker)
      * @param clientSocket File descriptor for client connection
+     * @param acceptedAt When the accept loop queued this connection
      * 
      * PURPOSE: Process one HTTP request/response cycle
      * 
      * THREADING:
-     * This method runs in detached thread (one per request)
-     * Created by: std::thread(&HttpServer::handleClient, this, clientSocket).detach()
+     * This method runs on a connection worker (TaskExecutor)
+     * Queued by the accept loop in start()
      * 
      * WORKFLOW:
      * 1. Read raw HTTP request from socket (blocking I/O)
@@ -781,79 +1174,172 @@ private:
      * 4. Call handler with request and response
      * 5. If no match, return 404
      * 
+     * LOAD SHEDDING:
+     * Time spent waiting for a worker is measured on entry; once the route
+     * (and so its RequestClass) is known, AdmissionController decides whether
+     * to run it or answer 503 with Retry-After
+     * 
+     * ASYNC ROUTES:
+     * The socket is handed to an AsyncContext and NOT closed here;
+     * AsyncContext::complete() writes the response and closes it later
+     * 
      * SOCKET OPERATIONS:
      * - read(): Blocks until data available or connection closed
      * - write(): Sends response back to client
      * - close(): Closes connection (HTTP/1.0 style, no keep-alive)
      * 
      * RESOURCE CLEANUP:
-     * Socket always closed at end (RAII would be better)
-     * Thread terminates after close (detached, cleans up automatically)
+     * Socket closed at end for synchronous routes
+     * Worker returns to the pool for the next connection
      */
-    void handleClient(int clientSocket) {
+    void handleClient(int clientSocket, TaskExecutor::Clock::time_point acceptedAt) {
+        // Queueing delay before this worker picked the connection up
+        const auto dequeuedAt = TaskExecutor::Clock::now();
+        const auto sojourn = dequeuedAt - acceptedAt;
+
+        // Phase timing for this request (slow log, sampled trace export)
+        auto trace = std::make_shared<RequestTrace>(acceptedAt);
+        trace->add("queue", acceptedAt, dequeuedAt);
+        TraceBinding binding(trace.get());
+
         // Buffer for reading HTTP request (64KB max)
         char buffer[65536] = {0};
         
-        // Read request from socket (blocking call)
-        ssize_t bytesRead = read(clientSocket, buffer, sizeof(buffer) - 1);
+        // Read request from socket (blocking call, bounded by SO_RCVTIMEO)
+        ssize_t bytesRead;
+        {
+            TraceScope phase("read");
+            // SO_RCVTIMEO sockets return EINTR on signals despite SA_RESTART
+            do {
+                bytesRead = read(clientSocket, buffer, sizeof(buffer) - 1);
+            } while (bytesRead < 0 && errno == EINTR);
+        }
         
         if (bytesRead > 0) {
             // Convert buffer to string for parsing
             std::string rawRequest(buffer, bytesRead);
             
             // Parse raw HTTP into structured format
-            HttpRequest request = parseRequest(rawRequest);
+            HttpRequest request;
+            {
+                TraceScope phase("parse");
+                request = parseRequest(rawRequest);
+            }
+            BITEA_PROBE3(request__start, trace->getId(), methodName(request.method), request.path.c_str());
             
             // Create response object with defaults
             HttpResponse response;
+            auto accept = request.headers.find("Accept");
+            if (accept != request.headers.end()) response.format = negotiateFormat(accept->second);
             
+            // Matched route (stays nullptr for pre-flight and 404)
+            const Route* route = nullptr;
+
             // Handle CORS pre-flight requests
             if (request.method == HttpMethod::OPTIONS) {
                 response.statusCode = 200;
                 response.body = "";  // Empty body for OPTIONS
             } else {
-                // Find matching route and execute handler
-                bool handled = false;
-                
-                for (const auto& route : routes) {
-                    // Check if HTTP method matches
-                    if (route.method == request.method) {
-                        std::smatch matches;
-                        
-                        // Check if path matches regex pattern
-                        if (std::regex_match(request.path, matches, route.regex)) {
-                            // Extract path parameters (:id, :username, etc.)
-                            for (size_t i = 0; i < route.paramNames.size(); i++) {
-                                // matches[0] = full match, matches[1+] = captured groups
-                                request.params[route.paramNames[i]] = matches[i + 1].str();
-                            }
-                            
-                            // Call route handler
-                            route.handler(request, response);
-                            handled = true;
-                            break;  // Stop at first match
-                        }
-                    }
+                // Find matching route (fills request.params)
+                {
+                    TraceScope phase("route");
+                    route = matchRoute(request);
                 }
+                BITEA_PROBE2(route__match, trace->getId(), route ? route->pattern.c_str() : "");
                 
-                // No route matched - return 404
-                if (!handled) {
+                if (route && !admission.admit(route->requestClass, sojourn)) {
+                    // Queue is persistently slow: shed instead of adding to it
+                    response.statusCode = 503;
+                    response.headers["Retry-After"] = "1";
+                    response.json("{\"error\":\"Server overloaded, retry later\"}");
+                } else if (route && route->asyncHandler) {
+                    // Async route: context now owns the socket; the worker
+                    // returns right away and the handler completes later
+                    std::string target = request.path;
+                    auto ctx = std::make_shared<AsyncContext>(clientSocket, std::move(request));
+                    ctx->response.format = response.format;
+                    ctx->requestClass = route->requestClass;
+                    ctx->trace = trace;
+                    ctx->onComplete = [recorder = capture, open = openConnections, acceptedAt,
+                                       pattern = route->pattern, method = route->method,
+                                       raw = capture ? std::move(rawRequest) : std::string(),
+                                       trace, target = std::move(target)]
+                        (const HttpResponse& res) {
+                            BITEA_PROBE3(request__done, trace->getId(), res.statusCode,
+                                         microsSince(acceptedAt));
+                            // Bookkeeping below is not charged to the request
+                            currentTrace() = nullptr;
+                            recordAllocations(pattern, *trace);
+                            recordExchange(recorder, acceptedAt, raw, res);
+                            recordRequestMetrics(open, pattern, method, res.statusCode, acceptedAt);
+                            Tracer::instance().finish(trace, methodName(method), target, res.statusCode);
+                        };
+                    // The trace now belongs to whoever continues the request:
+                    // this thread must not add spans to it any more
+                    currentTrace() = nullptr;
+                    route->asyncHandler(ctx);
+                    return;
+                } else if (route) {
+                    TraceScope phase("handler");
+                    route->handler(request, response);
+                } else {
+                    // No route matched - return 404
                     response.statusCode = 404;
                     response.json("{\"error\":\"Route not found\"}");
                 }
             }
             
-            // Serialize response to HTTP format
-            std::string responseStr = response.toString();
-            
-            // Send response back to client
-            write(clientSocket, responseStr.c_str(), responseStr.length());
+            // Serialize response and send back to client
+            {
+                TraceScope phase("write");
+                writeAll(clientSocket, response.toString());
+            }
+
+            // Record (if capturing), observe metrics, finish the trace;
+            // bookkeeping below is not charged to the request
+            BITEA_PROBE3(request__done, trace->getId(), response.statusCode, microsSince(acceptedAt));
+            currentTrace() = nullptr;
+            const std::string routeLabel =
+                route ? route->pattern : (request.method == HttpMethod::OPTIONS ? "preflight" : "unmatched");
+            recordAllocations(routeLabel, *trace);
+            recordExchange(capture, acceptedAt, rawRequest, response);
+            recordRequestMetrics(openConnections, routeLabel, request.method, response.statusCode, acceptedAt);
+            Tracer::instance().finish(trace, methodName(request.method), request.path, response.statusCode);
+        } else {
+            openConnections->fetch_sub(1, std::memory_order_relaxed);
         }
         
         // Close connection (HTTP/1.0 style, no keep-alive)
         close(clientSocket);
     }
 
+    /**
+     * @brief Finds the first route matching method and path
+     * @param request Parsed request; path parameters are written into params
+     * @return const Route* - Matching route, or nullptr if none
+     * 
+     * ROUTE MATCHING:
+     * 1. Check method matches (GET vs POST, etc.)
+     * 2. Check path matches regex pattern
+     * 3. Extract path parameters from URL
+     * First match wins (registration order matters)
+     */
+    const Route* matchRoute(HttpRequest& request) const {
+        for (const auto& route : routes) {
+            if (route.method != request.method) continue;
+            
+            std::smatch matches;
+            if (std::regex_match(request.path, matches, route.regex)) {
+                // matches[0] = full match, matches[1+] = captured groups
+                for (size_t i = 0; i < route.paramNames.size(); i++) {
+                    request.params[route.paramNames[i]] = matches[i + 1].str();
+                }
+                return &route;
+            }
+        }
+        return nullptr;
+    }
+
     /**
      * @brief Converts route pattern to regex for matching
      * @param pattern Route pattern with :param placeholders
@@ -934,13 +1420,17 @@ public:
      * - port: Set from parameter
      * - serverSocket: -1 (not created yet)
      * - running: false (not started)
+     * - workerThreads: Connection worker pool size (default 32)
      * - routes: Empty vector (populate via get/post/etc.)
      * 
      * USAGE:
-     * HttpServer server(3000);  // Custom port
-     * HttpServer server;        // Default port 3000
+     * HttpServer server(3000);      // Custom port
+     * HttpServer server;            // Default port 3000
+     * HttpServer server(3000, 64);  // Larger worker pool
      */
-    HttpServer(int port = 3000) : port(port), serverSocket(-1), running(false) {}
+    HttpServer(int port = 3000, size_t workerThreads = 32)
+        : port(port), serverSocket(-1), running(false), workerThreads(workerThreads),
+          openConnections(std::make_shared<std::atomic<int64_t>>(0)) {}
 
     /**
      * @brief Destructor - ensures clean shutdown
@@ -1012,6 +1502,26 @@ public:
         addRoute(pattern, HttpMethod::DELETE, handler);
     }
 
+    /**
+     * @brief Registers asynchronous GET route handler
+     * @param pattern URL pattern
+     * @param handler Async handler; must eventually call ctx->complete()
+     * 
+     * PURPOSE: Endpoints that wait on storage without holding a worker
+     */
+    void getAsync(const std::string& pattern, AsyncRouteHandler handler) {
+        addAsyncRoute(pattern, HttpMethod::GET, handler);
+    }
+
+    /**
+     * @brief Registers asynchronous POST route handler
+     * @param pattern URL pattern
+     * @param handler Async handler; must eventually call ctx->complete()
+     */
+    void postAsync(const std::string& pattern, AsyncRouteHandler handler) {
+        addAsyncRoute(pattern, HttpMethod::POST, handler);
+    }
+
     /**
      * @brief Registers route with any HTTP method
      * @param pattern URL pattern with optional :params
@@ -1040,6 +1550,7 @@ public:
         route.pattern = pattern;
         route.method = method;
         route.handler = handler;
+        route.requestClass = defaultRequestClass(method);
         
         // Convert pattern to regex and extract param names
         route.regex = std::regex(routeToRegex(pattern, route.paramNames));
@@ -1048,6 +1559,117 @@ public:
         routes.push_back(route);
     }
 
+    /**
+     * @brief Registers async route with any HTTP method
+     * @param pattern URL pattern with optional :params
+     * @param method HTTP method enum
+     * @param handler Async callback (completes via AsyncContext)
+     * 
+     * SAME MATCHING RULES as addRoute(); async and sync routes share one
+     * ordered route table, so registration order still decides precedence
+     */
+    void addAsyncRoute(const std::string& pattern, HttpMethod method, AsyncRouteHandler handler) {
+        Route route;
+        route.pattern = pattern;
+        route.method = method;
+        route.asyncHandler = handler;
+        route.requestClass = defaultRequestClass(method);
+        route.regex = std::regex(routeToRegex(pattern, route.paramNames));
+        routes.push_back(route);
+    }
+
+    /**
+     * @brief Runs the synchronous handler matching a parsed request
+     * @param request Parsed request (path parameters are filled in)
+     * @param response Response for the handler to fill
+     * @return bool - true if a synchronous route handled the request
+     * 
+     * PURPOSE: Routing without a socket (benchmarks, in-process callers)
+     * 
+     * NOT HANDLED (returns false, response set to 404):
+     * - No route matches method + path
+     * - Matching route is async (needs an AsyncContext)
+     */
+    bool dispatch(HttpRequest& request, HttpResponse& response) const {
+        const Route* route = matchRoute(request);
+        if (!route || !route->handler) {
+            response.statusCode = 404;
+            response.json("{\"error\":\"Route not found\"}");
+            return false;
+        }
+        route->handler(request, response);
+        return true;
+    }
+
+    /**
+     * @brief Runs the handler (sync or async) matching an in-process request
+     * @param request Parsed request (path parameters are filled in)
+     * @param format Encoding the handler should produce
+     * @param done Receives the response exactly once: inline for sync
+     *             routes, later on the handler's executor for async ones
+     * 
+     * PURPOSE: Batch sub-requests (POST /api/batch) go through the same
+     * route table, handlers and executors as requests read from a socket
+     * 
+     * Connection-level work (admission by accept-queue delay, capture,
+     * request metrics, tracing) belongs to the enclosing request and is
+     * not repeated here. Unmatched requests get the usual 404.
+     */
+    void dispatchAsync(HttpRequest request, WireFormat format,
+                       std::function<void(const HttpResponse&)> done) const {
+        const Route* route = matchRoute(request);
+        if (route && route->asyncHandler) {
+            auto ctx = std::make_shared<AsyncContext>(-1, std::move(request));
+            ctx->response.format = format;
+            ctx->requestClass = route->requestClass;
+            ctx->onComplete = std::move(done);
+            route->asyncHandler(ctx);
+            return;
+        }
+
+        HttpResponse response;
+        response.format = format;
+        if (route) {
+            route->handler(request, response);
+        } else {
+            response.statusCode = 404;
+            response.json("{\"error\":\"Route not found\"}");
+        }
+        done(response);
+    }
+
+    /**
+     * @brief Starts recording all traffic to a capture file
+     * @param path Capture file (created/truncated)
+     * @return bool - false if the file cannot be opened (capture stays off)
+     * 
+     * CALL BEFORE start(); see TrafficCapture.h for the file format
+     */
+    bool enableCapture(const std::string& path) {
+        auto recorder = std::make_shared<TrafficCapture>();
+        if (!recorder->open(path)) {
+            BITEA_LOG_ERROR("HttpServer", "Failed to open capture file %s", path.c_str());
+            return false;
+        }
+        capture = recorder;
+        BITEA_LOG_INFO("HttpServer", "Capturing traffic to %s", path.c_str());
+        return true;
+    }
+
+    /**
+     * @brief Overrides the load-shedding class of registered routes
+     * @param pattern Route pattern exactly as registered ("/api/login")
+     * @param cls Class to assign (all methods registered under pattern)
+     * 
+     * USAGE:
+     * server.setRequestClass("/api/blockchain", RequestClass::EXPLORER);
+     */
+    void setRequestClass(const std::string& pattern, RequestClass cls) {
+        for (auto& route : routes) {
+            if (route.pattern == pattern) route.requestClass = cls;
+        }
+    }
+
     /**
      * @brief Starts HTTP server (blocking call)
      * @return bool - true if started successfully, false on error
@@ -1089,8 +1711,8 @@ public:
      * 
      * THREADING MODEL:
      * Main thread runs accept loop
-     * Each accepted connection spawns detached thread
-     * Detached thread: Runs independently, cleans up automatically
+     * Each accepted connection is queued to the worker pool
+     * Workers run handleClient(); pool size bounds thread count
      * 
      * BLOCKING:
      * This method blocks until server stopped
@@ -1108,7 +1730,7 @@ public:
         // Create TCP socket (IPv4, stream-based)
         serverSocket = socket(AF_INET, SOCK_STREAM, 0);
         if (serverSocket < 0) {
-            std::cerr << "Failed to create socket" << std::endl;
+            BITEA_LOG_ERROR("HttpServer", "Failed to create socket");
             return false;
         }
 
@@ -1124,21 +1746,25 @@ public:
 
         // Bind socket to port
         if (bind(serverSocket, (struct sockaddr*)&address, sizeof(address)) < 0) {
-            std::cerr << "Failed to bind to port " << port << std::endl;
+            BITEA_LOG_ERROR("HttpServer", "Failed to bind to port %d", port);
             close(serverSocket);
             return false;
         }
 
         // Start listening for connections (backlog = 10)
         if (listen(serverSocket, 10) < 0) {
-            std::cerr << "Failed to listen on port " << port << std::endl;
+            BITEA_LOG_ERROR("HttpServer", "Failed to listen on port %d", port);
             close(serverSocket);
             return false;
         }
 
+        // Start connection worker pool
+        workers = std::make_unique<TaskExecutor>("http", workerThreads);
+
         // Mark server as running
         running = true;
-        std::cout << "Server started on http://localhost:" << port << std::endl;
+        BITEA_LOG_INFO("HttpServer", "Server started on http://localhost:%d (%zu workers)",
+                       port, workerThreads);
 
         // Accept loop (blocks until server stopped)
         while (running) {
@@ -1151,16 +1777,22 @@ public:
             if (clientSocket < 0) {
                 // Error accepting (may be due to shutdown)
                 if (running) {
-                    std::cerr << "Failed to accept connection" << std::endl;
+                    BITEA_LOG_ERROR("HttpServer", "Failed to accept connection: %s", strerror(errno));
                 }
                 continue;  // Try again
             }
 
-            // Handle request in separate detached thread
-            // Detached: Thread runs independently, no join() needed
-            // this: Pass server object pointer for member access
-            // clientSocket: Pass to thread for processing
-            std::thread(&HttpServer::handleClient, this, clientSocket).detach();
+            // Bound blocking reads so a slow client cannot pin a worker
+            struct timeval readTimeout = { 5, 0 };  // 5 seconds
+            setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &readTimeout, sizeof(readTimeout));
+
+            // Queue connection for a pool worker (timestamp feeds admission control)
+            auto acceptedAt = TaskExecutor::Clock::now();
+            openConnections->fetch_add(1, std::memory_order_relaxed);
+            if (!workers->submit([this, clientSocket, acceptedAt] { handleClient(clientSocket, acceptedAt); })) {
+                openConnections->fetch_sub(1, std::memory_order_relaxed);
+                close(clientSocket);  // Pool shutting down
+            }
         }
 
         return true;
@@ -1178,7 +1810,7 @@ public:
      * 
      * THREAD SAFETY:
      * - Main thread exits accept loop
-     * - Detached worker threads continue until complete
+     * - Worker pool drains queued connections, then joins
      * - New connections rejected after close()
      * 
      * IDEMPOTENT:
@@ -1196,6 +1828,71 @@ public:
             close(serverSocket);    // Close socket, release port
             serverSocket = -1;      // Mark as invalid
         }
+
+        if (workers) {
+            workers->shutdown();    // Finish queued connections, join workers
+        }
+
+        if (capture) {
+            capture->close();       // Flush buffered records
+        }
+    }
+
+    /** @brief Connection worker pool (nullptr before start()) */
+    const TaskExecutor* getWorkerPool() const { return workers.get(); }
+
+    /** @brief Admission controller for the connection queue (tuning, stats) */
+    AdmissionController& getAdmission() { return admission; }
+
+    /** @brief Connections accepted and not yet answered */
+    int64_t getOpenConnections() const { return openConnections->load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Registers this server's metric families with Metrics
+     * 
+     * CALL ONCE for the process's serving instance (gauges keep a pointer
+     * to this server). Families:
+     * - bitea_http_request_duration_seconds (histogram, per route/status)
+     * - bitea_http_open_connections, bitea_http_worker_queue_depth,
+     *   bitea_http_workers_busy (gauges)
+     * - bitea_http_admitted_total / bitea_http_shed_total per class
+     */
+    void registerMetrics() {
+        Metrics& metrics = Metrics::instance();
+        metrics.describe("bitea_http_request_duration_seconds", MetricType::HISTOGRAM,
+                         "Time from accept() to response written, by route and status");
+        metrics.describe("bitea_http_open_connections", MetricType::GAUGE,
+                         "Connections accepted and not yet answered");
+        metrics.callback("bitea_http_open_connections", "",
+                         [this] { return static_cast<double>(getOpenConnections()); });
+        metrics.describe("bitea_http_worker_queue_depth", MetricType::GAUGE,
+                         "Connections waiting for a worker thread");
+        metrics.callback("bitea_http_worker_queue_depth", "",
+                         [this] { return workers ? static_cast<double>(workers->queueDepth()) : 0.0; });
+        metrics.describe("bitea_http_workers_busy", MetricType::GAUGE,
+                         "Worker threads currently handling a connection");
+        metrics.callback("bitea_http_workers_busy", "",
+                         [this] { return workers ? static_cast<double>(workers->activeCount()) : 0.0; });
+
+        metrics.describe("bitea_http_admitted_total", MetricType::COUNTER,
+                         "Requests admitted by connection-queue load shedding");
+        metrics.describe("bitea_http_shed_total", MetricType::COUNTER,
+                         "Requests rejected with 503 by connection-queue load shedding");
+        for (size_t i = 0; i < REQUEST_CLASS_COUNT; i++) {
+            RequestClass cls = static_cast<RequestClass>(i);
+            std::string labels = std::string("class=\"") + requestClassName(cls) + "\"";
+            metrics.callback("bitea_http_admitted_total", labels,
+                             [this, cls] { return static_cast<double>(admission.admittedCount(cls)); });
+            metrics.callback("bitea_http_shed_total", labels,
+                             [this, cls] { return static_cast<double>(admission.shedCount(cls)); });
+        }
+
+        if (AllocTracker::ENABLED) {
+            metrics.describe("bitea_http_request_allocations_total", MetricType::COUNTER,
+                             "Heap allocations (operator new) made while handling requests, by route");
+            metrics.describe("bitea_http_request_allocated_bytes_total", MetricType::COUNTER,
+                             "Bytes requested from operator new while handling requests, by route");
+        }
     }
 };
 
@@ -1210,8 +1907,8 @@ public:
  * 
  * ARCHITECTURE DECISIONS:
  * - Raw sockets: Educational, no external dependencies
- * - Multi-threaded: Simple concurrency (one thread per request)
- * - No thread pool: Could create many threads under load
+ * - Multi-threaded: Fixed worker pool drains accepted connections
+ * - Async routes: Storage waits run off-pool via AsyncContext
  * - HTTP/1.0 style: No keep-alive connections
  * - CORS enabled: Frontend integration without hassle
  * 
@@ -1233,14 +1930,14 @@ public:
  * - Handlers share blockchain/database: Those provide sync
  * 
  * PERFORMANCE CHARACTERISTICS:
- * - Thread-per-request: Simple but resource-intensive
+ * - Fixed worker pool: Thread count bounded regardless of load
  * - Typical: ~1MB per thread (stack)
- * - 1000 concurrent requests = ~1GB RAM
- * - Production: Use thread pool or event-driven (epoll, io_uring)
+ * - Excess connections wait in the pool queue instead of spawning threads
+ * - Production: Event-driven I/O (epoll, io_uring) for idle connections
  * 
  * SECURITY LIMITATIONS:
  * - No HTTPS: Traffic unencrypted (use reverse proxy)
- * - No rate limiting: Vulnerable to DoS
+ * - No per-client rate limiting: Only queue-delay shedding under overload
  * - No request size limit: Memory exhaustion possible
  * - No input validation: Handler responsibility
  * - No timeout: Slow clients can hold threads
@@ -1272,7 +1969,6 @@ public:
  * - Add security headers (CSP, X-Frame-Options)
  * 
  * PERFORMANCE:
- * - Thread pool (reuse threads, limit concurrency)
  * - Event-driven I/O (epoll on Linux, kqueue on BSD/Mac)
  * - Keep-alive connections (HTTP/1.1 persistent)
  * - Response compression (gzip, brotli)
@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * RESPONSECACHE.H - Single-Flight Coalescing and Short-Lived Read Cache
+ *
+ * PURPOSE:
+ * When one post goes viral, hundreds of identical GET /api/posts/:id and
+ * GET /api/posts requests arrive at once. Each would take a storage thread,
+ * query MongoDB and serialize the same body. This header lets identical
+ * concurrent reads share one backend fetch and one serialized response,
+ * and keeps that response for a short TTL to absorb the rest of the burst.
+ *
+ * ALGORITHM (per request key):
+ * 1. Fresh cached response → copy it, answer on the HTTP worker (HIT)
+ * 2. Fetch already in flight → park the request on it (COALESCED)
+ * 3. Otherwise this request leads a new flight (MISS); when the handler
+ *    finishes, publish() answers every parked request with a copy of the
+ *    one response and caches it if it is a 200
+ *
+ * KEY:
+ * Path + query parameters (sorted, std::map order) + response encoding,
+ * e.g. "/api/posts?fields=id,author&limit=20#cbor". Cached routes must
+ * not depend on anything else (headers, session) for their output.
+ *
+ * CONSISTENCY:
+ * invalidate() is called after every write that changes posts: it drops
+ * cached responses and detaches in-flight fetches, so a client that reads
+ * after its own write never gets a response fetched before that write.
+ * A flight started before the write still answers the requests already
+ * parked on it (they were concurrent with the write) but is not cached.
+ * Without writes, a reader sees data at most ttl old.
+ *
+ * BOUNDS:
+ * At most maxEntries cached responses; when full, expired entries are swept
+ * and, if none expired, the new response is simply not cached.
+ * ttl = 0 disables caching but keeps coalescing.
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - main.cpp: onStorageCoalesced() wraps the feed and post-detail routes;
+ *   post writes call invalidate()
+ * - HttpServer.h: the fetch runs in a socket-less AsyncContext whose
+ *   onComplete is publish()
+ * - GET /metrics: bitea_read_cache_requests_total{result="hit|coalesced|miss"}
+ *
+ * REFERENCES:
+ * - Go singleflight package (golang.org/x/sync/singleflight)
+ * - Nishtala et al., "Scaling Memcache at Facebook" (NSDI 2013) - leases
+ ******************************************************************************/
+
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <atomic>        // std::atomic - hit/coalesced/miss counters
+#include <chrono>        // std::chrono::steady_clock - entry expiry
+#include <cstddef>       // size_t
+#include <cstdint>       // uint64_t
+#include <memory>        // std::shared_ptr - flights, parked contexts
+#include <string>        // std::string - keys
+#include <unordered_map> // std::unordered_map - entries and flights by key
+#include <utility>       // std::move
+#include <vector>        // std::vector - parked requests
+
+#include "HttpServer.h"              // AsyncContext, HttpRequest, HttpResponse
+#include "../utils/JsonWriter.h"     // WireFormat - part of the key
+#include "../utils/ProfiledMutex.h"  // ProfiledMutex - contention report
+
+/**
+ * @class ResponseCache
+ * @brief Coalesces identical concurrent reads and caches their response
+ *
+ * THREAD SAFETY: All methods may be called concurrently; one mutex guards
+ * the maps and is never held while a response is sent.
+ */
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief What lookupOrJoin() did with a request */
+    enum class Outcome {
+        HIT,        // ctx->response filled from the cache: complete() it
+        COALESCED,  // Parked on a running fetch: publish() completes it
+        MISS        // Caller must fetch, then call publish() with the flight
+    };
+
+    /**
+     * @brief One backend fetch and the requests waiting for its result
+     * Held by the fetch's onComplete; detached from the key by invalidate()
+     */
+    struct Flight {
+        std::string key;
+        uint64_t generation = 0;   // invalidate() count when it started
+        std::vector<std::shared_ptr<AsyncContext>> waiters;  // Leader first
+    };
+
+    /**
+     * @param ttl How long a 200 response is served from the cache
+     * @param maxEntries Upper bound on cached responses
+     */
+    explicit ResponseCache(Clock::duration ttl = std::chrono::milliseconds(250),
+                           size_t maxEntries = 1024)
+        : ttl(ttl), maxEntries(maxEntries), generation(0) {}
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    /** @brief Changes the TTL (0 = coalescing only); call before start() */
+    void setTtl(Clock::duration value) { ttl = value; }
+
+    /** @brief Cache/flight key of a request in a given encoding */
+    static std::string keyFor(const HttpRequest& request, WireFormat format) {
+        std::string key = request.path;
+        char separator = '?';
+        for (const auto& param : request.query) {
+            key += separator;
+            key += param.first;
+            key += '=';
+            key += param.second;
+            separator = '&';
+        }
+        key += '#';
+        key += wireFormatContentType(format);
+        return key;
+    }
+
+    /**
+     * @brief Serves a request from the cache, parks it, or makes it leader
+     * @param key keyFor(ctx->request, ctx->response.format)
+     * @param ctx The request (kept until publish() on COALESCED/MISS)
+     * @param flight Set on MISS: pass it to publish() when the fetch ends
+     */
+    Outcome lookupOrJoin(const std::string& key, const std::shared_ptr<AsyncContext>& ctx,
+                         std::shared_ptr<Flight>& flight) {
+        ProfiledLock lock(mutex, "lookupOrJoin");
+        auto cached = entries.find(key);
+        if (cached != entries.end()) {
+            if (Clock::now() < cached->second.expires) {
+                HttpResponse& res = ctx->response;
+                res.statusCode = cached->second.response.statusCode;
+                res.headers = cached->second.response.headers;
+                res.body = cached->second.response.body;
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return Outcome::HIT;
+            }
+            entries.erase(cached);
+        }
+
+        auto running = flights.find(key);
+        if (running != flights.end()) {
+            running->second->waiters.push_back(ctx);
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+            return Outcome::COALESCED;
+        }
+
+        flight = std::make_shared<Flight>();
+        flight->key = key;
+        flight->generation = generation;
+        flight->waiters.push_back(ctx);
+        flights.emplace(key, flight);
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return Outcome::MISS;
+    }
+
+    /**
+     * @brief Answers every request parked on a flight with one response
+     * @param flight Flight returned by lookupOrJoin() (MISS)
+     * @param response The fetch's response (copied into each waiter)
+     */
+    void publish(const std::shared_ptr<Flight>& flight, const HttpResponse& response) {
+        std::vector<std::shared_ptr<AsyncContext>> waiters;
+        {
+            ProfiledLock lock(mutex, "publish");
+            auto running = flights.find(flight->key);
+            if (running != flights.end() && running->second == flight) flights.erase(running);
+            waiters.swap(flight->waiters);
+
+            if (response.statusCode == 200 && ttl > Clock::duration::zero() &&
+                flight->generation == generation && makeRoom()) {
+                Entry& entry = entries[flight->key];
+                entry.response = response;
+                entry.expires = Clock::now() + ttl;
+            }
+        }
+
+        for (auto& waiter : waiters) {
+            waiter->response.statusCode = response.statusCode;
+            waiter->response.headers = response.headers;
+            waiter->response.body = response.body;
+            waiter->complete();
+        }
+    }
+
+    /**
+     * @brief Forgets cached responses and running fetches (after a write)
+     * Fetches already running still answer their parked requests.
+     */
+    void invalidate() {
+        ProfiledLock lock(mutex, "invalidate");
+        generation++;
+        entries.clear();
+        flights.clear();
+    }
+
+    uint64_t hitCount() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t coalescedCount() const { return coalesced.load(std::memory_order_relaxed); }
+    uint64_t missCount() const { return misses.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        HttpResponse response;
+        Clock::time_point expires;
+    };
+
+    Clock::duration ttl;
+    size_t maxEntries;
+    ProfiledMutex mutex{"responseCache"};
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+    uint64_t generation;                 // Bumped by invalidate()
+    std::atomic<uint64_t> hits{0};       // Answered from the cache
+    std::atomic<uint64_t> coalesced{0};  // Parked on another request's fetch
+    std::atomic<uint64_t> misses{0};     // Led a fetch
+
+    /** @brief True if one more entry fits (sweeps expired ones if full) */
+    bool makeRoom() {
+        if (entries.size() < maxEntries) return true;
+        const Clock::time_point now = Clock::now();
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.expires <= now) it = entries.erase(it);
+            else ++it;
+        }
+        return entries.size() < maxEntries;
+    }
+};
+
+#endif // RESPONSECACHE_H
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * TASKEXECUTOR.H - Fixed-Size Worker Thread Pool
+ *
+ * PURPOSE:
+ * This header defines a small, dependency-free thread pool used by the Bitea
+ * server. HttpServer runs accepted connections on one executor, and BiteaApp
+ * runs blocking storage calls (MongoDB, Redis) on another, so a handler that
+ * waits on the database does not pin an HTTP worker for the round trip.
+ *
+ * DESIGN:
+ * - N worker threads created up front (no thread creation per request)
+ * - One FIFO queue protected by a mutex + condition variable
+ * - Tasks are std::function<void()> (lambdas with captures)
+ * - Each queued task remembers when it was enqueued, so callers can measure
+ *   time-in-queue (used for load shedding and metrics)
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - HttpServer.h: Connection workers (replaces one detached thread per request)
+ * - main.cpp: Storage executor for async route handlers
+ *
+ * SHUTDOWN:
+ * shutdown() stops accepting work, lets workers drain the queue, and joins
+ * them. The destructor calls shutdown() (RAII). Concurrent callers are
+ * serialized on joinMutex: one joins, the others wait until it is done.
+ ******************************************************************************/
+
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include <atomic>              // std::atomic - lock-free counters
+#include <chrono>              // std::chrono::steady_clock - enqueue timestamps
+#include <condition_variable>  // std::condition_variable - worker wakeup
+#include <cstddef>             // size_t
+#include <deque>               // std::deque - FIFO task queue
+#include <functional>          // std::function - type-erased tasks
+#include <mutex>               // std::mutex, std::unique_lock
+#include <string>              // std::string - executor name for logging
+#include <thread>              // std::thread - worker threads
+#include <vector>              // std::vector - worker storage
+
+#include <pthread.h>           // pthread_setname_np - worker thread names
+
+/**
+ * @class TaskExecutor
+ * @brief Fixed pool of worker threads draining a shared FIFO queue
+ *
+ * USAGE:
+ * TaskExecutor pool("storage", 8);
+ * pool.submit([] { doBlockingWork(); });
+ *
+ * THREAD SAFETY:
+ * submit(), queueDepth() and activeCount() may be called from any thread.
+ */
+class TaskExecutor {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+private:
+    /**
+     * @struct QueuedTask
+     * @brief Task plus the time it entered the queue
+     */
+    struct QueuedTask {
+        Task task;
+        Clock::time_point enqueuedAt;
+    };
+
+    std::string name;                    // Executor name (for diagnostics)
+    std::vector<std::thread> workers;    // Worker threads
+    std::deque<QueuedTask> queue;        // Pending tasks (FIFO)
+    std::mutex queueMutex;               // Protects queue and stopping
+    std::condition_variable queueCv;     // Signals new work / shutdown
+    bool stopping;                       // Set by shutdown()
+    std::mutex joinMutex;                // Serializes joining/clearing workers
+    std::atomic<size_t> depth;           // Mirror of queue.size() for lock-free reads
+    std::atomic<size_t> active;          // Tasks currently executing
+
+    /** @brief Executor whose worker is the calling thread (nullptr if none) */
+    static const TaskExecutor*& currentExecutor() {
+        thread_local const TaskExecutor* executor = nullptr;
+        return executor;
+    }
+
+    /**
+     * @brief Worker loop - pops tasks until shutdown and queue empty
+     * @param index Worker number, used in the OS thread name ("storage-3")
+     */
+    void workerLoop(size_t index) {
+        // Named threads show up in top -H, gdb and /debug/profile stacks
+        std::string threadName = (name + "-" + std::to_string(index)).substr(0, 15);
+#if defined(__APPLE__)
+        pthread_setname_np(threadName.c_str());
+#else
+        pthread_setname_np(pthread_self(), threadName.c_str());
+#endif
+        currentExecutor() = this;
+
+        for (;;) {
+            QueuedTask item;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCv.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;  // stopping and drained
+                item = std::move(queue.front());
+                queue.pop_front();
+                depth.store(queue.size(), std::memory_order_relaxed);
+            }
+
+            active.fetch_add(1, std::memory_order_relaxed);
+            try {
+                item.task();
+            } catch (...) {
+                // A throwing task must never take the worker down with it
+            }
+            active.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    /**
+     * @brief Creates executor and starts worker threads
+     * @param name Executor name (diagnostics, thread names)
+     * @param threadCount Number of workers (minimum 1)
+     */
+    TaskExecutor(const std::string& name, size_t threadCount)
+        : name(name), stopping(false), depth(0), active(0) {
+        if (threadCount == 0) threadCount = 1;
+        workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back(&TaskExecutor::workerLoop, this, i);
+        }
+    }
+
+    ~TaskExecutor() {
+        shutdown();
+    }
+
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    /**
+     * @brief Queues a task for execution on a worker thread
+     * @param task Callable to run
+     * @return bool - false if executor is shutting down (task not queued)
+     */
+    bool submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping) return false;
+            queue.push_back(QueuedTask{std::move(task), Clock::now()});
+            depth.store(queue.size(), std::memory_order_relaxed);
+        }
+        queueCv.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Stops accepting work, drains the queue and joins workers
+     * IDEMPOTENT: Safe to call more than once, and from several threads
+     * at once: the workers are joined by exactly one caller, and the others
+     * return once it has finished.
+     * 
+     * FROM ONE OF OUR OWN TASKS: If another thread is already joining, it
+     * is waiting for this task too, so just return (blocking would
+     * deadlock); otherwise join the rest and detach the calling worker.
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCv.notify_all();
+
+        std::unique_lock<std::mutex> joinLock(joinMutex, std::defer_lock);
+        if (currentExecutor() == this) {
+            if (!joinLock.try_lock()) return;
+        } else {
+            joinLock.lock();
+        }
+        for (auto& worker : workers) {
+            if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
+                worker.join();
+            } else if (worker.joinable()) {
+                worker.detach();  // shutdown() called from one of our own tasks
+            }
+        }
+        workers.clear();
+    }
+
+    /** @brief Number of tasks waiting in the queue */
+    size_t queueDepth() const { return depth.load(std::memory_order_relaxed); }
+
+    /** @brief Number of tasks currently running */
+    size_t activeCount() const { return active.load(std::memory_order_relaxed); }
+
+    /** @brief Number of worker threads */
+    size_t threadCount() const { return workers.size(); }
+
+    /** @brief Executor name */
+    const std::string& getName() const { return name; }
+};
+
+#endif // TASKEXECUTOR_H
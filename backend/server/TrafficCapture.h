@@ -0,0 +1,262 @@
+/*******************************************************************************
+ * TRAFFICCAPTURE.H - Binary HTTP Traffic Capture (Writer + Reader)
+ *
+ * PURPOSE:
+ * Records real requests hitting HttpServer so they can be replayed offline
+ * (tools/replay) with their original timing. Synthetic load mixes never
+ * match production shape; a capture does.
+ *
+ * FILE FORMAT (little-endian, version 1):
+ *
+ *   HEADER
+ *     char[8]  magic          "BITEACAP"
+ *     uint32   version        1
+ *     uint64   startUnixMicros  wall-clock time capture started
+ *
+ *   RECORD (repeated until EOF)
+ *     uint64   offsetMicros   arrival time relative to capture start
+ *     uint32   durationMicros arrival → response written
+ *     uint16   status         HTTP status code sent
+ *     uint32   requestLength
+ *     uint32   responseLength (0 unless response body was kept)
+ *     bytes    request        raw request exactly as read from the socket
+ *     bytes    response       response body (small JSON bodies only)
+ *
+ * Records are appended when a response is sent, so they are NOT sorted by
+ * offsetMicros; readers sort after loading.
+ *
+ * RESPONSE BODIES:
+ * Small JSON response bodies (<= responseBodyLimit, default 4KB) are kept so
+ * the replayer can remap session tokens (login responses) and compare
+ * outcomes. Large bodies (feeds) are dropped to keep captures compact.
+ *
+ * SECURITY:
+ * Captures contain Authorization headers, passwords in login bodies and
+ * session ids. Treat capture files like credentials.
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - HttpServer.h: enableCapture(path) records every request/response
+ * - main.cpp: BITEA_CAPTURE_FILE environment variable turns capture on
+ * - tools/replay: readCapture() + re-issue at original or scaled speed
+ ******************************************************************************/
+
+#ifndef TRAFFICCAPTURE_H
+#define TRAFFICCAPTURE_H
+
+#include <algorithm>   // std::sort - order records by arrival
+#include <chrono>      // std::chrono - timestamps
+#include <cstdint>     // fixed-width integers
+#include <cstdio>      // FILE*, fopen, fwrite - buffered file output
+#include <cstring>     // memcmp - magic check
+#include <mutex>       // std::mutex - serialize writers
+#include <string>      // std::string
+#include <vector>      // std::vector
+
+/**
+ * @struct CaptureRecord
+ * @brief One captured request/response exchange
+ */
+struct CaptureRecord {
+    uint64_t offsetMicros = 0;     // Arrival relative to capture start
+    uint32_t durationMicros = 0;   // Server-side latency as seen at capture time
+    uint16_t status = 0;           // Response status code
+    std::string request;           // Raw HTTP request
+    std::string responseBody;      // Small JSON bodies only (may be empty)
+};
+
+namespace capture_format {
+    constexpr char MAGIC[8] = {'B', 'I', 'T', 'E', 'A', 'C', 'A', 'P'};
+    constexpr uint32_t VERSION = 1;
+
+    inline void putU16(std::string& out, uint16_t v) {
+        for (int i = 0; i < 2; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+    inline void putU32(std::string& out, uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+    inline void putU64(std::string& out, uint64_t v) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+    inline bool getBytes(FILE* in, void* dst, size_t n) {
+        return fread(dst, 1, n, in) == n;
+    }
+    inline bool getLE(FILE* in, uint64_t& value, int bytes) {
+        unsigned char buf[8];
+        if (!getBytes(in, buf, static_cast<size_t>(bytes))) return false;
+        value = 0;
+        for (int i = bytes - 1; i >= 0; i--) value = (value << 8) | buf[i];
+        return true;
+    }
+}
+
+/**
+ * @class TrafficCapture
+ * @brief Thread-safe appender for capture files
+ *
+ * USAGE:
+ * TrafficCapture capture;
+ * if (capture.open("traffic.bcap")) {
+ *     capture.record(arrivedAt, rawRequest, status, contentType, body);
+ * }
+ */
+class TrafficCapture {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    FILE* file;                    // Buffered output (nullptr when closed)
+    std::mutex fileMutex;          // One record written at a time
+    Clock::time_point start;       // Origin for offsetMicros
+    size_t responseBodyLimit;      // Keep JSON bodies up to this size
+    uint64_t recordCount;          // Records written
+    uint32_t unflushed;            // Records since last fflush()
+    Clock::time_point lastFlush;   // Time of last fflush()
+
+public:
+    explicit TrafficCapture(size_t responseBodyLimit = 4096)
+        : file(nullptr), responseBodyLimit(responseBodyLimit), recordCount(0), unflushed(0) {}
+
+    ~TrafficCapture() { close(); }
+
+    TrafficCapture(const TrafficCapture&) = delete;
+    TrafficCapture& operator=(const TrafficCapture&) = delete;
+
+    /**
+     * @brief Creates (truncates) the capture file and writes the header
+     * @param path Output file path
+     * @return bool - false if the file cannot be opened
+     */
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (file) fclose(file);
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+
+        start = Clock::now();
+        uint64_t unixMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+
+        std::string header(capture_format::MAGIC, sizeof(capture_format::MAGIC));
+        capture_format::putU32(header, capture_format::VERSION);
+        capture_format::putU64(header, unixMicros);
+        fwrite(header.data(), 1, header.size(), file);
+        recordCount = 0;
+        unflushed = 0;
+        lastFlush = start;
+        return true;
+    }
+
+    /** @brief Flushes and closes the file (idempotent) */
+    void close() {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (file) {
+            fclose(file);
+            file = nullptr;
+        }
+    }
+
+    bool isOpen() {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return file != nullptr;
+    }
+
+    /**
+     * @brief Appends one exchange
+     * @param arrivedAt When the connection was accepted
+     * @param rawRequest Request bytes as read from the socket
+     * @param status Response status code
+     * @param contentType Response Content-Type (bodies kept only for JSON)
+     * @param responseBody Response body
+     */
+    void record(Clock::time_point arrivedAt, const std::string& rawRequest, int status,
+                const std::string& contentType, const std::string& responseBody) {
+        Clock::time_point now = Clock::now();
+        bool keepBody = contentType == "application/json" && responseBody.size() <= responseBodyLimit;
+        const std::string emptyBody;
+        const std::string& body = keepBody ? responseBody : emptyBody;
+
+        std::string rec;
+        rec.reserve(22 + rawRequest.size() + body.size());
+
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (!file) return;
+
+        auto offset = std::chrono::duration_cast<std::chrono::microseconds>(arrivedAt - start).count();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - arrivedAt).count();
+        capture_format::putU64(rec, offset > 0 ? static_cast<uint64_t>(offset) : 0);
+        capture_format::putU32(rec, static_cast<uint32_t>(std::min<int64_t>(duration, UINT32_MAX)));
+        capture_format::putU16(rec, static_cast<uint16_t>(status));
+        capture_format::putU32(rec, static_cast<uint32_t>(rawRequest.size()));
+        capture_format::putU32(rec, static_cast<uint32_t>(body.size()));
+        rec += rawRequest;
+        rec += body;
+        fwrite(rec.data(), 1, rec.size(), file);
+        recordCount++;
+
+        // Bound what a kill (no graceful shutdown yet) can lose: 64 records / 1s
+        if (++unflushed >= 64 || now - lastFlush >= std::chrono::seconds(1)) {
+            fflush(file);
+            unflushed = 0;
+            lastFlush = now;
+        }
+    }
+
+    /** @brief Number of records written since open() */
+    uint64_t getRecordCount() {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return recordCount;
+    }
+};
+
+/**
+ * @brief Loads a capture file, sorted by arrival offset
+ * @param path Capture file path
+ * @param records Output records
+ * @param startUnixMicros Output wall-clock start of the capture
+ * @return bool - false on missing file, bad magic or unsupported version
+ *               (a truncated trailing record is ignored)
+ */
+inline bool readCapture(const std::string& path, std::vector<CaptureRecord>& records,
+                        uint64_t& startUnixMicros) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+
+    char magic[8];
+    uint64_t version = 0;
+    if (!capture_format::getBytes(in, magic, sizeof(magic)) ||
+        memcmp(magic, capture_format::MAGIC, sizeof(magic)) != 0 ||
+        !capture_format::getLE(in, version, 4) || version != capture_format::VERSION ||
+        !capture_format::getLE(in, startUnixMicros, 8)) {
+        fclose(in);
+        return false;
+    }
+
+    for (;;) {
+        CaptureRecord rec;
+        uint64_t offset, duration, status, requestLength, responseLength;
+        if (!capture_format::getLE(in, offset, 8) ||
+            !capture_format::getLE(in, duration, 4) ||
+            !capture_format::getLE(in, status, 2) ||
+            !capture_format::getLE(in, requestLength, 4) ||
+            !capture_format::getLE(in, responseLength, 4)) {
+            break;
+        }
+        rec.offsetMicros = offset;
+        rec.durationMicros = static_cast<uint32_t>(duration);
+        rec.status = static_cast<uint16_t>(status);
+        rec.request.resize(requestLength);
+        rec.responseBody.resize(responseLength);
+        if ((requestLength && !capture_format::getBytes(in, &rec.request[0], requestLength)) ||
+            (responseLength && !capture_format::getBytes(in, &rec.responseBody[0], responseLength))) {
+            break;
+        }
+        records.push_back(std::move(rec));
+    }
+    fclose(in);
+
+    std::stable_sort(records.begin(), records.end(),
+        [](const CaptureRecord& a, const CaptureRecord& b) { return a.offsetMicros < b.offsetMicros; });
+    return true;
+}
+
+#endif // TRAFFICCAPTURE_H
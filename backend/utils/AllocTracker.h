@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * ALLOCTRACKER.H - Per-Request Heap Allocation Accounting
+ *
+ * PURPOSE:
+ * Counts operator new calls (and requested bytes) made while a request is
+ * being handled and attributes them to its route, so an endpoint that starts
+ * allocating more (a new std::map copy, a stringstream in a loop) shows up
+ * in GET /metrics:
+ *   bitea_http_request_allocations_total{route="/api/feed"}
+ *   bitea_http_request_allocated_bytes_total{route="/api/feed"}
+ * Divide by bitea_http_request_duration_seconds_count for per-request
+ * figures.
+ *
+ * BUILD:
+ * - cmake -DBITEA_ALLOC_TRACKING=ON defines HAS_ALLOC_TRACKING and
+ *   BITEA_ALLOC_HOOKS() (expanded once, in main.cpp) replaces the global
+ *   operator new/delete
+ * - Otherwise nothing is replaced, AllocTracker::ENABLED is false and no
+ *   series are registered
+ *
+ * ATTRIBUTION:
+ * The replacement operator new charges the RequestTrace bound to the
+ * calling thread (utils/Trace.h). The trace follows the request across the
+ * HTTP worker and the storage thread, so async routes are fully covered.
+ * Allocations outside a request (startup, the logger thread) are not
+ * counted. Frees are not tracked: the goal is allocation pressure, not leak
+ * detection.
+ *
+ * COST WHEN ENABLED: one thread_local read and two increments per new.
+ ******************************************************************************/
+
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <cstddef>     // std::size_t
+#include <cstdlib>     // std::malloc, std::free, std::aligned_alloc
+#include <new>         // std::bad_alloc, std::nothrow_t, std::align_val_t
+
+#include "Trace.h"     // currentTrace() - allocation owner
+
+namespace AllocTracker {
+
+#if defined(HAS_ALLOC_TRACKING)
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+/** @brief Charges an allocation to the request bound to this thread */
+inline void note(std::size_t bytes) {
+    if (RequestTrace* trace = currentTrace()) trace->noteAllocation(bytes);
+}
+
+/** @brief malloc with operator new semantics (new_handler loop, bad_alloc) */
+inline void* allocate(std::size_t size) {
+    if (size == 0) size = 1;
+    note(size);
+    for (;;) {
+        if (void* p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+/** @brief aligned_alloc with operator new semantics */
+inline void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires size to be a multiple of the alignment
+    std::size_t rounded = (size + align - 1) / align * align;
+    if (rounded == 0) rounded = align;
+    note(size);
+    for (;;) {
+        if (void* p = std::aligned_alloc(align, rounded)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace AllocTracker
+
+#if defined(HAS_ALLOC_TRACKING)
+
+/**
+ * @brief Defines the replacement global operator new/delete
+ * Expand exactly once, at namespace scope, in the executable's one
+ * translation unit (main.cpp). Replacement functions may not be inline.
+ */
+#define BITEA_ALLOC_HOOKS()                                                                        \
+    void* operator new(std::size_t size) { return AllocTracker::allocate(size); }                  \
+    void* operator new[](std::size_t size) { return AllocTracker::allocate(size); }                \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                         \
+        try { return AllocTracker::allocate(size); } catch (...) { return nullptr; }               \
+    }                                                                                              \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {                       \
+        try { return AllocTracker::allocate(size); } catch (...) { return nullptr; }               \
+    }                                                                                              \
+    void* operator new(std::size_t size, std::align_val_t al) {                                    \
+        return AllocTracker::allocateAligned(size, al);                                            \
+    }                                                                                              \
+    void* operator new[](std::size_t size, std::align_val_t al) {                                  \
+        return AllocTracker::allocateAligned(size, al);                                            \
+    }                                                                                              \
+    void operator delete(void* p) noexcept { std::free(p); }                                       \
+    void operator delete[](void* p) noexcept { std::free(p); }                                     \
+    void operator delete(void* p, std::size_t) noexcept { std::free(p); }                          \
+    void operator delete[](void* p, std::size_t) noexcept { std::free(p); }                        \
+    void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }                     \
+    void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }                   \
+    void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }        \
+    void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }      \
+    static_assert(true, "")
+
+#else
+
+#define BITEA_ALLOC_HOOKS() static_assert(true, "")
+
+#endif
+
+#endif // ALLOCTRACKER_H
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * BASE64URL.H - URL-Safe Base64 Without Padding (RFC 4648 section 5)
+ *
+ * PURPOSE:
+ * Opaque tokens handed to clients travel in query strings and headers, so
+ * they use the URL-safe alphabet ('-' and '_' instead of '+' and '/') and
+ * drop the '=' padding. One codec for every such token.
+ *
+ * USED BY:
+ * - FeedCursor (database/FeedCursor.h): feed pagination cursors
+ * - SessionTokenSigner (utils/SessionToken.h): signed session tokens
+ *
+ * DECODING:
+ * Strict: any character outside the alphabet, or a length that no
+ * unpadded encoding produces (size % 4 == 1), is rejected. Callers apply
+ * their own size limits before decoding.
+ ******************************************************************************/
+
+#ifndef BASE64URL_H
+#define BASE64URL_H
+
+#include <cstdint>      // uint8_t, uint32_t - bit packing
+#include <string>       // std::string - encoded / decoded output
+#include <string_view>  // std::string_view - input without copying
+
+/** @brief Encodes raw bytes as unpadded base64url */
+inline std::string base64UrlEncode(std::string_view raw) {
+    static const char ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string out;
+    out.reserve((raw.size() * 4 + 2) / 3);
+    size_t i = 0;
+    for (; i + 3 <= raw.size(); i += 3) {
+        uint32_t v = (static_cast<uint8_t>(raw[i]) << 16) |
+                     (static_cast<uint8_t>(raw[i + 1]) << 8) |
+                     static_cast<uint8_t>(raw[i + 2]);
+        out += ALPHABET[(v >> 18) & 63];
+        out += ALPHABET[(v >> 12) & 63];
+        out += ALPHABET[(v >> 6) & 63];
+        out += ALPHABET[v & 63];
+    }
+    size_t rest = raw.size() - i;
+    if (rest > 0) {
+        uint32_t v = static_cast<uint8_t>(raw[i]) << 16;
+        if (rest == 2) v |= static_cast<uint8_t>(raw[i + 1]) << 8;
+        out += ALPHABET[(v >> 18) & 63];
+        out += ALPHABET[(v >> 12) & 63];
+        if (rest == 2) out += ALPHABET[(v >> 6) & 63];
+    }
+    return out;
+}
+
+/**
+ * @brief Decodes unpadded base64url
+ * @return false if the text is empty or not valid base64url
+ */
+inline bool base64UrlDecode(std::string_view text, std::string& raw) {
+    if (text.empty() || text.size() % 4 == 1) return false;
+    raw.clear();
+    raw.reserve(text.size() * 3 / 4);
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : text) {
+        int v;
+        if (c >= 'A' && c <= 'Z') v = c - 'A';
+        else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') v = c - '0' + 52;
+        else if (c == '-') v = 62;
+        else if (c == '_') v = 63;
+        else return false;
+        buffer = (buffer << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            raw += static_cast<char>((buffer >> bits) & 0xFF);
+        }
+    }
+    return true;
+}
+
+#endif // BASE64URL_H
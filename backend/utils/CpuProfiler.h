@@ -0,0 +1,290 @@
+/*******************************************************************************
+ * CPUPROFILER.H - On-Demand Sampling CPU Profiler (Folded Stacks)
+ *
+ * PURPOSE:
+ * Profiles the running server without attaching perf: GET /debug/profile
+ * samples every thread for N seconds and returns folded stacks, the input
+ * format of flamegraph.pl, speedscope and inferno.
+ *
+ * MECHANISM:
+ * - setitimer(ITIMER_PROF) delivers SIGPROF in proportion to process CPU
+ *   time; the kernel picks the thread that is running, so busy threads are
+ *   sampled and idle ones are not
+ * - The SIGPROF handler only calls backtrace() into a preallocated slot
+ *   (claimed with one atomic increment) and records the thread id; no
+ *   allocation, no locks
+ * - After the window the timer is disarmed and stacks are symbolized with
+ *   dladdr() + __cxa_demangle; the executable must export its symbols
+ *   (CMake: ENABLE_EXPORTS, i.e. -rdynamic)
+ *
+ * BOUNDED IMPACT:
+ * - One profile at a time (a second request gets false → 409)
+ * - seconds clamped to [1, 60], frequency to [1, 1000] Hz (default 99)
+ * - Sample buffer sized to 2 * seconds * hz (several busy cores can fire
+ *   more often than hz of wall time), capped at MAX_SAMPLES; extra
+ *   samples are counted as dropped
+ * - SA_RESTART is set, so most interrupted syscalls resume transparently;
+ *   sockets with SO_RCVTIMEO can still see EINTR and are retried by
+ *   HttpServer
+ *
+ * OUTPUT LINE FORMAT:
+ * thread-name;outer_frame;...;leaf_frame <samples>
+ ******************************************************************************/
+
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+
+#include <algorithm>   // std::sort, std::min, std::max - clamping, output order
+#include <atomic>      // std::atomic - slot claim, active flag
+#include <cerrno>      // errno - preserved across the signal handler
+#include <chrono>      // std::chrono - profile window
+#include <cstdint>     // fixed-width integers
+#include <cstdio>      // fopen, snprintf - thread names, raw addresses
+#include <cstdlib>     // free - __cxa_demangle result
+#include <cstring>     // strlen, strrchr, memset
+#include <map>         // std::map - folded-stack aggregation
+#include <string>      // std::string - frames, output
+#include <thread>      // std::this_thread::sleep_for - profile window
+#include <unordered_map>  // std::unordered_map - symbol cache
+#include <vector>      // std::vector - sample buffer
+
+#include <cxxabi.h>    // abi::__cxa_demangle - readable C++ names
+#include <dlfcn.h>     // dladdr - address → symbol
+#include <execinfo.h>  // backtrace - stack capture
+#include <signal.h>    // sigaction, SIGPROF
+#include <sys/time.h>  // setitimer, ITIMER_PROF
+#include <unistd.h>    // syscall
+#if defined(__linux__)
+#include <sys/syscall.h>  // SYS_gettid - per-thread attribution
+#endif
+
+/**
+ * @struct ProfileResult
+ * @brief Output of one profiling window
+ */
+struct ProfileResult {
+    std::string folded;        // Folded stacks, most frequent first
+    uint64_t samples = 0;      // Samples in folded (complete stacks only)
+    uint64_t dropped = 0;      // Samples lost to a full buffer
+    int seconds = 0;           // Window actually used (after clamping)
+    int hz = 0;                // Frequency actually used
+};
+
+/**
+ * @class CpuProfiler
+ * @brief SIGPROF-driven sampler (singleton; one profile at a time)
+ */
+class CpuProfiler {
+public:
+    static constexpr int MAX_FRAMES = 48;
+    static constexpr size_t MAX_SAMPLES = 60000;
+    static constexpr int MAX_SECONDS = 60;     // Longest profiling window
+    static constexpr int MAX_HZ = 1000;        // Highest sampling frequency
+
+    static CpuProfiler& instance() {
+        static CpuProfiler* profiler = new CpuProfiler();
+        return *profiler;
+    }
+
+    /** @brief True while a profiling window is open */
+    bool isRunning() const { return busy.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Samples all threads for a window (blocks the caller)
+     * @param seconds Window length (clamped to 1..MAX_SECONDS)
+     * @param hz Sampling frequency (clamped to 1..MAX_HZ)
+     * @param result Output folded stacks and counters
+     * @return bool - false if another profile is already running
+     */
+    bool profile(int seconds, int hz, ProfileResult& result) {
+        bool expected = false;
+        if (!busy.compare_exchange_strong(expected, true)) return false;
+
+        seconds = std::min(std::max(seconds, 1), MAX_SECONDS);
+        hz = std::min(std::max(hz, 1), MAX_HZ);
+        result.seconds = seconds;
+        result.hz = hz;
+
+        // Buffer for the whole window, allocated before the timer starts
+        size_t capacity = std::min(MAX_SAMPLES, static_cast<size_t>(seconds) * static_cast<size_t>(hz) * 2);
+        std::vector<Sample> buffer(capacity);
+        samples = buffer.data();
+        sampleCapacity = capacity;
+        nextSample.store(0, std::memory_order_relaxed);
+        droppedSamples.store(0, std::memory_order_relaxed);
+
+        // backtrace() loads libgcc on first use: do it outside the handler
+        void* warmup[4];
+        backtrace(warmup, 4);
+
+        installHandler();
+        active.store(true, std::memory_order_release);
+        setTimer(1000000 / hz);
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+        setTimer(0);
+        active.store(false, std::memory_order_release);
+        // A handler that already claimed a slot may still be writing it
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        size_t captured = std::min(nextSample.load(std::memory_order_acquire), capacity);
+        result.dropped = droppedSamples.load(std::memory_order_relaxed);
+        result.samples = fold(buffer.data(), captured, result.folded);
+
+        samples = nullptr;
+        sampleCapacity = 0;
+        busy.store(false, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /**
+     * @struct Sample
+     * @brief One captured stack (written by the signal handler)
+     */
+    struct Sample {
+        std::atomic<bool> ready{false};   // Set after frames are written
+        int depth = 0;
+        long tid = 0;
+        void* frames[MAX_FRAMES];
+    };
+
+    std::atomic<bool> busy{false};             // A profile is running
+    std::atomic<bool> active{false};           // Handler should record
+    Sample* samples = nullptr;                 // Current buffer
+    size_t sampleCapacity = 0;
+    std::atomic<size_t> nextSample{0};         // Next free slot
+    std::atomic<uint64_t> droppedSamples{0};
+    bool handlerInstalled = false;
+
+    CpuProfiler() = default;
+
+    static void onSignal(int) {
+        int savedErrno = errno;
+        CpuProfiler& self = instance();
+        if (self.active.load(std::memory_order_acquire)) {
+            size_t slot = self.nextSample.fetch_add(1, std::memory_order_relaxed);
+            if (slot < self.sampleCapacity) {
+                Sample& s = self.samples[slot];
+                s.depth = backtrace(s.frames, MAX_FRAMES);
+#if defined(__linux__)
+                s.tid = static_cast<long>(syscall(SYS_gettid));
+#endif
+                s.ready.store(true, std::memory_order_release);
+            } else {
+                self.droppedSamples.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        errno = savedErrno;
+    }
+
+    void installHandler() {
+        if (handlerInstalled) return;
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = &CpuProfiler::onSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, nullptr);
+        handlerInstalled = true;
+    }
+
+    static void setTimer(long intervalMicros) {
+        struct itimerval timer;
+        timer.it_interval.tv_sec = intervalMicros / 1000000;
+        timer.it_interval.tv_usec = intervalMicros % 1000000;
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_PROF, &timer, nullptr);
+    }
+
+    /** @brief Thread name from /proc (Linux), else "thread-<tid>" */
+    static std::string threadName(long tid) {
+#if defined(__linux__)
+        std::string path = "/proc/self/task/" + std::to_string(tid) + "/comm";
+        if (FILE* f = fopen(path.c_str(), "r")) {
+            char name[64] = {0};
+            if (fgets(name, sizeof(name), f)) {
+                size_t n = strlen(name);
+                if (n > 0 && name[n - 1] == '\n') name[n - 1] = '\0';
+            }
+            fclose(f);
+            if (name[0]) return name;
+        }
+#endif
+        return "thread-" + std::to_string(tid);
+    }
+
+    /** @brief Demangled function name for an address (frames are cached) */
+    static std::string symbolize(void* address) {
+        Dl_info info;
+        if (dladdr(address, &info) && info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+            free(demangled);
+            // ';' separates frames in the folded format
+            for (char& c : name) if (c == ';') c = ':';
+            return name;
+        }
+        char hex[32];
+        if (dladdr(address, &info) && info.dli_fname) {
+            // Module-relative offset: stable across runs, usable with addr2line
+            uintptr_t offset = reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+            snprintf(hex, sizeof(hex), "0x%zx", static_cast<size_t>(offset));
+            const char* base = strrchr(info.dli_fname, '/');
+            return std::string(base ? base + 1 : info.dli_fname) + "+" + hex;
+        }
+        snprintf(hex, sizeof(hex), "%p", address);
+        return hex;
+    }
+
+    /**
+     * @brief Aggregates samples into folded stacks, most frequent first
+     * @param out Folded stacks
+     * @return size_t - Samples folded (claimed slots never marked ready
+     *         are skipped and not counted)
+     */
+    static size_t fold(const Sample* buffer, size_t count, std::string& out) {
+        std::unordered_map<void*, std::string> symbols;
+        std::unordered_map<long, std::string> threads;
+        std::map<std::string, uint64_t> stacks;
+        size_t folded = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            const Sample& s = buffer[i];
+            if (!s.ready.load(std::memory_order_acquire)) continue;
+            folded++;
+
+            auto thread = threads.find(s.tid);
+            if (thread == threads.end()) thread = threads.emplace(s.tid, threadName(s.tid)).first;
+
+            std::string line = thread->second;
+            // frames[0] is the handler, frames[1] the signal trampoline
+            for (int f = s.depth - 1; f >= 2; f--) {
+                // Return addresses point after the call; -1 lands inside it
+                void* pc = static_cast<char*>(s.frames[f]) - 1;
+                auto symbol = symbols.find(s.frames[f]);
+                if (symbol == symbols.end()) symbol = symbols.emplace(s.frames[f], symbolize(pc)).first;
+                line += ';';
+                line += symbol->second;
+            }
+            stacks[line]++;
+        }
+
+        std::vector<std::pair<std::string, uint64_t>> ordered(stacks.begin(), stacks.end());
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        out.clear();
+        for (const auto& entry : ordered) {
+            out += entry.first;
+            out += ' ';
+            out += std::to_string(entry.second);
+            out += '\n';
+        }
+        return folded;
+    }
+};
+
+#endif // CPUPROFILER_H
@@ -141,8 +141,9 @@ public:
         
         for (char c : input) {
             // Remove control characters except newline and tab
-            // Control chars: 0-31 (non-printable)
-            if (c < 32 && c != '\n' && c != '\t') {
+            // Control chars: 0-31 (non-printable); unsigned so UTF-8 bytes
+            // (0x80-0xFF, negative as signed char) are kept
+            if (static_cast<unsigned char>(c) < 32 && c != '\n' && c != '\t') {
                 continue;  // Skip this character
             }
             
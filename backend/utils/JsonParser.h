@@ -0,0 +1,516 @@
+/*******************************************************************************
+ * JSONPARSER.H - Single-Pass JSON Request Body Parser
+ *
+ * PURPOSE:
+ * Parses a request body once into a flat tape of top-level fields so route
+ * handlers can read any field in O(1), instead of re-scanning the raw body
+ * for every key.
+ *
+ * TAPE:
+ * - One JsonField (key, value, type) per top-level member, in body order
+ * - Strings are unescaped (\" \\ \/ \b \f \n \r \t \uXXXX incl. surrogate
+ *   pairs → UTF-8); values without escapes point straight into the body,
+ *   escaped ones into an arena reserved up front (never reallocated, so
+ *   views stay valid)
+ * - Numbers, true/false/null: raw text; nested objects/arrays: validated
+ *   and kept as their raw text slice
+ * - Key lookup: open-addressing index (FNV-1a), duplicate keys → last wins
+ *
+ * SIMD:
+ * String scanning (the bulk of a request body) looks for '"', '\\' and
+ * control characters 16 bytes at a time with SSE2 where available
+ * (always on x86-64), with a scalar fallback elsewhere.
+ *
+ * LIFETIME:
+ * Views point into the parsed text and the document's own arena: keep the
+ * request body alive and don't reuse the document while using them.
+ *
+ * LIMITS:
+ * - Top level must be an object with at most MAX_FIELDS members
+ *   (or, via parseArray(), an array with at most MAX_FIELDS elements)
+ * - Nesting depth at most MAX_DEPTH
+ * Anything else (trailing garbage, bad escapes, raw control characters in
+ * strings, malformed numbers) → parse() returns false with getError()
+ ******************************************************************************/
+
+#ifndef JSONPARSER_H
+#define JSONPARSER_H
+
+#include <charconv>    // std::from_chars - integer fields without copying
+#include <cstddef>     // size_t
+#include <cstdint>     // uint8_t, uint32_t, int64_t
+#include <string>      // std::string - unescape arena
+#include <string_view> // std::string_view - zero-copy fields
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // SSE2 - 16-byte string scanning
+#endif
+
+/**
+ * @enum JsonType
+ * @brief Type of a top-level field value
+ */
+enum class JsonType {
+    STRING,
+    NUMBER,
+    BOOLEAN,
+    NULL_VALUE,
+    OBJECT,
+    ARRAY
+};
+
+/**
+ * @struct JsonField
+ * @brief One top-level member of the parsed object
+ */
+struct JsonField {
+    std::string_view key;      // Unescaped
+    std::string_view value;    // Unescaped for STRING, raw text otherwise
+    JsonType type;
+};
+
+/**
+ * @brief Offset of the first '"', '\\' or control character (< 0x20)
+ * @return size_t - Index in [0, length], length if none
+ */
+inline size_t jsonScanString(const char* data, size_t length) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        // Unsigned c <= 0x1F  <=>  max(c, 0x1F) == 0x1F
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        i += 16;
+    }
+#endif
+    for (; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c == '"' || c == '\\' || c < 0x20) return i;
+    }
+    return length;
+}
+
+/**
+ * @class JsonDocument
+ * @brief Parsed top-level JSON object with O(1) field lookup
+ *
+ * USAGE:
+ *   JsonDocument body;
+ *   if (!body.parse(req.body)) { 400 }
+ *   std::string_view name = body.getString("username");
+ */
+class JsonDocument {
+public:
+    static constexpr size_t MAX_FIELDS = 64;
+    static constexpr int MAX_DEPTH = 32;
+
+    JsonDocument() : fieldCount(0), error(nullptr), errorOffset(0) {}
+
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    /**
+     * @brief Parses text as one JSON object
+     * @return bool - false if text is not a valid JSON object (see getError())
+     */
+    bool parse(std::string_view text) {
+        reset(text);
+        if (!expect('{', "expected '{'")) return false;
+        skipWhitespace();
+        if (peek() == '}') {
+            pos++;
+        } else {
+            for (;;) {
+                skipWhitespace();
+                if (peek() != '"') return fail("expected field name");
+                std::string_view key;
+                if (!parseString(key)) return false;
+                skipWhitespace();
+                if (!expect(':', "expected ':'")) return false;
+                skipWhitespace();
+
+                JsonField field;
+                field.key = key;
+                if (!parseValue(field, 1)) return false;
+                if (!addField(field)) return false;
+
+                skipWhitespace();
+                if (peek() == ',') { pos++; continue; }
+                if (!expect('}', "expected ',' or '}'")) return false;
+                break;
+            }
+        }
+        skipWhitespace();
+        if (pos != input.size()) return fail("trailing characters");
+        return true;
+    }
+
+    /**
+     * @brief Parses text as one JSON array (e.g. a nested ARRAY field value)
+     * Elements land in field(0..size()-1) in order with empty keys, typed
+     * and decoded like field values; find() does not apply
+     * @return bool - false if text is not a valid array of at most
+     *                MAX_FIELDS elements (see getError())
+     */
+    bool parseArray(std::string_view text) {
+        reset(text);
+        if (!expect('[', "expected '['")) return false;
+        skipWhitespace();
+        if (peek() == ']') {
+            pos++;
+        } else {
+            for (;;) {
+                skipWhitespace();
+                if (fieldCount >= MAX_FIELDS) return fail("too many elements");
+                JsonField& element = fields[fieldCount];
+                element.key = std::string_view();
+                if (!parseValue(element, 1)) return false;
+                fieldCount++;
+
+                skipWhitespace();
+                if (peek() == ',') { pos++; continue; }
+                if (!expect(']', "expected ',' or ']'")) return false;
+                break;
+            }
+        }
+        skipWhitespace();
+        if (pos != input.size()) return fail("trailing characters");
+        return true;
+    }
+
+    /** @brief Field by key, nullptr if absent */
+    const JsonField* find(std::string_view key) const {
+        uint32_t mask = INDEX_SIZE - 1;
+        for (uint32_t slot = hashKey(key) & mask;; slot = (slot + 1) & mask) {
+            uint8_t entry = index[slot];
+            if (entry == 0) return nullptr;
+            if (fields[entry - 1].key == key) return &fields[entry - 1];
+        }
+    }
+
+    bool has(std::string_view key) const { return find(key) != nullptr; }
+
+    /** @brief String value, "" if absent or not a string */
+    std::string_view getString(std::string_view key) const {
+        const JsonField* field = find(key);
+        return field && field->type == JsonType::STRING ? field->value : std::string_view();
+    }
+
+    /** @brief Integer value; false if absent, not a number or not an integer */
+    bool getInt64(std::string_view key, int64_t& out) const {
+        const JsonField* field = find(key);
+        if (!field || field->type != JsonType::NUMBER) return false;
+        const char* first = field->value.data();
+        const char* last = first + field->value.size();
+        int64_t value = 0;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || result.ptr != last) return false;
+        out = value;
+        return true;
+    }
+
+    /** @brief Boolean value; false if absent or not a boolean */
+    bool getBool(std::string_view key, bool& out) const {
+        const JsonField* field = find(key);
+        if (!field || field->type != JsonType::BOOLEAN) return false;
+        out = field->value == "true";
+        return true;
+    }
+
+    size_t size() const { return fieldCount; }
+    const JsonField& field(size_t i) const { return fields[i]; }
+
+    /** @brief Reason for the last parse() failure, nullptr after success */
+    const char* getError() const { return error; }
+    size_t getErrorOffset() const { return errorOffset; }
+
+private:
+    static constexpr uint32_t INDEX_SIZE = 128;   // Power of two, 2x MAX_FIELDS
+
+    std::string_view input;
+    size_t pos = 0;
+    std::string arena;                 // Unescaped strings (reserved, stable)
+    JsonField fields[MAX_FIELDS];
+    size_t fieldCount;
+    uint8_t index[INDEX_SIZE] = {};    // 0 = empty, else field index + 1
+    const char* error;
+    size_t errorOffset;
+
+    static uint32_t hashKey(std::string_view key) {
+        uint32_t h = 2166136261u;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /** @brief Starts a new parse of text (positioned at its first token) */
+    void reset(std::string_view text) {
+        input = text;
+        pos = 0;
+        fieldCount = 0;
+        error = nullptr;
+        errorOffset = 0;
+        for (uint8_t& slot : index) slot = 0;
+        arena.clear();
+        // Unescaped text is never longer than the input: one reservation
+        // keeps every view into the arena valid
+        if (arena.capacity() < text.size()) arena.reserve(text.size());
+        skipWhitespace();
+    }
+
+    bool fail(const char* message) {
+        error = message;
+        errorOffset = pos;
+        return false;
+    }
+
+    char peek() const { return pos < input.size() ? input[pos] : '\0'; }
+
+    bool expect(char c, const char* message) {
+        if (peek() != c) return fail(message);
+        pos++;
+        return true;
+    }
+
+    void skipWhitespace() {
+        while (pos < input.size()) {
+            char c = input[pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+            pos++;
+        }
+    }
+
+    bool addField(const JsonField& field) {
+        uint32_t mask = INDEX_SIZE - 1;
+        for (uint32_t slot = hashKey(field.key) & mask;; slot = (slot + 1) & mask) {
+            uint8_t entry = index[slot];
+            if (entry == 0) {
+                if (fieldCount >= MAX_FIELDS) return fail("too many fields");
+                fields[fieldCount] = field;
+                index[slot] = static_cast<uint8_t>(++fieldCount);
+                return true;
+            }
+            if (fields[entry - 1].key == field.key) {
+                fields[entry - 1] = field;   // Duplicate key: last wins
+                return true;
+            }
+        }
+    }
+
+    bool parseValue(JsonField& field, int depth) {
+        size_t start = pos;
+        char c = peek();
+        if (c == '"') {
+            field.type = JsonType::STRING;
+            return parseString(field.value);
+        }
+        if (c == '{' || c == '[') {
+            field.type = c == '{' ? JsonType::OBJECT : JsonType::ARRAY;
+            if (!skipContainer(depth)) return false;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            field.type = JsonType::NUMBER;
+            if (!skipNumber()) return false;
+        } else if (matchLiteral("true") || matchLiteral("false")) {
+            field.type = JsonType::BOOLEAN;
+        } else if (matchLiteral("null")) {
+            field.type = JsonType::NULL_VALUE;
+        } else {
+            return fail("unexpected character");
+        }
+        field.value = input.substr(start, pos - start);
+        return true;
+    }
+
+    bool matchLiteral(std::string_view literal) {
+        if (input.substr(pos, literal.size()) != literal) return false;
+        pos += literal.size();
+        return true;
+    }
+
+    /** @brief number = -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)? */
+    bool skipNumber() {
+        auto digit = [this] { return pos < input.size() && input[pos] >= '0' && input[pos] <= '9'; };
+        if (peek() == '-') pos++;
+        if (peek() == '0') {
+            pos++;
+        } else if (digit()) {
+            while (digit()) pos++;
+        } else {
+            return fail("invalid number");
+        }
+        if (peek() == '.') {
+            pos++;
+            if (!digit()) return fail("invalid number");
+            while (digit()) pos++;
+        }
+        if (peek() == 'e' || peek() == 'E') {
+            pos++;
+            if (peek() == '+' || peek() == '-') pos++;
+            if (!digit()) return fail("invalid number");
+            while (digit()) pos++;
+        }
+        return true;
+    }
+
+    /** @brief Validates a nested object/array without building a tape for it */
+    bool skipContainer(int depth) {
+        if (depth > MAX_DEPTH) return fail("nesting too deep");
+        char open = input[pos++];
+        char close = open == '{' ? '}' : ']';
+        skipWhitespace();
+        if (peek() == close) {
+            pos++;
+            return true;
+        }
+        for (;;) {
+            skipWhitespace();
+            if (open == '{') {
+                if (peek() != '"') return fail("expected field name");
+                if (!skipString()) return false;
+                skipWhitespace();
+                if (!expect(':', "expected ':'")) return false;
+                skipWhitespace();
+            }
+            JsonField nested;
+            char c = peek();
+            if (c == '"') {
+                if (!skipString()) return false;
+            } else if (!parseValue(nested, depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (peek() == ',') { pos++; continue; }
+            if (peek() == close) { pos++; return true; }
+            return fail(open == '{' ? "expected ',' or '}'" : "expected ',' or ']'");
+        }
+    }
+
+    /** @brief Validates a string (escapes checked, nothing copied) */
+    bool skipString() {
+        pos++;   // Opening quote
+        for (;;) {
+            pos += jsonScanString(input.data() + pos, input.size() - pos);
+            char c = peek();
+            if (pos >= input.size()) return fail("unterminated string");
+            if (c == '"') { pos++; return true; }
+            if (c != '\\') return fail("control character in string");
+            if (!decodeEscape(nullptr)) return false;
+        }
+    }
+
+    /**
+     * @brief Parses a string starting at the opening quote
+     * Escape-free strings are returned as a view into the input; otherwise
+     * the unescaped text is appended to the arena
+     */
+    bool parseString(std::string_view& out) {
+        size_t start = ++pos;
+        pos += jsonScanString(input.data() + pos, input.size() - pos);
+        if (pos >= input.size()) return fail("unterminated string");
+        if (input[pos] == '"') {
+            out = input.substr(start, pos - start);
+            pos++;
+            return true;
+        }
+
+        // Slow path: copy the clean prefix, then unescape chunk by chunk
+        size_t arenaStart = arena.size();
+        arena.append(input.data() + start, pos - start);
+        for (;;) {
+            char c = input[pos];
+            if (c == '"') {
+                pos++;
+                out = std::string_view(arena.data() + arenaStart, arena.size() - arenaStart);
+                return true;
+            }
+            if (c != '\\') return fail("control character in string");
+            if (!decodeEscape(&arena)) return false;
+            size_t run = jsonScanString(input.data() + pos, input.size() - pos);
+            arena.append(input.data() + pos, run);
+            pos += run;
+            if (pos >= input.size()) return fail("unterminated string");
+        }
+    }
+
+    /**
+     * @brief Decodes one escape sequence at pos (pointing at '\\')
+     * @param out Destination for the decoded bytes, nullptr to only validate
+     */
+    bool decodeEscape(std::string* out) {
+        pos++;   // Backslash
+        if (pos >= input.size()) return fail("unterminated string");
+        char c = input[pos++];
+        char decoded;
+        switch (c) {
+            case '"': decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/': decoded = '/'; break;
+            case 'b': decoded = '\b'; break;
+            case 'f': decoded = '\f'; break;
+            case 'n': decoded = '\n'; break;
+            case 'r': decoded = '\r'; break;
+            case 't': decoded = '\t'; break;
+            case 'u': return decodeUnicode(out);
+            default: return fail("invalid escape");
+        }
+        if (out) out->push_back(decoded);
+        return true;
+    }
+
+    bool readHex4(uint32_t& value) {
+        if (input.size() - pos < 4) return fail("invalid \\u escape");
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char h = input[pos++];
+            value <<= 4;
+            if (h >= '0' && h <= '9') value |= static_cast<uint32_t>(h - '0');
+            else if (h >= 'a' && h <= 'f') value |= static_cast<uint32_t>(h - 'a' + 10);
+            else if (h >= 'A' && h <= 'F') value |= static_cast<uint32_t>(h - 'A' + 10);
+            else return fail("invalid \\u escape");
+        }
+        return true;
+    }
+
+    /** @brief \uXXXX (after the 'u'), joining surrogate pairs, as UTF-8 */
+    bool decodeUnicode(std::string* out) {
+        uint32_t code;
+        if (!readHex4(code)) return false;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low;
+            if (input.substr(pos, 2) != "\\u") return fail("unpaired surrogate");
+            pos += 2;
+            if (!readHex4(low)) return false;
+            if (low < 0xDC00 || low > 0xDFFF) return fail("unpaired surrogate");
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return fail("unpaired surrogate");
+        }
+        if (!out) return true;
+        if (code < 0x80) {
+            out->push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+};
+
+#endif // JSONPARSER_H
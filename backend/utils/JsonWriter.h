@@ -0,0 +1,418 @@
+/*******************************************************************************
+ * JSONWRITER.H - Append-Only JSON / CBOR / MessagePack Serializer
+ *
+ * PURPOSE:
+ * Builds JSON by appending straight into a caller-provided std::string
+ * (typically HttpResponse::body), replacing std::stringstream + per-model
+ * escapeJson(). A feed of N posts is written into one buffer with no
+ * intermediate strings per post.
+ *
+ * The same calls can emit the JSON data model in a binary encoding
+ * (WireFormat), so models serialize once for every format:
+ * - CBOR (RFC 8949): maps/arrays use indefinite length (0xBF/0x9F ... 0xFF),
+ *   strings and integers are definite, minimal-length
+ * - MessagePack: containers get a 32-bit count placeholder that close()
+ *   patches; while the container is still in the staging buffer the
+ *   header is shrunk to the minimal fixmap/fixarray/16-bit form
+ * Strings are length-prefixed and copied verbatim (no escaping).
+ *
+ * DESIGN:
+ * - Tokens are staged in a small inline buffer and copied to the output
+ *   in STAGING_SIZE chunks, so a field costs a few memcpy()s instead of a
+ *   std::string::append() per token
+ * - The staging buffer is flushed when the top-level value closes, when it
+ *   fills up, on flush(), and on destruction
+ * - Commas are inserted automatically (one "first element" flag per
+ *   nesting level, MAX_DEPTH levels)
+ * - Integers via std::to_chars (no locale, no stream state)
+ * - String escaping skips clean runs 16 bytes at a time using
+ *   jsonScanString() (utils/JsonParser.h, SSE2 where available) and only
+ *   handles the bytes that need escaping individually
+ * - Every control character is escaped (\b \f \n \r \t, others \u00XX),
+ *   so output is always valid JSON
+ *
+ * USAGE:
+ *   JsonWriter w(res.jsonBuffer(), res.format);
+ *   w.beginObject().field("name", "Bitea").field("blocks", 12).endObject();
+ *
+ * The output string is complete once the outermost endObject()/endArray()
+ * returns. The writer does not validate structure (e.g. a value without a
+ * key inside an object); callers are the models and route handlers.
+ ******************************************************************************/
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <charconv>    // std::to_chars - integer formatting
+#include <cstdint>     // uint8_t, uint32_t, uint64_t - binary headers
+#include <cstring>     // std::memcpy, std::memmove - staging buffer copies
+#include <string>      // std::string - output buffer
+#include <string_view> // std::string_view - keys and string values
+#include <type_traits> // std::is_integral - integer overload
+
+#include "JsonParser.h"  // jsonScanString - vectorized special-byte scan
+
+/**
+ * @enum WireFormat
+ * @brief Encodings JsonWriter can produce (chosen per response from Accept)
+ */
+enum class WireFormat {
+    JSON,     // application/json (default)
+    CBOR,     // application/cbor
+    MSGPACK   // application/msgpack
+};
+
+/** @brief Content-Type for a wire format */
+inline const char* wireFormatContentType(WireFormat format) {
+    switch (format) {
+        case WireFormat::CBOR: return "application/cbor";
+        case WireFormat::MSGPACK: return "application/msgpack";
+        default: return "application/json";
+    }
+}
+
+/**
+ * @class JsonWriter
+ * @brief Streams JSON-model tokens into a std::string it does not own
+ */
+class JsonWriter {
+public:
+    static constexpr int MAX_DEPTH = 32;
+    static constexpr size_t STAGING_SIZE = 1024;
+
+    explicit JsonWriter(std::string& out, WireFormat format = WireFormat::JSON)
+        : out(out), format(format), used(0), depth(0), afterKey(false) {
+        first[0] = true;
+        count[0] = 0;
+    }
+
+    ~JsonWriter() { flush(); }
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    /** @brief Grows the buffer up front when the final size is roughly known */
+    JsonWriter& reserve(size_t bytes) {
+        out.reserve(out.size() + used + bytes);
+        return *this;
+    }
+
+    /** @brief Moves staged bytes into the output string */
+    void flush() {
+        if (used > 0) {
+            out.append(staging, used);
+            used = 0;
+        }
+    }
+
+    JsonWriter& beginObject() { return open(true); }
+    JsonWriter& endObject() { return close(); }
+    JsonWriter& beginArray() { return open(false); }
+    JsonWriter& endArray() { return close(); }
+
+    /** @brief Writes "key": (the next call writes its value) */
+    JsonWriter& key(std::string_view name) {
+        separator();
+        writeString(name);
+        if (format == WireFormat::JSON) putChar(':');
+        afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view text) {
+        separator();
+        writeString(text);
+        return *this;
+    }
+
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+
+    JsonWriter& value(bool flag) {
+        separator();
+        switch (format) {
+            case WireFormat::CBOR: putChar(static_cast<char>(flag ? 0xF5 : 0xF4)); break;
+            case WireFormat::MSGPACK: putChar(static_cast<char>(flag ? 0xC3 : 0xC2)); break;
+            default:
+                if (flag) put("true", 4);
+                else put("false", 5);
+        }
+        return *this;
+    }
+
+    /** @brief Any integer type (int, size_t, time_t, ...) */
+    template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& value(T number) {
+        separator();
+        if (format == WireFormat::JSON) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), number);
+            put(digits, static_cast<size_t>(result.ptr - digits));
+            return *this;
+        }
+        if constexpr (std::is_signed<T>::value) {
+            if (number < 0) {
+                writeNegative(static_cast<int64_t>(number));
+                return *this;
+            }
+        }
+        writeUnsigned(static_cast<uint64_t>(number));
+        return *this;
+    }
+
+    JsonWriter& null() {
+        separator();
+        switch (format) {
+            case WireFormat::CBOR: putChar(static_cast<char>(0xF6)); break;
+            case WireFormat::MSGPACK: putChar(static_cast<char>(0xC0)); break;
+            default: put("null", 4);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Inserts one value already encoded in this writer's format
+     * (e.g. a sub-response body); the bytes are copied unchecked
+     */
+    JsonWriter& raw(std::string_view encoded) {
+        separator();
+        put(encoded.data(), encoded.size());
+        return *this;
+    }
+
+    /** @brief key(name) + value(v) */
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+private:
+    std::string& out;
+    WireFormat format;
+    char staging[STAGING_SIZE];    // Tokens not yet copied to 'out'
+    size_t used;
+    bool first[MAX_DEPTH + 1];     // No element written yet at this level
+    bool isMap[MAX_DEPTH + 1];     // Object (true) or array at this level
+    uint32_t count[MAX_DEPTH + 1]; // MessagePack: keys/elements at this level
+    size_t headerAt[MAX_DEPTH + 1];// MessagePack: output offset of the header
+    int depth;
+    bool afterKey;                 // Next value belongs to the key just written
+
+    void putChar(char c) {
+        if (used == STAGING_SIZE) flush();
+        staging[used++] = c;
+    }
+
+    void put(const char* data, size_t length) {
+        if (used + length > STAGING_SIZE) {
+            flush();
+            if (length > STAGING_SIZE) {
+                out.append(data, length);  // Large runs bypass staging
+                return;
+            }
+        }
+        std::memcpy(staging + used, data, length);
+        used += length;
+    }
+
+    /** @brief Writes the low 'bytes' bytes of v, most significant first */
+    void putBigEndian(uint64_t v, int bytes) {
+        char buffer[8];
+        for (int i = bytes - 1; i >= 0; i--) {
+            buffer[i] = static_cast<char>(v & 0xFF);
+            v >>= 8;
+        }
+        put(buffer, static_cast<size_t>(bytes));
+    }
+
+    /** @brief CBOR head: major type + argument in minimal length */
+    void cborHead(uint8_t major, uint64_t v) {
+        uint8_t type = static_cast<uint8_t>(major << 5);
+        if (v < 24) {
+            putChar(static_cast<char>(type | v));
+        } else if (v <= 0xFF) {
+            putChar(static_cast<char>(type | 24));
+            putBigEndian(v, 1);
+        } else if (v <= 0xFFFF) {
+            putChar(static_cast<char>(type | 25));
+            putBigEndian(v, 2);
+        } else if (v <= 0xFFFFFFFFULL) {
+            putChar(static_cast<char>(type | 26));
+            putBigEndian(v, 4);
+        } else {
+            putChar(static_cast<char>(type | 27));
+            putBigEndian(v, 8);
+        }
+    }
+
+    void writeUnsigned(uint64_t v) {
+        if (format == WireFormat::CBOR) {
+            cborHead(0, v);
+        } else if (v < 0x80) {
+            putChar(static_cast<char>(v));                       // positive fixint
+        } else if (v <= 0xFF) {
+            putChar(static_cast<char>(0xCC)); putBigEndian(v, 1);
+        } else if (v <= 0xFFFF) {
+            putChar(static_cast<char>(0xCD)); putBigEndian(v, 2);
+        } else if (v <= 0xFFFFFFFFULL) {
+            putChar(static_cast<char>(0xCE)); putBigEndian(v, 4);
+        } else {
+            putChar(static_cast<char>(0xCF)); putBigEndian(v, 8);
+        }
+    }
+
+    void writeNegative(int64_t v) {
+        if (format == WireFormat::CBOR) {
+            cborHead(1, static_cast<uint64_t>(-(v + 1)));       // -1 - n, no overflow
+        } else if (v >= -32) {
+            putChar(static_cast<char>(v));                       // negative fixint
+        } else if (v >= -128) {
+            putChar(static_cast<char>(0xD0)); putBigEndian(static_cast<uint64_t>(v), 1);
+        } else if (v >= -32768) {
+            putChar(static_cast<char>(0xD1)); putBigEndian(static_cast<uint64_t>(v), 2);
+        } else if (v >= INT32_MIN) {
+            putChar(static_cast<char>(0xD2)); putBigEndian(static_cast<uint64_t>(v), 4);
+        } else {
+            putChar(static_cast<char>(0xD3)); putBigEndian(static_cast<uint64_t>(v), 8);
+        }
+    }
+
+    void separator() {
+        if (afterKey) {
+            afterKey = false;
+            return;
+        }
+        if (format == WireFormat::MSGPACK) count[depth]++;  // Keys count pairs
+        if (!first[depth] && format == WireFormat::JSON) putChar(',');
+        first[depth] = false;
+    }
+
+    JsonWriter& open(bool object) {
+        separator();
+        switch (format) {
+            case WireFormat::CBOR:
+                putChar(static_cast<char>(object ? 0xBF : 0x9F));  // Indefinite length
+                break;
+            case WireFormat::MSGPACK: {
+                // map32/array32 placeholder, count patched by close()
+                size_t at = out.size() + used;
+                putChar(static_cast<char>(object ? 0xDF : 0xDD));
+                putBigEndian(0, 4);
+                if (depth < MAX_DEPTH) headerAt[depth + 1] = at;
+                break;
+            }
+            default:
+                putChar(object ? '{' : '[');
+        }
+        if (depth < MAX_DEPTH) depth++;
+        first[depth] = true;
+        isMap[depth] = object;
+        count[depth] = 0;
+        return *this;
+    }
+
+    JsonWriter& close() {
+        switch (format) {
+            case WireFormat::CBOR: putChar(static_cast<char>(0xFF)); break;
+            case WireFormat::MSGPACK: patchHeader(); break;
+            default: putChar(isMap[depth] ? '}' : ']');
+        }
+        if (depth > 0) depth--;
+        if (depth == 0) flush();  // Top-level value complete
+        return *this;
+    }
+
+    /**
+     * @brief Fills in the MessagePack count of the container being closed
+     * Still staged: rewrite the header in minimal form and slide the body
+     * down. Already flushed: patch the 32-bit count in place.
+     */
+    void patchHeader() {
+        uint32_t n = count[depth];
+        bool object = isMap[depth];
+        size_t at = headerAt[depth];
+        size_t base = out.size();
+        if (at >= base) {
+            char* header = staging + (at - base);
+            size_t bodyLength = used - (at - base) - 5;
+            size_t headerLength;
+            if (n <= 15) {
+                header[0] = static_cast<char>((object ? 0x80 : 0x90) | n);
+                headerLength = 1;
+            } else if (n <= 0xFFFF) {
+                header[0] = static_cast<char>(object ? 0xDE : 0xDC);
+                header[1] = static_cast<char>(n >> 8);
+                header[2] = static_cast<char>(n & 0xFF);
+                headerLength = 3;
+            } else {
+                headerLength = 5;
+            }
+            if (headerLength < 5) {
+                std::memmove(header + headerLength, header + 5, bodyLength);
+                used -= 5 - headerLength;
+                return;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            char byte = static_cast<char>((n >> (8 * (3 - i))) & 0xFF);
+            size_t pos = at + 1 + static_cast<size_t>(i);
+            if (pos < base) out[pos] = byte;
+            else staging[pos - base] = byte;
+        }
+    }
+
+    void writeString(std::string_view text) {
+        if (format == WireFormat::CBOR) {
+            cborHead(3, text.size());
+            put(text.data(), text.size());
+            return;
+        }
+        if (format == WireFormat::MSGPACK) {
+            size_t n = text.size();
+            if (n <= 31) {
+                putChar(static_cast<char>(0xA0 | n));
+            } else if (n <= 0xFF) {
+                putChar(static_cast<char>(0xD9)); putBigEndian(n, 1);
+            } else if (n <= 0xFFFF) {
+                putChar(static_cast<char>(0xDA)); putBigEndian(n, 2);
+            } else {
+                putChar(static_cast<char>(0xDB)); putBigEndian(n, 4);
+            }
+            put(text.data(), n);
+            return;
+        }
+
+        static const char HEX[] = "0123456789abcdef";
+        putChar('"');
+        const char* data = text.data();
+        size_t length = text.size();
+        size_t i = 0;
+        while (i < length) {
+            // Copy the clean run in one go
+            size_t run = jsonScanString(data + i, length - i);
+            put(data + i, run);
+            i += run;
+            if (i >= length) break;
+
+            unsigned char c = static_cast<unsigned char>(data[i++]);
+            switch (c) {
+                case '"': put("\\\"", 2); break;
+                case '\\': put("\\\\", 2); break;
+                case '\n': put("\\n", 2); break;
+                case '\r': put("\\r", 2); break;
+                case '\t': put("\\t", 2); break;
+                case '\b': put("\\b", 2); break;
+                case '\f': put("\\f", 2); break;
+                default: {
+                    char escaped[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+                    put(escaped, sizeof(escaped));
+                }
+            }
+        }
+        putChar('"');
+    }
+};
+
+#endif // JSONWRITER_H
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * LATENCYHISTOGRAM.H - Log-Linear Latency Histogram (HdrHistogram-style)
+ *
+ * PURPOSE:
+ * Records latency samples with bounded relative error and constant memory,
+ * so percentiles (p50, p99, p99.9) can be reported without keeping every
+ * sample. Used by the load generator and benchmark tools, and suitable for
+ * server-side latency tracking.
+ *
+ * BUCKET LAYOUT (same idea as HdrHistogram):
+ * - Values below 2^SUB_BUCKET_BITS (128) get one exact bucket each
+ * - Every power-of-two range above that, [2^m, 2^(m+1)), is split into
+ *   64 equal-width linear buckets
+ * - Relative error is therefore below 1/64 (~1.6%) across the whole range
+ *   of uint64_t, using ~3800 counters
+ *
+ * UNITS:
+ * The histogram is unit-agnostic; callers in this repo record microseconds.
+ *
+ * THREAD SAFETY:
+ * Not synchronized. Keep one histogram per thread and merge() them when
+ * reporting (no contention on the hot path).
+ ******************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <algorithm>   // std::min, std::max
+#include <cstdint>     // uint64_t
+#include <cstddef>     // size_t
+#include <vector>      // std::vector - bucket counters
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-precision histogram with percentile queries
+ *
+ * USAGE:
+ * LatencyHistogram hist;
+ * hist.record(elapsedMicros);
+ * uint64_t p99 = hist.percentile(99.0);
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;                          // 128 exact buckets
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;  // 64 per octave
+    static constexpr size_t BUCKET_COUNT =
+        SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+private:
+    std::vector<uint64_t> counts;   // One counter per bucket
+    uint64_t total;                 // Number of samples
+    uint64_t sum;                   // Sum of samples (for mean)
+    uint64_t minValue;              // Smallest sample
+    uint64_t maxValue;              // Largest sample (exact)
+
+    /** @brief Index of the most significant set bit (value > 0) */
+    static int msbIndex(uint64_t value) {
+        return 63 - __builtin_clzll(value);
+    }
+
+public:
+    LatencyHistogram()
+        : counts(BUCKET_COUNT, 0), total(0), sum(0), minValue(UINT64_MAX), maxValue(0) {}
+
+    /**
+     * @brief Maps a value to its bucket index
+     */
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<size_t>(value);
+        int shift = msbIndex(value) - (SUB_BUCKET_BITS - 1);     // >= 1
+        uint64_t sub = (value >> shift) - SUB_BUCKET_HALF;       // 0..63
+        return static_cast<size_t>(SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + sub);
+    }
+
+    /**
+     * @brief Largest value that maps to a bucket (HdrHistogram reports this)
+     */
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        uint64_t offset = index - SUB_BUCKET_COUNT;
+        int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+        uint64_t sub = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    /** @brief Records one sample */
+    void record(uint64_t value) {
+        counts[bucketIndex(value)]++;
+        total++;
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    /** @brief Adds all samples of another histogram into this one */
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; i++) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    /** @brief Removes all samples */
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = 0;
+        sum = 0;
+        minValue = UINT64_MAX;
+        maxValue = 0;
+    }
+
+    /**
+     * @brief Value at a percentile
+     * @param percentile 0-100 (e.g. 99.9)
+     * @return uint64_t - Upper bound of the bucket holding that rank (0 if empty)
+     */
+    uint64_t percentile(double percentile) const {
+        if (total == 0) return 0;
+        if (percentile >= 100.0) return maxValue;
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(bucketUpperBound(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+};
+
+#endif // LATENCYHISTOGRAM_H
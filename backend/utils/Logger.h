@@ -0,0 +1,459 @@
+/*******************************************************************************
+ * LOGGER.H - Asynchronous Ring-Buffer Logger
+ *
+ * PURPOSE:
+ * Replaces direct std::cout/std::cerr writes in hot paths. Writing to stdout
+ * takes a process-wide lock and may block on the terminal or pipe; doing it
+ * while holding chainMutex, mongoMutex or redisMutex serialized every thread
+ * behind the console. With this logger a log call only formats into memory.
+ *
+ * DESIGN:
+ * - One single-producer/single-consumer ring per thread (lock-free: the
+ *   owning thread is the only producer, the flusher the only consumer)
+ * - Background flusher thread drains all rings every 20ms, orders entries by
+ *   timestamp and writes them in one batch (WARN/ERROR to stderr)
+ * - Ring full → the entry is DROPPED and counted, never waited for
+ * - Levels: DEBUG < INFO < WARN < ERROR < OFF, checked before formatting
+ * - Rate limiting: every call site allows at most N lines per second
+ *   (default 50); the next line that gets through reports how many similar
+ *   lines were suppressed
+ *
+ * OUTPUT FORMAT (one line per entry):
+ * 2026-01-02T03:04:05.678901Z INFO  [MongoDB] (t3) Connected to mongodb://...
+ *
+ * USAGE:
+ * BITEA_LOG_INFO("Blockchain", "Mining block %d with %zu transactions", idx, n);
+ * BITEA_LOG_ERROR("Redis", "SET command failed");
+ *
+ * CONFIGURATION:
+ * - Logger::instance().setLevel(LogLevel::DEBUG)
+ * - Logger::parseLevel("warn") for environment/CLI values
+ * - main.cpp reads BITEA_LOG_LEVEL
+ *
+ * SHUTDOWN:
+ * An atexit() hook stops the flusher and drains remaining entries. Lines
+ * logged after that are written synchronously to stderr.
+ ******************************************************************************/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <algorithm>           // std::sort - order batch by time
+#include <atomic>              // std::atomic - ring indices, counters
+#include <chrono>              // std::chrono - timestamps, flush interval
+#include <condition_variable>  // std::condition_variable - flusher sleep/stop
+#include <cstdarg>             // va_list - printf-style formatting
+#include <cstdint>             // fixed-width integers
+#include <cstdio>              // vsnprintf, fwrite
+#include <cstdlib>             // std::atexit
+#include <cstring>             // strcmp
+#include <ctime>               // gmtime_r - timestamp formatting
+#include <memory>              // std::shared_ptr - ring ownership
+#include <mutex>               // std::mutex - ring registry only
+#include <string>              // std::string - output batches
+#include <thread>              // std::thread - flusher
+#include <vector>              // std::vector - registry, batches
+
+// ============================================================================
+// LOG LEVELS
+// ============================================================================
+
+/**
+ * @enum LogLevel
+ * @brief Severity; messages below the configured level are not formatted
+ */
+enum class LogLevel {
+    DEBUG = 0,
+    INFO = 1,
+    WARN = 2,
+    ERROR = 3,
+    OFF = 4
+};
+
+// ============================================================================
+// PER-THREAD RING BUFFER
+// ============================================================================
+
+/**
+ * @struct LogEntry
+ * @brief One formatted line waiting for the flusher (fixed size, no heap)
+ */
+struct LogEntry {
+    int64_t timestampMicros;   // Unix time in microseconds
+    LogLevel level;
+    const char* component;     // String literal ("MongoDB", "Redis", ...)
+    uint32_t threadIndex;      // Small per-logger thread number
+    char text[208];            // Message (truncated if longer)
+};
+
+/**
+ * @class LogRing
+ * @brief Lock-free SPSC queue owned by one producing thread
+ */
+class LogRing {
+public:
+    static constexpr size_t CAPACITY = 256;   // Entries per thread (power of two)
+
+    explicit LogRing(uint32_t threadIndex)
+        : threadIndex(threadIndex), head(0), tail(0), dropped(0), retired(false) {}
+
+    /**
+     * @brief Reserves the next slot (producer only)
+     * @return LogEntry* - Slot to fill, or nullptr if full (entry dropped)
+     */
+    LogEntry* beginWrite() {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h % CAPACITY];
+    }
+
+    /** @brief Publishes the slot returned by beginWrite() (producer only) */
+    void commitWrite() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /** @brief Moves all published entries into out (consumer only) */
+    void drain(std::vector<LogEntry>& out) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (; t < h; t++) out.push_back(slots[t % CAPACITY]);
+        tail.store(t, std::memory_order_release);
+    }
+
+    bool isEmpty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    uint32_t getThreadIndex() const { return threadIndex; }
+    uint64_t takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+    void retire() { retired.store(true, std::memory_order_release); }
+    bool isRetired() const { return retired.load(std::memory_order_acquire); }
+
+private:
+    uint32_t threadIndex;
+    LogEntry slots[CAPACITY];
+    alignas(64) std::atomic<uint64_t> head;   // Next slot to write (producer)
+    alignas(64) std::atomic<uint64_t> tail;   // Next slot to read (consumer)
+    std::atomic<uint64_t> dropped;            // Entries lost to a full ring
+    std::atomic<bool> retired;                // Owning thread has exited
+};
+
+// ============================================================================
+// PER-CALL-SITE RATE LIMITER
+// ============================================================================
+
+/**
+ * @class LogRateLimiter
+ * @brief Fixed one-second window limiter, one static instance per call site
+ *
+ * Lock-free: a racing thread may let one extra line through at a window
+ * boundary, which is fine for logging.
+ */
+class LogRateLimiter {
+public:
+    LogRateLimiter() : windowSecond(0), count(0), suppressed(0) {}
+
+    /**
+     * @brief Decides whether the current line may be logged
+     * @param limit Lines per second allowed for this site
+     * @param suppressedOut Lines dropped since the last allowed line
+     */
+    bool allow(uint32_t limit, uint64_t& suppressedOut) {
+        int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t window = windowSecond.load(std::memory_order_relaxed);
+        if (now != window && windowSecond.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        if (count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressedOut = suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<int64_t> windowSecond;
+    std::atomic<uint32_t> count;
+    std::atomic<uint64_t> suppressed;
+};
+
+// ============================================================================
+// LOGGER
+// ============================================================================
+
+/**
+ * @class Logger
+ * @brief Process-wide asynchronous logger (singleton)
+ *
+ * THREAD SAFETY:
+ * log() is safe from any thread; it touches only the caller's own ring.
+ * The registry mutex is taken once per thread (first log call) and by the
+ * flusher.
+ */
+class Logger {
+public:
+    /**
+     * @brief Singleton accessor
+     * Intentionally never destroyed, so threads still logging during static
+     * destruction never touch a dead object; atexit() drains it instead.
+     */
+    static Logger& instance() {
+        static Logger* logger = [] {
+            Logger* created = new Logger();
+            std::atexit([] { Logger::instance().shutdown(); });
+            return created;
+        }();
+        return *logger;
+    }
+
+    /** @brief True if messages at this level are currently emitted */
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed) &&
+               level != LogLevel::OFF;
+    }
+
+    void setLevel(LogLevel level) { minLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed)); }
+
+    /** @brief Lines per second allowed per call site (0 = unlimited) */
+    void setRateLimit(uint32_t linesPerSecond) { rateLimit.store(linesPerSecond, std::memory_order_relaxed); }
+    uint32_t getRateLimit() const { return rateLimit.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parses "debug", "info", "warn", "error", "off"
+     * @param fallback Returned for unknown/null input
+     */
+    static LogLevel parseLevel(const char* text, LogLevel fallback = LogLevel::INFO) {
+        if (!text) return fallback;
+        if (strcmp(text, "debug") == 0) return LogLevel::DEBUG;
+        if (strcmp(text, "info") == 0) return LogLevel::INFO;
+        if (strcmp(text, "warn") == 0) return LogLevel::WARN;
+        if (strcmp(text, "error") == 0) return LogLevel::ERROR;
+        if (strcmp(text, "off") == 0) return LogLevel::OFF;
+        return fallback;
+    }
+
+    /**
+     * @brief Formats a message into the calling thread's ring (never blocks)
+     * @param suppressed Lines the call site's rate limiter dropped before this
+     */
+    __attribute__((format(printf, 5, 6)))
+    void log(LogLevel level, const char* component, uint64_t suppressed, const char* format, ...) {
+        if (stopped.load(std::memory_order_acquire)) {
+            // After shutdown: no flusher left, write through
+            LogEntry entry;
+            fill(entry, level, component, 0);
+            va_list args;
+            va_start(args, format);
+            formatInto(entry, suppressed, format, args);
+            va_end(args);
+            std::string line;
+            appendLine(line, entry);
+            fwrite(line.data(), 1, line.size(), stderr);
+            return;
+        }
+
+        LogRing& ring = threadRing();
+        LogEntry* entry = ring.beginWrite();
+        if (!entry) return;  // Full: dropped and counted, never block
+        fill(*entry, level, component, ring.getThreadIndex());
+        va_list args;
+        va_start(args, format);
+        formatInto(*entry, suppressed, format, args);
+        va_end(args);
+        ring.commitWrite();
+    }
+
+    /**
+     * @brief Stops the flusher after a final drain (idempotent)
+     * 
+     * ORDER: log() switches to write-through first, so nothing new lands in
+     * a ring once the flusher is gone; the flusher then does its final
+     * drain, and one more drain after the join picks up lines whose writer
+     * passed the stopped check just before it flipped.
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        stopped.store(true, std::memory_order_release);
+        flushCv.notify_all();
+        if (flusher.joinable()) flusher.join();
+        std::vector<LogEntry> batch;
+        flushOnce(batch);
+    }
+
+    /** @brief Total entries dropped because a ring was full */
+    uint64_t getDroppedCount() const { return totalDropped.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> minLevel;
+    std::atomic<uint32_t> rateLimit;
+    std::vector<std::shared_ptr<LogRing>> rings;   // All live (or undrained) rings
+    std::mutex registryMutex;                      // Protects rings
+    std::atomic<uint32_t> nextThreadIndex;
+    std::atomic<uint64_t> totalDropped;
+
+    std::thread flusher;
+    std::mutex flushMutex;                         // Only for flusher sleep/stop
+    std::condition_variable flushCv;
+    bool stopping;
+    std::atomic<bool> stopped;
+
+    Logger()
+        : minLevel(static_cast<int>(LogLevel::INFO)), rateLimit(50), nextThreadIndex(0),
+          totalDropped(0), stopping(false), stopped(false) {
+        flusher = std::thread(&Logger::flushLoop, this);
+    }
+
+    /**
+     * @brief Returns (creating on first use) the calling thread's ring
+     * The thread_local holder retires the ring when the thread exits; the
+     * flusher frees it once drained.
+     */
+    LogRing& threadRing() {
+        struct Holder {
+            std::shared_ptr<LogRing> ring;
+            ~Holder() { if (ring) ring->retire(); }
+        };
+        thread_local Holder holder;
+        if (!holder.ring) {
+            holder.ring = std::make_shared<LogRing>(nextThreadIndex.fetch_add(1));
+            std::lock_guard<std::mutex> lock(registryMutex);
+            rings.push_back(holder.ring);
+        }
+        return *holder.ring;
+    }
+
+    static void fill(LogEntry& entry, LogLevel level, const char* component, uint32_t threadIndex) {
+        entry.timestampMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        entry.level = level;
+        entry.component = component;
+        entry.threadIndex = threadIndex;
+    }
+
+    static void formatInto(LogEntry& entry, uint64_t suppressed, const char* format, va_list args) {
+        int written = vsnprintf(entry.text, sizeof(entry.text), format, args);
+        if (written >= static_cast<int>(sizeof(entry.text))) {
+            memcpy(entry.text + sizeof(entry.text) - 4, "...", 4);   // Mark truncation
+        } else if (suppressed > 0 && written >= 0) {
+            snprintf(entry.text + written, sizeof(entry.text) - static_cast<size_t>(written),
+                     " (suppressed %llu similar)", static_cast<unsigned long long>(suppressed));
+        }
+    }
+
+    static const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::DEBUG: return "DEBUG";
+            case LogLevel::INFO: return "INFO ";
+            case LogLevel::WARN: return "WARN ";
+            case LogLevel::ERROR: return "ERROR";
+            default: return "?????";
+        }
+    }
+
+    static void appendLine(std::string& out, const LogEntry& entry) {
+        time_t seconds = static_cast<time_t>(entry.timestampMicros / 1000000);
+        struct tm utc;
+        gmtime_r(&seconds, &utc);
+        char prefix[96];
+        int n = snprintf(prefix, sizeof(prefix), "%04d-%02d-%02dT%02d:%02d:%02d.%06lldZ %s [%s] (t%u) ",
+                         utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+                         utc.tm_hour, utc.tm_min, utc.tm_sec,
+                         static_cast<long long>(entry.timestampMicros % 1000000),
+                         levelName(entry.level), entry.component, entry.threadIndex);
+        out.append(prefix, static_cast<size_t>(n > 0 ? n : 0));
+        out.append(entry.text);
+        out.push_back('\n');
+    }
+
+    /**
+     * @brief Drains every ring, writes one batch to stdout and one to stderr
+     */
+    void flushOnce(std::vector<LogEntry>& batch) {
+        batch.clear();
+        uint64_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (auto& ring : rings) {
+                ring->drain(batch);
+                dropped += ring->takeDropped();
+            }
+            // Forget rings whose thread exited and that are fully drained
+            rings.erase(std::remove_if(rings.begin(), rings.end(),
+                [](const std::shared_ptr<LogRing>& r) { return r->isRetired() && r->isEmpty(); }),
+                rings.end());
+        }
+        if (batch.empty() && dropped == 0) return;
+
+        std::stable_sort(batch.begin(), batch.end(), [](const LogEntry& a, const LogEntry& b) {
+            return a.timestampMicros < b.timestampMicros;
+        });
+
+        std::string out, err;
+        for (const auto& entry : batch) {
+            appendLine(entry.level >= LogLevel::WARN ? err : out, entry);
+        }
+        if (dropped > 0) {
+            totalDropped.fetch_add(dropped, std::memory_order_relaxed);
+            err += "[Logger] dropped " + std::to_string(dropped) + " messages (ring buffer full)\n";
+        }
+        if (!out.empty()) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            fflush(stdout);
+        }
+        if (!err.empty()) {
+            fwrite(err.data(), 1, err.size(), stderr);
+        }
+    }
+
+    void flushLoop() {
+        std::vector<LogEntry> batch;
+        batch.reserve(1024);
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(flushMutex);
+                flushCv.wait_for(lock, std::chrono::milliseconds(20), [this] { return stopping; });
+                if (stopping) break;
+            }
+            flushOnce(batch);
+        }
+        flushOnce(batch);  // Final drain
+    }
+};
+
+// ============================================================================
+// LOGGING MACROS
+// ============================================================================
+
+/**
+ * @brief Logs at a level if enabled and the call site is under its rate limit
+ * Arguments are not evaluated when the level is disabled.
+ */
+#define BITEA_LOG(level, component, ...)                                         \
+    do {                                                                         \
+        Logger& bitea_logger_ = Logger::instance();                              \
+        if (bitea_logger_.isEnabled(level)) {                                    \
+            static LogRateLimiter bitea_log_site_;                               \
+            uint64_t bitea_suppressed_ = 0;                                      \
+            uint32_t bitea_limit_ = bitea_logger_.getRateLimit();                \
+            if (bitea_limit_ == 0 || bitea_log_site_.allow(bitea_limit_, bitea_suppressed_)) { \
+                bitea_logger_.log(level, component, bitea_suppressed_, __VA_ARGS__); \
+            }                                                                    \
+        }                                                                        \
+    } while (0)
+
+#define BITEA_LOG_DEBUG(component, ...) BITEA_LOG(LogLevel::DEBUG, component, __VA_ARGS__)
+#define BITEA_LOG_INFO(component, ...)  BITEA_LOG(LogLevel::INFO, component, __VA_ARGS__)
+#define BITEA_LOG_WARN(component, ...)  BITEA_LOG(LogLevel::WARN, component, __VA_ARGS__)
+#define BITEA_LOG_ERROR(component, ...) BITEA_LOG(LogLevel::ERROR, component, __VA_ARGS__)
+
+#endif // LOGGER_H
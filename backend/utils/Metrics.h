@@ -0,0 +1,436 @@
+/*******************************************************************************
+ * METRICS.H - Thread-Sharded Metrics Registry (Prometheus Text Format)
+ *
+ * PURPOSE:
+ * Cheap always-on instrumentation for the request path, storage clients and
+ * blockchain, exposed by GET /metrics for a Prometheus scraper.
+ *
+ * DESIGN:
+ * - Series = metric family + label set, registered once and identified by
+ *   a small integer id (lookups are cached per thread)
+ * - Every thread writes its own shard: plain relaxed load+store on cells
+ *   only that thread writes, no locked read-modify-write, no shared cache
+ *   lines → an observation costs a few nanoseconds
+ * - The scraper sums all shards (relaxed loads) when rendering; shards of
+ *   exited threads are folded into a retired total so counts never go back
+ * - Gauges (queue depth, chain height, ...) are callbacks evaluated at
+ *   scrape time, so instrumented code pays nothing for them
+ *
+ * METRIC TYPES:
+ * - Counter:   monotonically increasing count
+ * - Histogram: fixed latency buckets (0.5ms .. 10s) + sum + count
+ * - Gauge / callback counter: value computed during render()
+ *
+ * LIMITS:
+ * MAX_SERIES (4096) distinct series per process; label values must be
+ * bounded (route patterns, not raw paths). Extra series are ignored.
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - HttpServer.h: bitea_http_request_duration_seconds{method,route,status}
+ * - MongoClient.h / RedisClient.h: bitea_db_call_duration_seconds{backend,op}
+ * - main.cpp: registers gauges and serves GET /metrics
+ ******************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>         // std::atomic - shard cells, chunk pointers
+#include <chrono>         // std::chrono::steady_clock - ScopedLatency
+#include <cstdint>        // fixed-width integers
+#include <cstdio>         // snprintf - number formatting
+#include <functional>     // std::function - scrape-time callbacks
+#include <map>            // std::map - family ordering for output
+#include <memory>         // std::shared_ptr - shard ownership
+#include <mutex>          // std::mutex - registry (cold path only)
+#include <string>         // std::string - names, labels, output
+#include <unordered_map>  // std::unordered_map - series lookup caches
+#include <vector>         // std::vector - shards, series table
+
+#include "Trace.h"        // TraceScope - storage spans in BITEA_TIME_DB_CALL
+#include "Probes.h"       // DbCallProbe - db__start/db__done USDT probes
+
+/**
+ * @enum MetricType
+ * @brief Prometheus metric type of a family
+ */
+enum class MetricType {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+/**
+ * @struct MetricCell
+ * @brief Per-thread storage for one series (single writer)
+ *
+ * Counters use only count. Histograms use buckets (non-cumulative; the
+ * last one is +Inf), count and sumMicros.
+ */
+struct MetricCell {
+    static constexpr int BUCKETS = 15;
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumMicros;
+
+    MetricCell() : count(0), sumMicros(0) {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @class MetricsShard
+ * @brief One thread's cells, allocated in chunks on first use
+ */
+class MetricsShard {
+public:
+    static constexpr int CHUNK = 64;
+    static constexpr int CHUNKS = 64;
+
+    MetricsShard() : retired(false) {
+        for (auto& c : chunks) c.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~MetricsShard() {
+        for (auto& c : chunks) delete[] c.load(std::memory_order_relaxed);
+    }
+
+    MetricsShard(const MetricsShard&) = delete;
+    MetricsShard& operator=(const MetricsShard&) = delete;
+
+    /** @brief Cell for a series, allocating its chunk if needed (owner only) */
+    MetricCell* cell(int id) {
+        std::atomic<MetricCell*>& slot = chunks[id / CHUNK];
+        MetricCell* chunk = slot.load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new MetricCell[CHUNK];
+            slot.store(chunk, std::memory_order_release);   // Publish to scraper
+        }
+        return &chunk[id % CHUNK];
+    }
+
+    /** @brief Cell for a series if it exists (scraper) */
+    const MetricCell* peek(int id) const {
+        MetricCell* chunk = chunks[id / CHUNK].load(std::memory_order_acquire);
+        return chunk ? &chunk[id % CHUNK] : nullptr;
+    }
+
+    void retire() { retired.store(true, std::memory_order_release); }
+    bool isRetired() const { return retired.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<MetricCell*> chunks[CHUNKS];
+    std::atomic<bool> retired;
+};
+
+/**
+ * @class Metrics
+ * @brief Process-wide registry (singleton)
+ *
+ * USAGE:
+ * static const int id = Metrics::instance().series("bitea_x_total", "op=\"y\"");
+ * Metrics::instance().increment(id);
+ */
+class Metrics {
+public:
+    static constexpr int MAX_SERIES = MetricsShard::CHUNK * MetricsShard::CHUNKS;
+
+    /** Histogram bucket upper bounds in microseconds (+Inf implied) */
+    static constexpr uint64_t BUCKET_BOUNDS_MICROS[MetricCell::BUCKETS - 1] = {
+        500, 1000, 2500, 5000, 10000, 25000, 50000, 100000,
+        250000, 500000, 1000000, 2500000, 5000000, 10000000
+    };
+
+    /** Never destroyed: instrumented threads may outlive static destruction */
+    static Metrics& instance() {
+        static Metrics* metrics = new Metrics();
+        return *metrics;
+    }
+
+    // ========================================================================
+    // REGISTRATION (cold path)
+    // ========================================================================
+
+    /**
+     * @brief Declares a family's type and help text (last call wins)
+     */
+    void describe(const std::string& family, MetricType type, const std::string& help) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        Family& f = families[family];
+        f.type = type;
+        f.help = help;
+    }
+
+    /**
+     * @brief Returns the id of a series, registering it on first use
+     * @param family Metric name (must have been describe()d for correct TYPE)
+     * @param labels Rendered label list without braces: method="GET",route="/x"
+     * @return int - Series id, or -1 if MAX_SERIES is exhausted
+     *
+     * Fast path is a per-thread hash lookup; the registry lock is taken only
+     * the first time a thread sees a series.
+     */
+    int series(const std::string& family, const std::string& labels) {
+        thread_local std::unordered_map<std::string, int> cache;
+        std::string key = family;
+        key += '\x1f';
+        key += labels;
+        auto it = cache.find(key);
+        if (it != cache.end()) return it->second;
+
+        int id;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto known = seriesIds.find(key);
+            if (known != seriesIds.end()) {
+                id = known->second;
+            } else if (static_cast<int>(seriesTable.size()) >= MAX_SERIES) {
+                id = -1;
+            } else {
+                id = static_cast<int>(seriesTable.size());
+                seriesTable.push_back({family, labels});
+                seriesIds.emplace(key, id);
+                families[family].seriesIds.push_back(id);
+            }
+        }
+        cache.emplace(std::move(key), id);
+        return id;
+    }
+
+    /**
+     * @brief Registers a value computed at scrape time
+     * @param family Metric name (describe() it as GAUGE or COUNTER)
+     * @param labels Label list without braces (may be empty)
+     * @param read Callback returning the current value
+     */
+    void callback(const std::string& family, const std::string& labels, std::function<double()> read) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        families[family].callbacks.push_back({labels, std::move(read)});
+    }
+
+    // ========================================================================
+    // RECORDING (hot path, calling thread's shard only)
+    // ========================================================================
+
+    /** @brief Adds n to a counter series */
+    void increment(int id, uint64_t n = 1) {
+        if (id < 0) return;
+        MetricCell* c = localShard().cell(id);
+        c->count.store(c->count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /** @brief Records one latency observation into a histogram series */
+    void observe(int id, uint64_t micros) {
+        if (id < 0) return;
+        MetricCell* c = localShard().cell(id);
+        int bucket = 0;
+        while (bucket < MetricCell::BUCKETS - 1 && micros > BUCKET_BOUNDS_MICROS[bucket]) bucket++;
+        c->buckets[bucket].store(c->buckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        c->count.store(c->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        c->sumMicros.store(c->sumMicros.load(std::memory_order_relaxed) + micros, std::memory_order_relaxed);
+    }
+
+    // ========================================================================
+    // EXPOSITION
+    // ========================================================================
+
+    /**
+     * @brief Renders all families in Prometheus text format 0.0.4
+     * @return std::string - Body for GET /metrics
+     */
+    std::string render() {
+        // Snapshot the registry, then sum shards; callbacks run with no
+        // metrics lock held (they may take chainMutex etc.)
+        std::map<std::string, Family> snapshot;
+        std::vector<Series> table;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            snapshot = families;
+            table = seriesTable;
+        }
+
+        std::vector<Totals> totals(table.size());
+        {
+            std::lock_guard<std::mutex> lock(shardsMutex);
+            foldRetiredShards(table.size());
+            for (size_t id = 0; id < totals.size(); id++) totals[id] = retiredTotals[id];
+            for (const auto& shard : shards) accumulate(*shard, totals);
+        }
+
+        std::string out;
+        out.reserve(16384);
+        char number[64];
+        for (const auto& entry : snapshot) {
+            const std::string& name = entry.first;
+            const Family& family = entry.second;
+            if (family.seriesIds.empty() && family.callbacks.empty()) continue;
+
+            if (!family.help.empty()) out += "# HELP " + name + " " + family.help + "\n";
+            out += "# TYPE " + name + " " + typeName(family.type) + "\n";
+
+            for (const auto& cb : family.callbacks) {
+                snprintf(number, sizeof(number), "%.17g", cb.read());
+                out += name + braces(cb.labels) + " " + number + "\n";
+            }
+
+            for (int id : family.seriesIds) {
+                const std::string& labels = table[id].labels;
+                const Totals& t = totals[id];
+                if (family.type != MetricType::HISTOGRAM) {
+                    out += name + braces(labels) + " " + std::to_string(t.count) + "\n";
+                    continue;
+                }
+                std::string prefix = labels.empty() ? "" : labels + ",";
+                uint64_t cumulative = 0;
+                for (int b = 0; b < MetricCell::BUCKETS; b++) {
+                    cumulative += t.buckets[b];
+                    if (b < MetricCell::BUCKETS - 1) {
+                        snprintf(number, sizeof(number), "%g", BUCKET_BOUNDS_MICROS[b] / 1e6);
+                    } else {
+                        snprintf(number, sizeof(number), "+Inf");
+                    }
+                    out += name + "_bucket{" + prefix + "le=\"" + number + "\"} " + std::to_string(cumulative) + "\n";
+                }
+                snprintf(number, sizeof(number), "%.6f", t.sumMicros / 1e6);
+                out += name + "_sum" + braces(labels) + " " + number + "\n";
+                out += name + "_count" + braces(labels) + " " + std::to_string(t.count) + "\n";
+            }
+        }
+        return out;
+    }
+
+private:
+    struct Totals {
+        uint64_t buckets[MetricCell::BUCKETS] = {0};
+        uint64_t count = 0;
+        uint64_t sumMicros = 0;
+    };
+
+    struct Series {
+        std::string family;
+        std::string labels;
+    };
+
+    struct Callback {
+        std::string labels;
+        std::function<double()> read;
+    };
+
+    struct Family {
+        MetricType type = MetricType::GAUGE;   // Until describe()d
+        std::string help;
+        std::vector<int> seriesIds;
+        std::vector<Callback> callbacks;
+    };
+
+    std::mutex registryMutex;                            // Families and series
+    std::map<std::string, Family> families;              // Sorted output
+    std::vector<Series> seriesTable;                     // id → series
+    std::unordered_map<std::string, int> seriesIds;      // key → id
+
+    std::mutex shardsMutex;                              // Shards and retired totals
+    std::vector<std::shared_ptr<MetricsShard>> shards;   // Live thread shards
+    std::vector<Totals> retiredTotals;                   // Sums of exited threads
+
+    Metrics() = default;
+
+    /** @brief Calling thread's shard, registered on first use */
+    MetricsShard& localShard() {
+        struct Holder {
+            std::shared_ptr<MetricsShard> shard;
+            ~Holder() { if (shard) shard->retire(); }
+        };
+        thread_local Holder holder;
+        if (!holder.shard) {
+            holder.shard = std::make_shared<MetricsShard>();
+            std::lock_guard<std::mutex> lock(shardsMutex);
+            shards.push_back(holder.shard);
+        }
+        return *holder.shard;
+    }
+
+    /** @brief Adds one shard's cells into totals */
+    static void accumulate(const MetricsShard& shard, std::vector<Totals>& totals) {
+        for (size_t id = 0; id < totals.size(); id++) {
+            const MetricCell* c = shard.peek(static_cast<int>(id));
+            if (!c) continue;
+            Totals& t = totals[id];
+            for (int b = 0; b < MetricCell::BUCKETS; b++) t.buckets[b] += c->buckets[b].load(std::memory_order_relaxed);
+            t.count += c->count.load(std::memory_order_relaxed);
+            t.sumMicros += c->sumMicros.load(std::memory_order_relaxed);
+        }
+    }
+
+    /** @brief Moves counts of exited threads into retiredTotals (shardsMutex held) */
+    void foldRetiredShards(size_t seriesCount) {
+        if (retiredTotals.size() < seriesCount) retiredTotals.resize(seriesCount);
+        for (auto it = shards.begin(); it != shards.end();) {
+            if (!(*it)->isRetired()) {
+                ++it;
+                continue;
+            }
+            accumulate(**it, retiredTotals);
+            it = shards.erase(it);
+        }
+    }
+
+    static const char* typeName(MetricType type) {
+        switch (type) {
+            case MetricType::COUNTER: return "counter";
+            case MetricType::GAUGE: return "gauge";
+            case MetricType::HISTOGRAM: return "histogram";
+        }
+        return "untyped";
+    }
+
+    static std::string braces(const std::string& labels) {
+        return labels.empty() ? "" : "{" + labels + "}";
+    }
+};
+
+// ============================================================================
+// SCOPED LATENCY TIMER
+// ============================================================================
+
+/**
+ * @class ScopedLatency
+ * @brief Observes the lifetime of a scope into a histogram series
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(int seriesId)
+        : seriesId(seriesId), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Metrics::instance().observe(seriesId, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    int seriesId;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Times the rest of the enclosing scope as one storage call
+ * @param backend "mongodb" or "redis"
+ * @param op Operation name ("insertUser", "getSession", ...)
+ * The series id is resolved once per call site. Also opens a
+ * "backend.op" span in the current request trace (utils/Trace.h) and
+ * fires the db__start/db__done USDT probes (utils/Probes.h).
+ */
+#define BITEA_TIME_DB_CALL(backend, op)                                              \
+    static const int bitea_db_series_ = [] {                                         \
+        Metrics::instance().describe("bitea_db_call_duration_seconds",               \
+            MetricType::HISTOGRAM, "Storage call latency including lock wait");      \
+        return Metrics::instance().series("bitea_db_call_duration_seconds",          \
+            "backend=\"" backend "\",op=\"" op "\"");                                \
+    }();                                                                             \
+    ScopedLatency bitea_db_timer_(bitea_db_series_);                                 \
+    TraceScope bitea_db_span_(backend "." op);                                       \
+    DbCallProbe bitea_db_probe_(backend, op)
+
+#endif // METRICS_H
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * PROBES.H - USDT Static Tracepoints (bpftrace / SystemTap)
+ *
+ * PURPOSE:
+ * Named probe sites in the request, storage and mining paths that bpftrace
+ * can attach to in a running server, without a rebuild or restart.
+ *
+ * BUILD:
+ * - cmake -DBITEA_USDT=ON (needs sys/sdt.h, package systemtap-sdt-dev)
+ *   defines HAS_USDT; each probe is then a single NOP plus an ELF note
+ * - Otherwise every BITEA_PROBE* macro expands to nothing and its
+ *   arguments are not evaluated
+ *
+ * PROVIDER: bitea
+ *
+ * PROBES (arguments in order):
+ * - request__start   id, method (char*), path (char*)
+ * - route__match     id, route pattern (char*), "" when no route matched
+ * - request__done    id, status, microseconds since accept()
+ * - db__start        backend (char*), op (char*)
+ * - db__done         backend (char*), op (char*)
+ * - mempool__add     pending transaction count after the add
+ * - mine__start      block index, difficulty
+ * - mine__progress   block index, nonce (every 4096 nonces)
+ * - block__sealed    block index, nonce, transaction count
+ *
+ * `id` is the RequestTrace id, so start and done can be matched even when
+ * an async route finishes on a storage thread.
+ *
+ * EXAMPLES: tools/bpftrace/ (one script per latency distribution)
+ ******************************************************************************/
+
+#ifndef PROBES_H
+#define PROBES_H
+
+#if defined(HAS_USDT)
+
+#include <sys/sdt.h>   // DTRACE_PROBEn - USDT probe sites
+
+#define BITEA_PROBE0(name)                 DTRACE_PROBE(bitea, name)
+#define BITEA_PROBE1(name, a)              DTRACE_PROBE1(bitea, name, a)
+#define BITEA_PROBE2(name, a, b)           DTRACE_PROBE2(bitea, name, a, b)
+#define BITEA_PROBE3(name, a, b, c)        DTRACE_PROBE3(bitea, name, a, b, c)
+
+#else
+
+#define BITEA_PROBE0(name)                 do {} while (0)
+#define BITEA_PROBE1(name, a)              do {} while (0)
+#define BITEA_PROBE2(name, a, b)           do {} while (0)
+#define BITEA_PROBE3(name, a, b, c)        do {} while (0)
+
+#endif
+
+/**
+ * @class DbCallProbe
+ * @brief Fires db__start on construction and db__done on destruction
+ *
+ * Used by BITEA_TIME_DB_CALL (utils/Metrics.h), so every MongoDB and Redis
+ * operation is covered. Compiles to nothing without HAS_USDT.
+ */
+class DbCallProbe {
+public:
+    DbCallProbe([[maybe_unused]] const char* backend, [[maybe_unused]] const char* op)
+#if defined(HAS_USDT)
+        : backend(backend), op(op)
+#endif
+    {
+        BITEA_PROBE2(db__start, backend, op);
+    }
+
+    ~DbCallProbe() {
+        BITEA_PROBE2(db__done, backend, op);
+    }
+
+    DbCallProbe(const DbCallProbe&) = delete;
+    DbCallProbe& operator=(const DbCallProbe&) = delete;
+
+private:
+#if defined(HAS_USDT)
+    const char* backend;
+    const char* op;
+#endif
+};
+
+#endif // PROBES_H
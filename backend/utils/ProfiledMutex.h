@@ -0,0 +1,339 @@
+/*******************************************************************************
+ * PROFILEDMUTEX.H - Instrumented Mutex (Wait/Hold Time per Lock and Call Site)
+ *
+ * PURPOSE:
+ * All storage access funnels through a few global locks (mongoMutex,
+ * redisMutex, chainMutex). ProfiledMutex is a drop-in std::mutex
+ * replacement that records, per named lock and per call site:
+ * - acquisitions and how many had to wait (contended)
+ * - total / max wait time, plus a log2 wait histogram for percentiles
+ * - total / max hold time
+ * GET /debug/locks (main.cpp) reports all live locks as JSON.
+ *
+ * OVERHEAD:
+ * - Uncontended: try_lock() succeeds, one clock read on lock, one on unlock
+ * - Statistics are written while the lock is held, so they need no atomic
+ *   read-modify-write (relaxed load+store; readers may see a torn snapshot
+ *   across fields, never a torn value)
+ * - setProfilingEnabled(false) reduces lock()/unlock() to std::mutex plus
+ *   one relaxed load
+ *
+ * TRACE INTEGRATION:
+ * A contended acquisition inside a request adds a "lock.<name>" span to
+ * the current trace, so slow-request log lines show lock queueing.
+ *
+ * USAGE:
+ * ProfiledMutex mongoMutex{"mongodb"};
+ * ProfiledLock lock(mongoMutex, "insertUser");      // attributed call site
+ * std::lock_guard<ProfiledMutex> lock(mongoMutex);  // site "-"
+ ******************************************************************************/
+
+#ifndef PROFILEDMUTEX_H
+#define PROFILEDMUTEX_H
+
+#include <algorithm>   // std::find - registry removal
+#include <atomic>      // std::atomic - statistics cells
+#include <chrono>      // std::chrono::steady_clock - wait/hold timing
+#include <cstdint>     // fixed-width integers
+#include <cstdio>      // snprintf - JSON numbers
+#include <mutex>       // std::mutex - underlying lock, registry
+#include <string>      // std::string - names, report
+#include <vector>      // std::vector - registry
+
+#include "Trace.h"     // currentTrace() - lock wait spans
+
+/**
+ * @struct LockSiteStats
+ * @brief Counters for one (lock, call site) pair
+ */
+struct LockSiteStats {
+    std::atomic<const char*> site{nullptr};   // String literal
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNanos{0};
+    std::atomic<uint64_t> maxWaitNanos{0};
+    std::atomic<uint64_t> holdNanos{0};
+    std::atomic<uint64_t> maxHoldNanos{0};
+};
+
+class ProfiledMutex;
+
+/**
+ * @class LockRegistry
+ * @brief Live ProfiledMutex instances, for reporting
+ */
+class LockRegistry {
+public:
+    static LockRegistry& instance() {
+        static LockRegistry* registry = new LockRegistry();
+        return *registry;
+    }
+
+    void add(ProfiledMutex* m) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        locks.push_back(m);
+    }
+
+    void remove(ProfiledMutex* m) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        locks.erase(std::remove(locks.begin(), locks.end(), m), locks.end());
+    }
+
+    /** @brief JSON report of every live lock (see ProfiledMutex::appendJson) */
+    std::string reportJson();
+
+    /** @brief Zeroes all statistics (starts a fresh measurement window) */
+    void resetAll();
+
+private:
+    std::mutex registryMutex;
+    std::vector<ProfiledMutex*> locks;
+};
+
+/**
+ * @class ProfiledMutex
+ * @brief std::mutex with contention statistics (Lockable)
+ */
+class ProfiledMutex {
+public:
+    static constexpr int MAX_SITES = 32;
+    static constexpr int WAIT_BUCKETS = 40;   // log2(ns): bucket b = [2^b, 2^(b+1))
+
+    explicit ProfiledMutex(const char* name)
+        : name(name), waitSpan(std::string("lock.") + name), siteCount(0),
+          profiledHold(false), currentSite(nullptr) {
+        for (auto& b : waitHistogram) b.store(0, std::memory_order_relaxed);
+        LockRegistry::instance().add(this);
+    }
+
+    ~ProfiledMutex() { LockRegistry::instance().remove(this); }
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    /** @brief Globally turns statistics on/off (default on) */
+    static void setProfilingEnabled(bool enabled) { profilingFlag().store(enabled, std::memory_order_relaxed); }
+    static bool isProfilingEnabled() { return profilingFlag().load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Acquires the lock, attributing wait/hold time to site
+     * @param site Call-site label (string literal)
+     */
+    void lock(const char* site) {
+        if (!isProfilingEnabled()) {
+            mutex.lock();
+            profiledHold = false;
+            return;
+        }
+
+        if (mutex.try_lock()) {
+            acquiredAt = Clock::now();
+            recordAcquire(site, 0, false);
+            return;
+        }
+
+        Clock::time_point waitStart = Clock::now();
+        mutex.lock();
+        acquiredAt = Clock::now();
+        uint64_t waited = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(acquiredAt - waitStart).count());
+        recordAcquire(site, waited, true);
+        if (RequestTrace* trace = currentTrace()) trace->add(waitSpan.c_str(), waitStart, acquiredAt);
+    }
+
+    void lock() { lock("-"); }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) return false;
+        if (isProfilingEnabled()) {
+            acquiredAt = Clock::now();
+            recordAcquire("-", 0, false);
+        } else {
+            profiledHold = false;
+        }
+        return true;
+    }
+
+    void unlock() {
+        if (profiledHold) {
+            uint64_t held = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - acquiredAt).count());
+            LockSiteStats& s = *currentSite;
+            bump(s.holdNanos, held);
+            raise(s.maxHoldNanos, held);
+            profiledHold = false;
+        }
+        mutex.unlock();
+    }
+
+    const char* getName() const { return name; }
+
+    /**
+     * @brief Appends {"name":..,"acquisitions":..,...,"sites":[...]}
+     * Times are reported in microseconds; percentiles are log2-bucket
+     * upper bounds (at most 2x high).
+     */
+    void appendJson(std::string& out) const {
+        uint64_t acq = 0, cont = 0, wait = 0, maxWait = 0, hold = 0, maxHold = 0;
+        int count = siteCount.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            const LockSiteStats& s = sites[i];
+            acq += s.acquisitions.load(std::memory_order_relaxed);
+            cont += s.contended.load(std::memory_order_relaxed);
+            wait += s.waitNanos.load(std::memory_order_relaxed);
+            maxWait = std::max(maxWait, s.maxWaitNanos.load(std::memory_order_relaxed));
+            hold += s.holdNanos.load(std::memory_order_relaxed);
+            maxHold = std::max(maxHold, s.maxHoldNanos.load(std::memory_order_relaxed));
+        }
+
+        char buffer[512];
+        snprintf(buffer, sizeof(buffer),
+                 "{\"name\":\"%s\",\"acquisitions\":%llu,\"contended\":%llu,"
+                 "\"wait_us_total\":%.1f,\"wait_us_max\":%.1f,\"wait_us_p50\":%.1f,\"wait_us_p99\":%.1f,"
+                 "\"hold_us_total\":%.1f,\"hold_us_max\":%.1f,\"sites\":[",
+                 name, static_cast<unsigned long long>(acq), static_cast<unsigned long long>(cont),
+                 wait / 1e3, maxWait / 1e3, waitPercentileNanos(0.50) / 1e3, waitPercentileNanos(0.99) / 1e3,
+                 hold / 1e3, maxHold / 1e3);
+        out += buffer;
+
+        for (int i = 0; i < count; i++) {
+            const LockSiteStats& s = sites[i];
+            snprintf(buffer, sizeof(buffer),
+                     "%s{\"site\":\"%s\",\"acquisitions\":%llu,\"contended\":%llu,"
+                     "\"wait_us_total\":%.1f,\"wait_us_max\":%.1f,\"hold_us_total\":%.1f,\"hold_us_max\":%.1f}",
+                     i ? "," : "", s.site.load(std::memory_order_relaxed),
+                     static_cast<unsigned long long>(s.acquisitions.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(s.contended.load(std::memory_order_relaxed)),
+                     s.waitNanos.load(std::memory_order_relaxed) / 1e3,
+                     s.maxWaitNanos.load(std::memory_order_relaxed) / 1e3,
+                     s.holdNanos.load(std::memory_order_relaxed) / 1e3,
+                     s.maxHoldNanos.load(std::memory_order_relaxed) / 1e3);
+            out += buffer;
+        }
+        out += "]}";
+    }
+
+    /** @brief Zeroes statistics (takes the lock so no update is in flight) */
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        int count = siteCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            LockSiteStats& s = sites[i];
+            s.acquisitions.store(0, std::memory_order_relaxed);
+            s.contended.store(0, std::memory_order_relaxed);
+            s.waitNanos.store(0, std::memory_order_relaxed);
+            s.maxWaitNanos.store(0, std::memory_order_relaxed);
+            s.holdNanos.store(0, std::memory_order_relaxed);
+            s.maxHoldNanos.store(0, std::memory_order_relaxed);
+        }
+        for (auto& b : waitHistogram) b.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::mutex mutex;                        // The actual lock
+    const char* name;                        // "mongodb", "redis", "blockchain"
+    std::string waitSpan;                    // "lock.<name>" trace span label
+
+    // Statistics: written only by the current holder
+    LockSiteStats sites[MAX_SITES + 1];      // Last slot collects overflow sites
+    std::atomic<int> siteCount;
+    std::atomic<uint64_t> waitHistogram[WAIT_BUCKETS];
+    bool profiledHold;                       // Current hold is being timed
+    LockSiteStats* currentSite;              // Site of the current holder
+    Clock::time_point acquiredAt;            // Start of the current hold
+
+    static std::atomic<bool>& profilingFlag() {
+        static std::atomic<bool> flag{true};
+        return flag;
+    }
+
+    static void bump(std::atomic<uint64_t>& cell, uint64_t by) {
+        cell.store(cell.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    static void raise(std::atomic<uint64_t>& cell, uint64_t value) {
+        if (value > cell.load(std::memory_order_relaxed)) cell.store(value, std::memory_order_relaxed);
+    }
+
+    /** @brief Finds or adds the site slot (lock held) */
+    LockSiteStats& siteFor(const char* site) {
+        int count = siteCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            if (sites[i].site.load(std::memory_order_relaxed) == site) return sites[i];
+        }
+        if (count == MAX_SITES) {
+            sites[MAX_SITES].site.store("(other)", std::memory_order_relaxed);
+            return sites[MAX_SITES];
+        }
+        sites[count].site.store(site, std::memory_order_relaxed);
+        siteCount.store(count + 1, std::memory_order_release);
+        return sites[count];
+    }
+
+    /** @brief Records one acquisition (lock held) */
+    void recordAcquire(const char* site, uint64_t waitedNanos, bool contended) {
+        LockSiteStats& s = siteFor(site);
+        bump(s.acquisitions, 1);
+        if (contended) {
+            bump(s.contended, 1);
+            bump(s.waitNanos, waitedNanos);
+            raise(s.maxWaitNanos, waitedNanos);
+        }
+        int bucket = 0;
+        while (bucket < WAIT_BUCKETS - 1 && (waitedNanos >> (bucket + 1)) != 0) bucket++;
+        bump(waitHistogram[bucket], 1);
+        currentSite = &s;
+        profiledHold = true;
+    }
+
+    /** @brief Upper bound of the bucket holding quantile q of wait times */
+    double waitPercentileNanos(double q) const {
+        uint64_t total = 0;
+        for (const auto& b : waitHistogram) total += b.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < WAIT_BUCKETS; b++) {
+            seen += waitHistogram[b].load(std::memory_order_relaxed);
+            if (seen >= rank) return b == 0 ? 0.0 : static_cast<double>(uint64_t(1) << (b + 1));
+        }
+        return static_cast<double>(uint64_t(1) << WAIT_BUCKETS);
+    }
+};
+
+/**
+ * @class ProfiledLock
+ * @brief lock_guard equivalent that names its call site
+ */
+class ProfiledLock {
+public:
+    ProfiledLock(ProfiledMutex& mutex, const char* site) : mutex(mutex) { mutex.lock(site); }
+    ~ProfiledLock() { mutex.unlock(); }
+    ProfiledLock(const ProfiledLock&) = delete;
+    ProfiledLock& operator=(const ProfiledLock&) = delete;
+
+private:
+    ProfiledMutex& mutex;
+};
+
+inline std::string LockRegistry::reportJson() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::string out = "{\"profiling\":";
+    out += ProfiledMutex::isProfilingEnabled() ? "true" : "false";
+    out += ",\"locks\":[";
+    for (size_t i = 0; i < locks.size(); i++) {
+        if (i) out += ",";
+        locks[i]->appendJson(out);
+    }
+    out += "]}";
+    return out;
+}
+
+inline void LockRegistry::resetAll() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (ProfiledMutex* m : locks) m->reset();
+}
+
+#endif // PROFILEDMUTEX_H
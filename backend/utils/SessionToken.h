@@ -0,0 +1,386 @@
+/*******************************************************************************
+ * SESSIONTOKEN.H - Stateless Signed Session Tokens and Their Revocation List
+ *
+ * PURPOSE:
+ * A Redis session ID is a random handle: checking it costs a network round
+ * trip on every authenticated request. A signed token carries its own
+ * claims (who, issued when, valid until, signed with which key) plus an
+ * HMAC-SHA256 over them, so validateSession() can check it with local CPU
+ * only. Logout still has to work, so revoked tokens are listed in a small
+ * set that every process keeps a copy of.
+ *
+ * WIRE FORMAT (opaque to clients, sent as "Authorization: Bearer <token>"):
+ *   base64url("<username>|<issuedAt>|<expiresAt>|<keyId>|<tokenId>")
+ *   + "." + base64url(HMAC-SHA256(secret[keyId], <first part as sent>))
+ * No padding. tokenId is 16 random hex chars and is what revocation lists.
+ * Redis session IDs are 32 hex chars and never contain '.', so the two
+ * kinds can be told apart (looksSigned()).
+ *
+ * KEY ROTATION (BITEA_TOKEN_KEYS="kid:secret[,kid:secret...]"):
+ * The first key signs new tokens; every listed key verifies. To rotate:
+ * 1. Append the new key everywhere (all processes can verify it)
+ * 2. Move it to the front (new tokens are signed with it)
+ * 3. After one token lifetime, drop the old key
+ * Dropping a key at once invalidates every token it signed: the
+ * emergency "log everyone out" switch if a secret leaks.
+ *
+ * REVOCATION:
+ * RevokedTokens is an immutable snapshot (tokenId -> expiresAt) swapped
+ * atomically, so the per-request contains() check takes no lock. Logout
+ * adds to the local snapshot at once and to a shared Redis sorted set
+ * (RedisClient::revokeToken); a background thread merges the shared set in
+ * every sync interval, so a logout reaches other processes within that
+ * interval. Entries drop out once the token they name has expired, which
+ * bounds the set by the logouts of one token lifetime.
+ *
+ * TRADE-OFFS VS REDIS SESSIONS:
+ * - Tokens do not slide: they expire tokenLifetime after login
+ * - A revoked token stays usable on other processes for up to one sync
+ *   interval (or longer while Redis is unreachable)
+ *
+ * INTEGRATION WITH OTHER COMPONENTS:
+ * - main.cpp: /api/login mints, validateSession() verifies, /api/logout revokes
+ * - RedisClient.h: revokeToken() / loadRevokedTokens() (shared revocation set)
+ * - GET /metrics: bitea_session_token_checks_total{result}, bitea_revoked_tokens
+ *
+ * REFERENCES:
+ * - RFC 2104 (HMAC), RFC 4648 section 5 (base64url)
+ * - RFC 7519 (JWT) - same idea, heavier encoding
+ ******************************************************************************/
+
+#ifndef SESSIONTOKEN_H
+#define SESSIONTOKEN_H
+
+#include <atomic>              // std::atomic - check counters
+#include <charconv>            // std::from_chars - claim parsing
+#include <chrono>              // std::chrono::milliseconds - sync interval
+#include <condition_variable>  // std::condition_variable - sync thread stop
+#include <cstdint>             // int64_t, uint64_t
+#include <ctime>               // std::time - sync thread clock
+#include <functional>          // std::function - revocation loader
+#include <memory>              // std::shared_ptr - revocation snapshots
+#include <mutex>               // std::mutex - sync thread stop
+#include <random>              // std::random_device - token ID fallback
+#include <string>              // std::string - tokens, claims
+#include <string_view>         // std::string_view - token parsing
+#include <thread>              // std::thread - revocation sync
+#include <unordered_map>       // std::unordered_map - revocation snapshot
+#include <utility>             // std::pair, std::move
+#include <vector>              // std::vector - keys, loaded revocations
+
+#include <openssl/crypto.h>    // CRYPTO_memcmp - constant-time MAC comparison
+#include <openssl/evp.h>       // EVP_sha256
+#include <openssl/hmac.h>      // HMAC - one-shot HMAC-SHA256
+#include <openssl/rand.h>      // RAND_bytes - token IDs
+
+#include "Base64Url.h"         // base64UrlEncode/Decode - token parts
+
+#include "ProfiledMutex.h"     // ProfiledMutex - revocation writers
+
+/** @brief What a verified token says */
+struct TokenClaims {
+    std::string username;
+    int64_t issuedAt = 0;    // Unix seconds
+    int64_t expiresAt = 0;   // Unix seconds; rejected from then on
+    std::string keyId;       // Key that signed it
+    std::string tokenId;     // Random; the handle revocation uses
+};
+
+/**
+ * @class SessionTokenSigner
+ * @brief Mints and verifies HMAC-SHA256 signed session tokens
+ *
+ * THREAD SAFETY: configure() before use; mint()/verify() are const and
+ * may then be called concurrently.
+ */
+class SessionTokenSigner {
+public:
+    static constexpr int64_t CLOCK_SKEW_SECONDS = 60;  // Tolerated issuedAt in the future
+    static constexpr size_t MIN_SECRET_LENGTH = 16;
+    static constexpr size_t MAX_TOKEN_LENGTH = 512;
+
+    /**
+     * @brief Loads the key ring from "kid:secret[,kid:secret...]"
+     * @param error Set when the spec is rejected (no key is loaded then)
+     * @return false on an empty spec, a malformed entry, a duplicate key ID,
+     *         a key ID outside [A-Za-z0-9_-]{1,16} or a secret shorter
+     *         than MIN_SECRET_LENGTH
+     */
+    bool configure(const std::string& spec, std::string& error) {
+        std::vector<Key> parsed;
+        size_t start = 0;
+        while (start <= spec.size()) {
+            size_t end = spec.find(',', start);
+            if (end == std::string::npos) end = spec.size();
+            std::string entry = spec.substr(start, end - start);
+            size_t colon = entry.find(':');
+            if (colon == std::string::npos) {
+                error = "expected kid:secret";
+                return false;
+            }
+            Key key{entry.substr(0, colon), entry.substr(colon + 1)};
+            if (!isValidKeyId(key.id)) {
+                error = "key id must be 1-16 characters of [A-Za-z0-9_-]";
+                return false;
+            }
+            if (key.secret.size() < MIN_SECRET_LENGTH) {
+                error = "secret for key '" + key.id + "' is shorter than 16 characters";
+                return false;
+            }
+            for (const Key& existing : parsed) {
+                if (existing.id == key.id) {
+                    error = "duplicate key id '" + key.id + "'";
+                    return false;
+                }
+            }
+            parsed.push_back(std::move(key));
+            start = end + 1;
+        }
+        keys = std::move(parsed);
+        return true;
+    }
+
+    /** @brief True once configure() has loaded at least one key */
+    bool enabled() const { return !keys.empty(); }
+
+    /** @brief ID of the key new tokens are signed with */
+    const std::string& activeKeyId() const { return keys.front().id; }
+    size_t keyCount() const { return keys.size(); }
+
+    /** @brief Signed tokens contain '.', Redis session IDs never do */
+    static bool looksSigned(std::string_view token) { return token.find('.') != std::string_view::npos; }
+
+    /**
+     * @brief Issues a token for username, valid for lifetimeSeconds from now
+     * @param claims Filled with what the token carries
+     */
+    std::string mint(const std::string& username, int64_t now, int64_t lifetimeSeconds,
+                     TokenClaims& claims) const {
+        claims.username = username;
+        claims.issuedAt = now;
+        claims.expiresAt = now + lifetimeSeconds;
+        claims.keyId = activeKeyId();
+        claims.tokenId = randomTokenId();
+
+        std::string payload = base64UrlEncode(claims.username + "|" + std::to_string(claims.issuedAt) + "|" +
+                                              std::to_string(claims.expiresAt) + "|" + claims.keyId + "|" +
+                                              claims.tokenId);
+        return payload + "." + base64UrlEncode(sign(keys.front().secret, payload));
+    }
+
+    /**
+     * @brief Checks signature, key and expiry; does NOT check revocation
+     * @return false for anything malformed, signed with an unknown key,
+     *         forged, expired or issued in the future
+     */
+    bool verify(std::string_view token, int64_t now, TokenClaims& claims) const {
+        bool ok = check(token, now, claims);
+        (ok ? accepted : rejected).fetch_add(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+    uint64_t acceptedCount() const { return accepted.load(std::memory_order_relaxed); }
+    uint64_t rejectedCount() const { return rejected.load(std::memory_order_relaxed); }
+
+private:
+    struct Key {
+        std::string id;
+        std::string secret;
+    };
+
+    std::vector<Key> keys;  // keys[0] signs; all verify
+    mutable std::atomic<uint64_t> accepted{0};
+    mutable std::atomic<uint64_t> rejected{0};
+
+    bool check(std::string_view token, int64_t now, TokenClaims& claims) const {
+        if (token.empty() || token.size() > MAX_TOKEN_LENGTH) return false;
+        size_t dot = token.find('.');
+        if (dot == std::string_view::npos) return false;
+        std::string_view payload = token.substr(0, dot);
+
+        // Claims first, only to pick the key; nothing is trusted before the MAC matches
+        std::string raw;
+        if (!base64UrlDecode(payload, raw)) return false;
+        std::string_view fields[5];
+        size_t count = 0, start = 0;
+        for (size_t i = 0; i <= raw.size(); i++) {
+            if (i == raw.size() || raw[i] == '|') {
+                if (count == 5) return false;
+                fields[count++] = std::string_view(raw).substr(start, i - start);
+                start = i + 1;
+            }
+        }
+        if (count != 5) return false;
+
+        const Key* key = nullptr;
+        for (const Key& candidate : keys) {
+            if (candidate.id == fields[3]) key = &candidate;
+        }
+        if (key == nullptr) return false;
+
+        std::string signature;
+        if (!base64UrlDecode(token.substr(dot + 1), signature)) return false;
+        std::string expected = sign(key->secret, payload);
+        if (signature.size() != expected.size() ||
+            CRYPTO_memcmp(signature.data(), expected.data(), expected.size()) != 0) {
+            return false;
+        }
+
+        int64_t issuedAt = 0, expiresAt = 0;
+        if (!parseInt(fields[1], issuedAt) || !parseInt(fields[2], expiresAt)) return false;
+        if (now >= expiresAt || issuedAt > now + CLOCK_SKEW_SECONDS || fields[0].empty()) return false;
+
+        claims.username.assign(fields[0]);
+        claims.issuedAt = issuedAt;
+        claims.expiresAt = expiresAt;
+        claims.keyId = key->id;
+        claims.tokenId.assign(fields[4]);
+        return true;
+    }
+
+    static std::string sign(const std::string& secret, std::string_view data) {
+        unsigned char mac[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+             reinterpret_cast<const unsigned char*>(data.data()), data.size(), mac, &length);
+        return std::string(reinterpret_cast<const char*>(mac), length);
+    }
+
+    static std::string randomTokenId() {
+        unsigned char bytes[8];
+        if (RAND_bytes(bytes, sizeof(bytes)) != 1) {
+            std::random_device entropy;  // OpenSSL RNG unavailable: OS entropy
+            for (unsigned char& b : bytes) b = static_cast<unsigned char>(entropy());
+        }
+        static const char HEX[] = "0123456789abcdef";
+        std::string id;
+        id.reserve(16);
+        for (unsigned char b : bytes) {
+            id += HEX[b >> 4];
+            id += HEX[b & 15];
+        }
+        return id;
+    }
+
+    static bool isValidKeyId(const std::string& id) {
+        if (id.empty() || id.size() > 16) return false;
+        for (char c : id) {
+            bool ok = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                      c == '-' || c == '_';
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    static bool parseInt(std::string_view text, int64_t& out) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+};
+
+/**
+ * @class RevokedTokens
+ * @brief Process-local copy of the revoked token IDs (tokenId -> expiresAt)
+ *
+ * THREAD SAFETY: contains() is lock-free (atomic shared_ptr load of an
+ * immutable snapshot); writers copy, modify and swap under writeMutex.
+ */
+class RevokedTokens {
+public:
+    using Entries = std::vector<std::pair<std::string, int64_t>>;
+    /** @brief Fetches the shared set (tokenId, expiresAt) for a given now; false on error */
+    using Loader = std::function<bool(int64_t now, Entries& out)>;
+
+    RevokedTokens() : snapshot(std::make_shared<const Snapshot>()) {}
+    ~RevokedTokens() { stopSync(); }
+
+    RevokedTokens(const RevokedTokens&) = delete;
+    RevokedTokens& operator=(const RevokedTokens&) = delete;
+
+    /** @brief True if tokenId was revoked (called on every signed request) */
+    bool contains(const std::string& tokenId) const {
+        std::shared_ptr<const Snapshot> current = std::atomic_load(&snapshot);
+        if (current->find(tokenId) == current->end()) return false;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** @brief Revokes locally, at once (logout on this process) */
+    void add(const std::string& tokenId, int64_t expiresAt, int64_t now) {
+        merge({{tokenId, expiresAt}}, now);
+    }
+
+    /**
+     * @brief Adds entries and drops expired ones; revocations are never
+     * undone, so a merge can only grow the set until tokens expire
+     */
+    void merge(const Entries& entries, int64_t now) {
+        ProfiledLock lock(writeMutex, "merge");
+        std::shared_ptr<const Snapshot> current = std::atomic_load(&snapshot);
+
+        bool changed = false;
+        for (const auto& entry : *current) {
+            if (entry.second <= now) changed = true;
+        }
+        for (const auto& entry : entries) {
+            if (entry.second > now && current->find(entry.first) == current->end()) changed = true;
+        }
+        if (!changed) return;
+
+        auto next = std::make_shared<Snapshot>();
+        next->reserve(current->size() + entries.size());
+        for (const auto& entry : *current) {
+            if (entry.second > now) next->insert(entry);
+        }
+        for (const auto& entry : entries) {
+            if (entry.second > now) next->emplace(entry.first, entry.second);
+        }
+        std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(std::move(next)));
+    }
+
+    size_t size() const { return std::atomic_load(&snapshot)->size(); }
+    uint64_t hitCount() const { return hits.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Merges loader's result every interval on a background thread
+     * (the first load is the caller's job, so startup does not race it)
+     */
+    void startSync(Loader loader, std::chrono::milliseconds interval) {
+        stopSync();
+        syncStopping = false;
+        syncThread = std::thread([this, loader = std::move(loader), interval] {
+            std::unique_lock<std::mutex> lock(syncMutex);
+            while (!syncCv.wait_for(lock, interval, [this] { return syncStopping; })) {
+                lock.unlock();
+                Entries entries;
+                int64_t now = static_cast<int64_t>(std::time(nullptr));
+                if (loader(now, entries)) merge(entries, now);
+                lock.lock();
+            }
+        });
+    }
+
+    void stopSync() {
+        if (!syncThread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(syncMutex);
+            syncStopping = true;
+        }
+        syncCv.notify_one();
+        syncThread.join();
+    }
+
+private:
+    using Snapshot = std::unordered_map<std::string, int64_t>;
+
+    std::shared_ptr<const Snapshot> snapshot;  // Read with std::atomic_load only
+    ProfiledMutex writeMutex{"revokedTokens"};
+    mutable std::atomic<uint64_t> hits{0};     // Requests refused as revoked
+
+    std::mutex syncMutex;
+    std::condition_variable syncCv;
+    bool syncStopping = false;
+    std::thread syncThread;
+};
+
+#endif // SESSIONTOKEN_H
@@ -0,0 +1,355 @@
+/*******************************************************************************
+ * TRACE.H - Per-Request Phase Timing, Slow-Request Log, Chrome Trace Export
+ *
+ * PURPOSE:
+ * Answers "where did this slow request spend its time?" Every request
+ * carries a RequestTrace; code along the request path opens named spans
+ * (parse, route, redis.getSession, mongodb.findPost, blockchain.mine, ...).
+ * When the request finishes:
+ * - total >= slow threshold → one WARN line with the per-phase breakdown
+ * - sampled (1 in N) or slow → kept in a bounded buffer that
+ *   GET /debug/traces exports as Chrome trace JSON (chrome://tracing,
+ *   https://ui.perfetto.dev)
+ *
+ * DESIGN:
+ * - Spans are stored inline in the trace (fixed array, no allocation per
+ *   span, two steady_clock reads each)
+ * - The active trace is a thread_local pointer set by TraceBinding, so
+ *   MongoClient/RedisClient/Blockchain need no extra parameters
+ * - A trace is only ever touched by one thread at a time: the HTTP worker,
+ *   then (async routes) the storage thread it was handed to
+ * - Code running outside a request (startup, benchmarks) has no binding and
+ *   records nothing
+ *
+ * CONFIGURATION (main.cpp):
+ * - BITEA_SLOW_REQUEST_MS: slow threshold (default 250, 0 = off)
+ * - BITEA_TRACE_SAMPLE: keep 1 in N requests for export (default 100, 0 = off)
+ ******************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>   // std::sort - slow-log phase ordering
+#include <atomic>      // std::atomic - ids, thread indices, settings
+#include <chrono>      // std::chrono::steady_clock - span timing
+#include <cstdint>     // fixed-width integers
+#include <cstdio>      // snprintf - slow-log formatting
+#include <deque>       // std::deque - retained traces
+#include <memory>      // std::shared_ptr - trace ownership across threads
+#include <mutex>       // std::mutex - retained-trace buffer
+#include <string>      // std::string - export JSON
+
+#include "Logger.h"    // BITEA_LOG_WARN - slow-request log
+
+/**
+ * @struct TraceSpan
+ * @brief One timed phase, relative to the request's arrival
+ */
+struct TraceSpan {
+    const char* name;          // String literal ("parse", "mongodb.findUser")
+    uint32_t startMicros;      // Offset from RequestTrace::start
+    uint32_t durationMicros;
+    uint16_t depth;            // Nesting level (0 = top-level phase)
+    uint16_t thread;           // Small per-process thread number
+};
+
+/**
+ * @brief Small stable number for the calling thread (trace "thread" field)
+ */
+inline uint16_t traceThreadIndex() {
+    static std::atomic<uint16_t> next{0};
+    thread_local uint16_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+/**
+ * @class RequestTrace
+ * @brief Spans of one request (max MAX_SPANS; extra spans are counted only)
+ */
+class RequestTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int MAX_SPANS = 48;
+
+    explicit RequestTrace(Clock::time_point start)
+        : start(start), spanCount(0), droppedSpans(0), depth(0), allocCount(0), allocBytes(0) {
+        static std::atomic<uint64_t> nextId{1};
+        id = nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    RequestTrace(const RequestTrace&) = delete;
+    RequestTrace& operator=(const RequestTrace&) = delete;
+
+    /**
+     * @brief Opens a span now
+     * @return int - Handle for end(), -1 if the span table is full
+     */
+    int begin(const char* name) {
+        depth++;
+        if (spanCount >= MAX_SPANS) {
+            droppedSpans++;
+            return -1;
+        }
+        TraceSpan& span = spans[spanCount];
+        span.name = name;
+        span.startMicros = offsetMicros(Clock::now());
+        span.durationMicros = 0;
+        span.depth = static_cast<uint16_t>(depth - 1);
+        span.thread = traceThreadIndex();
+        return spanCount++;
+    }
+
+    /** @brief Closes a span opened by begin() */
+    void end(int handle) {
+        depth--;
+        if (handle < 0) return;
+        TraceSpan& span = spans[handle];
+        span.durationMicros = offsetMicros(Clock::now()) - span.startMicros;
+    }
+
+    /**
+     * @brief Records an already finished interval (e.g. queue wait)
+     */
+    void add(const char* name, Clock::time_point from, Clock::time_point to) {
+        if (spanCount >= MAX_SPANS) {
+            droppedSpans++;
+            return;
+        }
+        TraceSpan& span = spans[spanCount++];
+        span.name = name;
+        span.startMicros = offsetMicros(from);
+        span.durationMicros = offsetMicros(to) - span.startMicros;
+        span.depth = static_cast<uint16_t>(depth);
+        span.thread = traceThreadIndex();
+    }
+
+    /** @brief Counts one heap allocation made for this request (utils/AllocTracker.h) */
+    void noteAllocation(size_t bytes) {
+        allocCount++;
+        allocBytes += bytes;
+    }
+
+    uint64_t getId() const { return id; }
+    Clock::time_point getStart() const { return start; }
+    int getSpanCount() const { return spanCount; }
+    const TraceSpan& getSpan(int i) const { return spans[i]; }
+    int getDroppedSpans() const { return droppedSpans; }
+    uint64_t getAllocCount() const { return allocCount; }
+    uint64_t getAllocBytes() const { return allocBytes; }
+
+    /** @brief Microseconds from arrival to t (saturating) */
+    uint32_t offsetMicros(Clock::time_point t) const {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(t - start).count();
+        return us <= 0 ? 0 : static_cast<uint32_t>(std::min<int64_t>(us, UINT32_MAX));
+    }
+
+private:
+    uint64_t id;
+    Clock::time_point start;
+    TraceSpan spans[MAX_SPANS];
+    int spanCount;
+    int droppedSpans;
+    int depth;
+    uint64_t allocCount;       // Only counted in BITEA_ALLOC_TRACKING builds
+    uint64_t allocBytes;
+};
+
+// ============================================================================
+// ACTIVE TRACE (thread_local binding)
+// ============================================================================
+
+/** @brief The calling thread's active trace (nullptr outside requests) */
+inline RequestTrace*& currentTrace() {
+    thread_local RequestTrace* trace = nullptr;
+    return trace;
+}
+
+/**
+ * @class TraceBinding
+ * @brief Makes a trace current for the enclosing scope (restores previous)
+ */
+class TraceBinding {
+public:
+    explicit TraceBinding(RequestTrace* trace) : previous(currentTrace()) { currentTrace() = trace; }
+    ~TraceBinding() { currentTrace() = previous; }
+    TraceBinding(const TraceBinding&) = delete;
+    TraceBinding& operator=(const TraceBinding&) = delete;
+
+private:
+    RequestTrace* previous;
+};
+
+/**
+ * @class TraceScope
+ * @brief Times the enclosing scope as a span of the current trace
+ * No-op (one thread_local load) when no trace is bound.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : trace(currentTrace()), handle(-1) {
+        if (trace) handle = trace->begin(name);
+    }
+    ~TraceScope() {
+        if (trace) trace->end(handle);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    RequestTrace* trace;
+    int handle;
+};
+
+// ============================================================================
+// TRACER (slow log + retained traces)
+// ============================================================================
+
+/**
+ * @class Tracer
+ * @brief Decides what happens to finished traces (singleton)
+ */
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer* tracer = new Tracer();
+        return *tracer;
+    }
+
+    /** @brief Requests at least this slow are logged (0 disables) */
+    void setSlowThresholdMillis(uint64_t ms) { slowMicros.store(ms * 1000, std::memory_order_relaxed); }
+    uint64_t getSlowThresholdMillis() const { return slowMicros.load(std::memory_order_relaxed) / 1000; }
+
+    /** @brief Keep every Nth request for export (0 disables sampling) */
+    void setSampleEvery(uint32_t n) { sampleEvery.store(n, std::memory_order_relaxed); }
+
+    /**
+     * @brief Completes a trace: slow log and/or retention
+     * @param method HTTP method name
+     * @param target Request path (or route pattern)
+     * @param status Response status code
+     */
+    void finish(const std::shared_ptr<RequestTrace>& trace, const char* method,
+                const std::string& target, int status) {
+        if (!trace) return;
+        uint32_t total = trace->offsetMicros(RequestTrace::Clock::now());
+
+        uint64_t slow = slowMicros.load(std::memory_order_relaxed);
+        bool isSlow = slow > 0 && total >= slow;
+        if (isSlow) logSlow(*trace, method, target, status, total);
+
+        uint32_t every = sampleEvery.load(std::memory_order_relaxed);
+        bool sampled = every > 0 && finished.fetch_add(1, std::memory_order_relaxed) % every == 0;
+        if (!isSlow && !sampled) return;
+
+        Retained entry{trace, method, target, status, total};
+        std::lock_guard<std::mutex> lock(retainedMutex);
+        retained.push_back(std::move(entry));
+        if (retained.size() > RETAIN_LIMIT) retained.pop_front();
+    }
+
+    /**
+     * @brief Retained traces as Chrome trace-event JSON
+     *
+     * One row (tid) per request: a root "X" event for the whole request and
+     * one per span; args carry status and the worker thread number.
+     */
+    std::string exportChromeJson() {
+        std::deque<Retained> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(retainedMutex);
+            snapshot = retained;
+        }
+
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char buffer[256];
+        for (const auto& r : snapshot) {
+            int64_t base = std::chrono::duration_cast<std::chrono::microseconds>(
+                r.trace->getStart().time_since_epoch()).count();
+            unsigned long long tid = static_cast<unsigned long long>(r.trace->getId());
+
+            snprintf(buffer, sizeof(buffer),
+                     "%s{\"name\":\"%s %s\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%u,"
+                     "\"pid\":1,\"tid\":%llu,\"args\":{\"status\":%d}}",
+                     first ? "" : ",", r.method, jsonSafe(r.target).c_str(),
+                     static_cast<long long>(base), r.totalMicros, tid, r.status);
+            out += buffer;
+            first = false;
+
+            for (int i = 0; i < r.trace->getSpanCount(); i++) {
+                const TraceSpan& span = r.trace->getSpan(i);
+                snprintf(buffer, sizeof(buffer),
+                         ",{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%u,"
+                         "\"pid\":1,\"tid\":%llu,\"args\":{\"thread\":%u}}",
+                         span.name, static_cast<long long>(base + span.startMicros),
+                         span.durationMicros, tid, span.thread);
+                out += buffer;
+            }
+        }
+        out += "]}";
+        return out;
+    }
+
+private:
+    static constexpr size_t RETAIN_LIMIT = 256;
+
+    struct Retained {
+        std::shared_ptr<RequestTrace> trace;
+        const char* method;
+        std::string target;
+        int status;
+        uint32_t totalMicros;
+    };
+
+    std::atomic<uint64_t> slowMicros;
+    std::atomic<uint32_t> sampleEvery;
+    std::atomic<uint64_t> finished;
+    std::mutex retainedMutex;        // Protects retained
+    std::deque<Retained> retained;   // Most recent sampled/slow traces
+
+    Tracer() : slowMicros(250000), sampleEvery(100), finished(0) {}
+
+    /** @brief Keeps targets safe inside JSON strings (quotes, control chars) */
+    static std::string jsonSafe(const std::string& text) {
+        std::string safe;
+        for (char c : text.substr(0, 120)) {
+            if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) safe += '_';
+            else safe += c;
+        }
+        return safe;
+    }
+
+    /**
+     * @brief One WARN line: total, then top-level phases, then the slowest
+     * nested spans, longest first within each group
+     */
+    static void logSlow(const RequestTrace& trace, const char* method, const std::string& target,
+                        int status, uint32_t totalMicros) {
+        int order[RequestTrace::MAX_SPANS];
+        int n = trace.getSpanCount();
+        for (int i = 0; i < n; i++) order[i] = i;
+        std::sort(order, order + n, [&trace](int a, int b) {
+            const TraceSpan& x = trace.getSpan(a);
+            const TraceSpan& y = trace.getSpan(b);
+            if ((x.depth == 0) != (y.depth == 0)) return x.depth == 0;
+            return x.durationMicros > y.durationMicros;
+        });
+
+        char phases[160];
+        size_t used = 0;
+        phases[0] = '\0';
+        for (int k = 0; k < n && used < sizeof(phases); k++) {
+            const TraceSpan& span = trace.getSpan(order[k]);
+            int w = snprintf(phases + used, sizeof(phases) - used, " %s=%.1f",
+                             span.name, span.durationMicros / 1000.0);
+            if (w < 0) break;
+            used += static_cast<size_t>(w);
+        }
+
+        BITEA_LOG_WARN("Slow", "#%llu %s %.60s %d %.1fms |%s",
+                       static_cast<unsigned long long>(trace.getId()), method, target.c_str(),
+                       status, totalMicros / 1000.0, phases);
+    }
+};
+
+#endif // TRACE_H
@@ -0,0 +1,649 @@
+/*******************************************************************************
+ * BENCH.CPP - Microbenchmarks for Bitea Hot Paths
+ *
+ * PURPOSE:
+ * Measures the core building blocks in isolation so a regression can be
+ * traced to one subsystem: blockchain hashing/mining, request parsing and
+ * routing, model serialization, input validation, metrics/logging
+ * overhead and the in-memory MongoDB/Redis mocks. Results are printed as JSON for tracking over time.
+ *
+ * ITERATION CONTROL:
+ * - Calibration: iterations double until one batch runs for --min-time-ms
+ *   (skipped when --iterations is given, for exactly repeatable runs)
+ * - One untimed warm-up batch, then --repetitions timed batches
+ * - Per benchmark: min / median / mean / max / stddev of ns per operation
+ *
+ * OUTPUT (stdout or --out FILE):
+ * {"schema":1,"storage_backend":"mock","config":{...},
+ *  "benchmarks":[{"subsystem":"http","name":"HttpServer::parseRequest",
+ *                 "iterations":..,"repetitions":..,
+ *                 "ns_per_op":{"min":..,"median":..,"mean":..,"max":..,"stddev":..},
+ *                 "counters":{...}}, ...]}
+ *
+ * USAGE:
+ * ./bitea_bench                              # everything, auto-calibrated
+ * ./bitea_bench --filter blockchain --repetitions 10
+ * ./bitea_bench --iterations 100000 --out bench.json
+ *
+ * Always built against the mock storage implementations (no HAS_MONGODB /
+ * HAS_REDIS), so "storage" numbers measure the mocks, not a live server.
+ ******************************************************************************/
+
+#include <algorithm>    // std::sort
+#include <chrono>       // std::chrono::steady_clock - timing
+#include <cmath>        // std::sqrt - stddev
+#include <cstdio>       // fprintf - JSON output
+#include <cstdlib>      // std::atoi, std::strtoull
+#include <functional>   // std::function - benchmark bodies
+#include <map>          // std::map - counters
+#include <string>       // std::string
+#include <vector>       // std::vector
+
+#include "blockchain/Block.h"         // Block::calculateHash, mineBlock
+#include "blockchain/Transaction.h"   // Transaction::serialize
+#include "server/HttpServer.h"        // parseRequest, dispatch
+#include "models/Post.h"              // Post::toJson, writeJson, writeDetailedJson
+#include "models/User.h"              // Users for mock Mongo
+#include "models/Session.h"           // Sessions for mock Redis
+#include "utils/InputValidator.h"     // Validation functions
+#include "utils/JsonParser.h"         // JsonDocument::parse
+#include "utils/JsonWriter.h"         // JsonWriter - feed serialization
+#include "database/MongoClient.h"     // Mock MongoClient, getPostsPage
+#include "database/RedisClient.h"     // Mock RedisClient
+#include "utils/SessionToken.h"       // SessionTokenSigner, RevokedTokens
+#include "utils/Logger.h"             // Logger::setLevel - silence while measuring
+#include "utils/Metrics.h"            // Metrics::observe overhead
+#include "utils/Trace.h"              // TraceScope overhead
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// BENCHMARK FRAMEWORK
+// ============================================================================
+
+/**
+ * @brief Keeps the compiler from optimizing away a computed value
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** @brief Extra per-run totals reported per operation (e.g. hashes) */
+using Counters = std::map<std::string, double>;
+
+/** @brief Runs the measured operation `iterations` times */
+using BenchBody = std::function<void(uint64_t iterations, Counters& counters)>;
+
+/**
+ * @struct Benchmark
+ * @brief One registered benchmark; setup() runs untimed and returns the body
+ */
+struct Benchmark {
+    std::string subsystem;
+    std::string name;
+    std::function<BenchBody()> setup;
+};
+
+/**
+ * @struct BenchConfig
+ * @brief Command-line options
+ */
+struct BenchConfig {
+    uint64_t iterations = 0;       // 0 = auto-calibrate
+    double minTimeMs = 50.0;       // Calibration target per batch
+    int repetitions = 5;           // Timed batches per benchmark
+    std::string filter;            // Substring of "subsystem/name"
+    std::string outPath;           // Empty = stdout
+    bool list = false;             // Only list benchmark names
+};
+
+static double runBatch(const BenchBody& body, uint64_t iterations, Counters& counters) {
+    counters.clear();
+    Clock::time_point start = Clock::now();
+    body(iterations, counters);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static uint64_t calibrate(const BenchBody& body, double minTimeMs) {
+    Counters scratch;
+    uint64_t iterations = 1;
+    for (;;) {
+        double ns = runBatch(body, iterations, scratch);
+        if (ns >= minTimeMs * 1e6 || iterations >= (1ULL << 40)) return iterations;
+        // Jump close to the target once the batch is long enough to trust
+        if (ns > 1e6) {
+            double scale = (minTimeMs * 1e6) / ns * 1.2;
+            iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1;
+        } else {
+            iterations *= 2;
+        }
+    }
+}
+
+// ============================================================================
+// BENCHMARK DEFINITIONS
+// ============================================================================
+
+static std::vector<Transaction> sampleTransactions(size_t count) {
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < count; i++) {
+        txs.emplace_back("user" + std::to_string(i), TransactionType::POST,
+            "{\"action\":\"post\",\"postId\":\"user" + std::to_string(i) + "-1700000000\"}");
+    }
+    return txs;
+}
+
+static Post samplePost(size_t likes, size_t comments) {
+    Post post("alice-1700000000", "alice",
+              "Benchmarks keep us honest. \"Quotes\", back\\slashes and\nnewlines included.");
+    for (size_t i = 0; i < likes; i++) post.addLike("fan" + std::to_string(i));
+    for (size_t i = 0; i < comments; i++) {
+        post.addComment("commenter" + std::to_string(i), "Comment number " + std::to_string(i));
+    }
+    post.setBlockchainHash(std::string(64, 'a'));
+    return post;
+}
+
+static std::vector<Benchmark> buildBenchmarks() {
+    std::vector<Benchmark> benches;
+
+    // ---------------------------------------------------------------- blockchain
+    benches.push_back({"blockchain", "Block::calculateHash", [] {
+        auto block = std::make_shared<Block>(1, std::string(64, '0'), sampleTransactions(5), 3);
+        return BenchBody([block](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(block->calculateHash());
+        });
+    }});
+
+    benches.push_back({"blockchain", "Block::mineBlock(difficulty=2)", [] {
+        auto txs = std::make_shared<std::vector<Transaction>>(sampleTransactions(5));
+        return BenchBody([txs](uint64_t n, Counters& counters) {
+            double hashes = 0;
+            for (uint64_t i = 0; i < n; i++) {
+                Block block(static_cast<int>(i), std::string(64, '0'), *txs, 2);
+                block.mineBlock();
+                hashes += block.getNonce();
+                doNotOptimize(block.getHash());
+            }
+            counters["hashes"] = hashes;  // Nonce search varies; normalizes cost
+        });
+    }});
+
+    benches.push_back({"blockchain", "Transaction::serialize", [] {
+        auto tx = std::make_shared<Transaction>("alice", TransactionType::COMMENT,
+            "{\"action\":\"comment\",\"postId\":\"alice-1700000000\"}");
+        return BenchBody([tx](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(tx->serialize());
+        });
+    }});
+
+    // ---------------------------------------------------------------- http
+    benches.push_back({"http", "HttpServer::parseRequest", [] {
+        auto raw = std::make_shared<std::string>(
+            "POST /api/posts/alice-1700000000/comment?source=web&v=2 HTTP/1.1\r\n"
+            "Host: localhost:3000\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+            "Accept: application/json\r\n"
+            "Content-Type: application/json\r\n"
+            "Authorization: Bearer " + std::string(64, 'f') + "\r\n"
+            "Content-Length: 34\r\n"
+            "\r\n"
+            "{\"content\":\"Nice post, thanks!\"}");
+        return BenchBody([raw](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(HttpServer::parseRequest(*raw));
+        });
+    }});
+
+    benches.push_back({"http", "JsonDocument::parse(register body)+3 lookups", [] {
+        auto body = std::make_shared<std::string>(
+            "{\"username\":\"alice_1700000000\",\"email\":\"alice@example.com\","
+            "\"password\":\"correct horse battery staple\"}");
+        return BenchBody([body](uint64_t n, Counters&) {
+            JsonDocument doc;
+            for (uint64_t i = 0; i < n; i++) {
+                doc.parse(*body);
+                doNotOptimize(doc.getString("username"));
+                doNotOptimize(doc.getString("email"));
+                doNotOptimize(doc.getString("password"));
+            }
+        });
+    }});
+
+    benches.push_back({"http", "JsonDocument::parse(2KB post, escapes)", [] {
+        std::string content;
+        for (int i = 0; i < 64; i++) content += "Line with a \\\"quote\\\" and text\\n";
+        auto body = std::make_shared<std::string>("{\"content\":\"" + content + "\"}");
+        return BenchBody([body](uint64_t n, Counters& counters) {
+            JsonDocument doc;
+            for (uint64_t i = 0; i < n; i++) {
+                doc.parse(*body);
+                doNotOptimize(doc.getString("content"));
+            }
+            counters["bytes"] = static_cast<double>(body->size()) * static_cast<double>(n);
+        });
+    }});
+
+    // Route table mirrors BiteaApp (registration order matters for matching)
+    auto makeRouter = [] {
+        auto server = std::make_shared<HttpServer>(0, 1);
+        auto ok = [](const HttpRequest&, HttpResponse& res) { res.statusCode = 200; };
+        server->get("/", ok);
+        server->get("/api", ok);
+        server->post("/api/register", ok);
+        server->post("/api/login", ok);
+        server->post("/api/logout", ok);
+        server->post("/api/posts", ok);
+        server->get("/api/posts", ok);
+        server->get("/api/posts/changes", ok);
+        server->get("/api/posts/:id", ok);
+        server->post("/api/posts/:id/like", ok);
+        server->post("/api/posts/:id/comment", ok);
+        server->get("/api/users/:username", ok);
+        server->post("/api/users/:username/follow", ok);
+        server->get("/api/blockchain", ok);
+        server->get("/api/blockchain/validate", ok);
+        server->get("/api/mine", ok);
+        server->post("/api/batch", ok);
+        return server;
+    };
+
+    benches.push_back({"http", "HttpServer::dispatch(hit, last param route)", [makeRouter] {
+        auto server = makeRouter();
+        return BenchBody([server](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) {
+                HttpRequest req;
+                req.method = HttpMethod::POST;
+                req.path = "/api/users/bob/follow";
+                HttpResponse res;
+                doNotOptimize(server->dispatch(req, res));
+            }
+        });
+    }});
+
+    benches.push_back({"http", "HttpServer::dispatch(miss)", [makeRouter] {
+        auto server = makeRouter();
+        return BenchBody([server](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) {
+                HttpRequest req;
+                req.method = HttpMethod::GET;
+                req.path = "/api/does/not/exist";
+                HttpResponse res;
+                doNotOptimize(server->dispatch(req, res));
+            }
+        });
+    }});
+
+    benches.push_back({"http", "HttpResponse::toString", [] {
+        auto res = std::make_shared<HttpResponse>();
+        res->json(samplePost(10, 3).toJson());
+        return BenchBody([res](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(res->toString());
+        });
+    }});
+
+    // ---------------------------------------------------------------- models
+    benches.push_back({"models", "Post::toJson", [] {
+        auto post = std::make_shared<Post>(samplePost(50, 20));
+        return BenchBody([post](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(post->toJson());
+        });
+    }});
+
+    benches.push_back({"models", "Post::toDetailedJson(20 comments)", [] {
+        auto post = std::make_shared<Post>(samplePost(50, 20));
+        return BenchBody([post](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(post->toDetailedJson());
+        });
+    }});
+
+    // GET /api/posts shape: 50 posts into one reused body buffer, per wire format
+    for (auto format : {WireFormat::JSON, WireFormat::CBOR, WireFormat::MSGPACK}) {
+        std::string name = std::string("JsonWriter feed(50 posts, ") + wireFormatContentType(format) + ")";
+        benches.push_back({"models", name, [format] {
+            auto posts = std::make_shared<std::vector<Post>>();
+            for (int i = 0; i < 50; i++) posts->push_back(samplePost(i % 10, i % 4));
+            return BenchBody([posts, format](uint64_t n, Counters& counters) {
+                std::string body;
+                for (uint64_t i = 0; i < n; i++) {
+                    body.clear();
+                    JsonWriter writer(body, format);
+                    writer.beginArray();
+                    for (const auto& post : *posts) post.writeJson(writer);
+                    writer.endArray();
+                    doNotOptimize(body);
+                }
+                counters["bytes"] = static_cast<double>(body.size()) * static_cast<double>(n);
+            });
+        }});
+    }
+
+    // ---------------------------------------------------------------- validation
+    auto content = std::make_shared<std::string>();
+    for (int i = 0; i < 16; i++) *content += "<b>Hello</b> & \"friends\" of 'bitea' / posts\n";
+
+    benches.push_back({"validation", "InputValidator::sanitize(1KB)", [content] {
+        return BenchBody([content](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::sanitize(*content));
+        });
+    }});
+    benches.push_back({"validation", "InputValidator::isValidUsername", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::isValidUsername("alice_1984"));
+        });
+    }});
+    benches.push_back({"validation", "InputValidator::isValidEmail", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::isValidEmail("alice.smith@example.com"));
+        });
+    }});
+    benches.push_back({"validation", "InputValidator::isValidPassword", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::isValidPassword("correct horse 42"));
+        });
+    }});
+    benches.push_back({"validation", "InputValidator::isValidPostContent(1KB)", [content] {
+        return BenchBody([content](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::isValidPostContent(*content));
+        });
+    }});
+    benches.push_back({"validation", "InputValidator::trimWhitespace", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(InputValidator::trimWhitespace("   padded value \t\n"));
+        });
+    }});
+
+    // ---------------------------------------------------------------- observability
+    benches.push_back({"observability", "Metrics::observe", [] {
+        Metrics::instance().describe("bitea_bench_seconds", MetricType::HISTOGRAM, "Benchmark series");
+        int id = Metrics::instance().series("bitea_bench_seconds", "op=\"observe\"");
+        return BenchBody([id](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) Metrics::instance().observe(id, i & 0xFFFF);
+        });
+    }});
+    benches.push_back({"observability", "Metrics::series(cached lookup)", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) {
+                doNotOptimize(Metrics::instance().series("bitea_http_request_duration_seconds",
+                                                         "method=\"GET\",route=\"/api/posts/:id\",status=\"200\""));
+            }
+        });
+    }});
+    benches.push_back({"observability", "TraceScope(bound trace, 32 spans)", [] {
+        return BenchBody([](uint64_t n, Counters& counters) {
+            for (uint64_t i = 0; i < n; i++) {
+                RequestTrace trace(RequestTrace::Clock::now());
+                TraceBinding binding(&trace);
+                for (int k = 0; k < 32; k++) TraceScope span("bench");
+                doNotOptimize(trace.getSpanCount());
+            }
+            counters["spans"] = static_cast<double>(n) * 32;
+        });
+    }});
+    benches.push_back({"observability", "BITEA_LOG_DEBUG(disabled)", [] {
+        return BenchBody([](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) BITEA_LOG_DEBUG("Bench", "value %llu", static_cast<unsigned long long>(i));
+        });
+    }});
+
+    // ---------------------------------------------------------------- storage (mocks)
+    auto makeMongo = [](size_t posts) {
+        auto mongo = std::make_shared<MongoClient>();
+        mongo->connect();
+        for (size_t i = 0; i < posts; i++) {
+            Post post("user" + std::to_string(i % 50) + "-" + std::to_string(1700000000 + i),
+                      "user" + std::to_string(i % 50), "Post body " + std::to_string(i));
+            mongo->insertPost(post);
+        }
+        for (size_t i = 0; i < 50; i++) {
+            mongo->insertUser(User("user" + std::to_string(i), "user" + std::to_string(i) + "@x.io", "password123"));
+        }
+        return mongo;
+    };
+
+    benches.push_back({"storage", "MongoClient(mock)::insertPost", [makeMongo] {
+        auto mongo = makeMongo(0);
+        auto post = std::make_shared<Post>(samplePost(0, 0));
+        return BenchBody([mongo, post](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(mongo->insertPost(*post));
+        });
+    }});
+    benches.push_back({"storage", "MongoClient(mock)::findPost(1000 posts)", [makeMongo] {
+        auto mongo = makeMongo(1000);
+        return BenchBody([mongo](uint64_t n, Counters&) {
+            Post post;
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(mongo->findPost("user7-1700000507", post));
+        });
+    }});
+    benches.push_back({"storage", "MongoClient(mock)::updatePost", [makeMongo] {
+        auto mongo = makeMongo(1000);
+        auto post = std::make_shared<Post>();
+        mongo->findPost("user7-1700000507", *post);
+        return BenchBody([mongo, post](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(mongo->updatePost(*post));
+        });
+    }});
+    benches.push_back({"storage", "MongoClient(mock)::getAllPosts(1000 posts)", [makeMongo] {
+        auto mongo = makeMongo(1000);
+        return BenchBody([mongo](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(mongo->getAllPosts());
+        });
+    }});
+    // Keyset page cost should not depend on collection size or page depth
+    for (size_t total : {1000, 10000}) {
+        std::string name = "MongoClient(mock)::getPostsPage(50 of " + std::to_string(total) + " posts, mid-feed)";
+        benches.push_back({"storage", name, [makeMongo, total] {
+            auto mongo = makeMongo(total);
+            FeedPage first;
+            mongo->getPostsPage(FeedCursor{}, total / 2, first);
+            auto cursor = std::make_shared<FeedCursor>(FeedCursor::after(first.posts.back()));
+            return BenchBody([mongo, cursor](uint64_t n, Counters&) {
+                FeedPage page;
+                for (uint64_t i = 0; i < n; i++) {
+                    mongo->getPostsPage(*cursor, 50, page);
+                    doNotOptimize(page.nextCursor);
+                }
+            });
+        }});
+    }
+    benches.push_back({"storage", "MongoClient(mock)::findUser", [makeMongo] {
+        auto mongo = makeMongo(0);
+        return BenchBody([mongo](uint64_t n, Counters&) {
+            User user;
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(mongo->findUser("user25", user));
+        });
+    }});
+
+    auto makeRedis = [](size_t sessions, std::vector<std::string>* ids) {
+        auto redis = std::make_shared<RedisClient>();
+        redis->connect();
+        for (size_t i = 0; i < sessions; i++) {
+            Session session("user" + std::to_string(i));
+            redis->createSession(session);
+            if (ids) ids->push_back(session.getSessionId());
+        }
+        return redis;
+    };
+
+    benches.push_back({"storage", "RedisClient(mock)::createSession", [makeRedis] {
+        auto redis = makeRedis(0, nullptr);
+        auto session = std::make_shared<Session>("alice");
+        return BenchBody([redis, session](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(redis->createSession(*session));
+        });
+    }});
+    benches.push_back({"storage", "RedisClient(mock)::getSession(1000 sessions)", [makeRedis] {
+        auto ids = std::make_shared<std::vector<std::string>>();
+        auto redis = makeRedis(1000, ids.get());
+        return BenchBody([redis, ids](uint64_t n, Counters&) {
+            Session session;
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(redis->getSession((*ids)[i % ids->size()], session));
+        });
+    }});
+    benches.push_back({"storage", "RedisClient(mock)::refreshSession", [makeRedis] {
+        auto ids = std::make_shared<std::vector<std::string>>();
+        auto redis = makeRedis(1000, ids.get());
+        return BenchBody([redis, ids](uint64_t n, Counters&) {
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(redis->refreshSession((*ids)[i % ids->size()]));
+        });
+    }});
+    benches.push_back({"storage", "RedisClient(mock)::getAndRefreshSession(1000 sessions)", [makeRedis] {
+        auto ids = std::make_shared<std::vector<std::string>>();
+        auto redis = makeRedis(1000, ids.get());
+        return BenchBody([redis, ids](uint64_t n, Counters&) {
+            Session session;
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(redis->getAndRefreshSession((*ids)[i % ids->size()], session));
+        });
+    }});
+    benches.push_back({"storage", "RedisClient(mock)::set+get", [makeRedis] {
+        auto redis = makeRedis(0, nullptr);
+        return BenchBody([redis](uint64_t n, Counters&) {
+            std::string value;
+            for (uint64_t i = 0; i < n; i++) {
+                redis->set("bench:key", "value");
+                doNotOptimize(redis->get("bench:key", value));
+            }
+        });
+    }});
+
+    // Signed session tokens: the local check that replaces a Redis round trip
+    auto signer = std::make_shared<SessionTokenSigner>();
+    std::string keyError;
+    signer->configure("bench:0123456789abcdef0123456789abcdef", keyError);
+    benches.push_back({"auth", "SessionTokenSigner::mint", [signer] {
+        return BenchBody([signer](uint64_t n, Counters&) {
+            TokenClaims claims;
+            for (uint64_t i = 0; i < n; i++) doNotOptimize(signer->mint("alice", 1729600000, 86400, claims));
+        });
+    }});
+    benches.push_back({"auth", "SessionTokenSigner::verify+RevokedTokens::contains(1000 revoked)", [signer] {
+        auto revoked = std::make_shared<RevokedTokens>();
+        RevokedTokens::Entries entries;
+        for (int i = 0; i < 1000; i++) entries.emplace_back("revoked" + std::to_string(i), 1829600000);
+        revoked->merge(entries, 1729600000);
+        TokenClaims minted;
+        auto token = std::make_shared<std::string>(signer->mint("alice", 1729600000, 86400, minted));
+        return BenchBody([signer, revoked, token](uint64_t n, Counters&) {
+            TokenClaims claims;
+            for (uint64_t i = 0; i < n; i++) {
+                doNotOptimize(signer->verify(*token, 1729600100, claims) && !revoked->contains(claims.tokenId));
+            }
+        });
+    }});
+
+    return benches;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void printUsage() {
+    fprintf(stderr,
+        "Usage: bitea_bench [options]\n"
+        "  --iterations N     Fixed iterations per batch (default: auto-calibrate)\n"
+        "  --min-time-ms MS   Calibration target per batch (default 50)\n"
+        "  --repetitions N    Timed batches per benchmark (default 5)\n"
+        "  --filter TEXT      Only run benchmarks whose subsystem/name contains TEXT\n"
+        "  --out FILE         Write JSON to FILE instead of stdout\n"
+        "  --list             List benchmarks and exit\n");
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--iterations") cfg.iterations = std::strtoull(next(), nullptr, 10);
+        else if (arg == "--min-time-ms") cfg.minTimeMs = std::atof(next());
+        else if (arg == "--repetitions") cfg.repetitions = std::atoi(next());
+        else if (arg == "--filter") cfg.filter = next();
+        else if (arg == "--out") cfg.outPath = next();
+        else if (arg == "--list") cfg.list = true;
+        else {
+            printUsage();
+            return false;
+        }
+    }
+    if (cfg.repetitions <= 0) cfg.repetitions = 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) return 1;
+
+    std::vector<Benchmark> benches = buildBenchmarks();
+    if (cfg.list) {
+        for (const auto& b : benches) printf("%s/%s\n", b.subsystem.c_str(), b.name.c_str());
+        return 0;
+    }
+
+    FILE* out = stdout;
+    if (!cfg.outPath.empty()) {
+        out = fopen(cfg.outPath.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot open %s\n", cfg.outPath.c_str());
+            return 1;
+        }
+    }
+
+    // Storage and mining log through the async logger; keep it quiet while measuring
+    Logger::instance().setLevel(LogLevel::OFF);
+
+    fprintf(out, "{\"schema\":1,\"storage_backend\":\"mock\",");
+    fprintf(out, "\"config\":{\"iterations\":%llu,\"min_time_ms\":%.1f,\"repetitions\":%d},",
+            static_cast<unsigned long long>(cfg.iterations), cfg.minTimeMs, cfg.repetitions);
+    fprintf(out, "\"benchmarks\":[");
+
+    bool first = true;
+    for (const auto& bench : benches) {
+        std::string fullName = bench.subsystem + "/" + bench.name;
+        if (!cfg.filter.empty() && fullName.find(cfg.filter) == std::string::npos) continue;
+
+        BenchBody body = bench.setup();
+        uint64_t iterations = cfg.iterations ? cfg.iterations : calibrate(body, cfg.minTimeMs);
+
+        Counters counters;
+        runBatch(body, iterations, counters);  // Warm-up (caches, allocator)
+
+        std::vector<double> nsPerOp;
+        Counters totals;
+        for (int r = 0; r < cfg.repetitions; r++) {
+            double ns = runBatch(body, iterations, counters);
+            nsPerOp.push_back(ns / static_cast<double>(iterations));
+            for (const auto& c : counters) totals[c.first] += c.second;
+        }
+
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+        double mean = 0;
+        for (double v : nsPerOp) mean += v;
+        mean /= static_cast<double>(nsPerOp.size());
+        double variance = 0;
+        for (double v : nsPerOp) variance += (v - mean) * (v - mean);
+        double stddev = std::sqrt(variance / static_cast<double>(nsPerOp.size()));
+        size_t mid = nsPerOp.size() / 2;
+        double median = nsPerOp.size() % 2 ? nsPerOp[mid] : (nsPerOp[mid - 1] + nsPerOp[mid]) / 2;
+
+        fprintf(out, "%s\n{\"subsystem\":\"%s\",\"name\":\"%s\",\"iterations\":%llu,\"repetitions\":%d,",
+                first ? "" : ",", bench.subsystem.c_str(), bench.name.c_str(),
+                static_cast<unsigned long long>(iterations), cfg.repetitions);
+        fprintf(out, "\"ns_per_op\":{\"min\":%.2f,\"median\":%.2f,\"mean\":%.2f,\"max\":%.2f,\"stddev\":%.2f},",
+                nsPerOp.front(), median, mean, nsPerOp.back(), stddev);
+        fprintf(out, "\"counters\":{");
+        bool firstCounter = true;
+        double ops = static_cast<double>(iterations) * cfg.repetitions;
+        for (const auto& c : totals) {
+            fprintf(out, "%s\"%s_per_op\":%.3f", firstCounter ? "" : ",", c.first.c_str(), c.second / ops);
+            firstCounter = false;
+        }
+        fprintf(out, "}}");
+        fflush(out);
+        first = false;
+
+        fprintf(stderr, "%-60s %12.1f ns/op\n", fullName.c_str(), median);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * HTTPCLIENT.H - Minimal Blocking HTTP/1.1 Client for Bitea Tools
+ *
+ * PURPOSE:
+ * Tiny POSIX-socket HTTP client used by the load generator and other
+ * command-line tools to drive a running Bitea server. No dependencies.
+ *
+ * PROTOCOL:
+ * - One TCP connection per request ("Connection: close"), matching the
+ *   server, which closes every connection after responding
+ * - Request is written with a single buffer; response is read until EOF
+ * - Only the status code, headers and body are parsed
+ *
+ * THREAD SAFETY:
+ * HttpClient holds only the resolved address; request() can be called from
+ * many threads at once.
+ ******************************************************************************/
+
+#ifndef TOOLS_HTTPCLIENT_H
+#define TOOLS_HTTPCLIENT_H
+
+#include <cstdlib>      // std::atoi - status code
+#include <cstring>      // memset
+#include <map>          // std::map - extra request headers
+#include <string>       // std::string - request/response buffers
+
+#include <arpa/inet.h>  // inet_pton - numeric address parsing
+#include <netdb.h>      // getaddrinfo - host name resolution
+#include <netinet/in.h> // sockaddr_in
+#include <netinet/tcp.h> // TCP_NODELAY
+#include <sys/socket.h> // socket, connect
+#include <sys/time.h>   // struct timeval - socket timeouts
+#include <unistd.h>     // read, write, close
+
+/**
+ * @struct HttpResult
+ * @brief Outcome of one request
+ *
+ * status == 0 means a transport error (connect/send/receive failed);
+ * error then holds a short description.
+ */
+struct HttpResult {
+    int status = 0;             // HTTP status code (0 = transport error)
+    std::string body;           // Response body
+    std::string contentType;    // Content-Type header (if any)
+    std::string error;          // Transport error description
+};
+
+/**
+ * @class HttpClient
+ * @brief Sends requests to one host:port
+ */
+class HttpClient {
+private:
+    std::string host;            // Host name for the Host header
+    int port;                    // Server port
+    sockaddr_in address;         // Resolved IPv4 address
+    bool resolved;               // True if host resolved successfully
+    int timeoutSeconds;          // Send/receive timeout per request
+
+public:
+    /**
+     * @brief Resolves the server address once
+     * @param host Host name or IPv4 address
+     * @param port Server port
+     * @param timeoutSeconds Socket send/receive timeout
+     */
+    HttpClient(const std::string& host, int port, int timeoutSeconds = 10)
+        : host(host), port(port), resolved(false), timeoutSeconds(timeoutSeconds) {
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) == 1) {
+            resolved = true;
+            return;
+        }
+
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* info = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &info) == 0 && info) {
+            address.sin_addr = reinterpret_cast<sockaddr_in*>(info->ai_addr)->sin_addr;
+            resolved = true;
+        }
+        if (info) freeaddrinfo(info);
+    }
+
+    /** @brief True if the host name could be resolved */
+    bool isResolved() const { return resolved; }
+
+    /**
+     * @brief Sends one request and waits for the full response
+     * @param method "GET", "POST", ...
+     * @param path Request target including query string
+     * @param body Request body (sent as application/json when non-empty)
+     * @param headers Extra headers (e.g. Authorization)
+     * @return HttpResult - status 0 on transport failure
+     */
+    HttpResult request(const std::string& method, const std::string& path,
+                       const std::string& body = "",
+                       const std::map<std::string, std::string>& headers = {}) const {
+        std::string raw;
+        raw.reserve(256 + body.size());
+        raw += method + " " + path + " HTTP/1.1\r\n";
+        raw += "Host: " + host + ":" + std::to_string(port) + "\r\n";
+        raw += "Connection: close\r\n";
+        for (const auto& header : headers) {
+            raw += header.first + ": " + header.second + "\r\n";
+        }
+        if (!body.empty()) {
+            raw += "Content-Type: application/json\r\n";
+        }
+        raw += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        raw += body;
+        return sendRaw(raw);
+    }
+
+    /**
+     * @brief Sends pre-built request bytes verbatim (used by replay)
+     * @param raw Complete HTTP request (request line, headers, body)
+     * @return HttpResult - status 0 on transport failure
+     */
+    HttpResult sendRaw(const std::string& raw) const {
+        HttpResult result;
+        if (!resolved) {
+            result.error = "unresolved host";
+            return result;
+        }
+
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            result.error = "socket failed";
+            return result;
+        }
+
+        struct timeval timeout = { timeoutSeconds, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            result.error = "connect failed";
+            return result;
+        }
+
+        // Whole request in one write (server parses a single read())
+        size_t sent = 0;
+        while (sent < raw.size()) {
+            ssize_t n = write(fd, raw.data() + sent, raw.size() - sent);
+            if (n <= 0) {
+                close(fd);
+                result.error = "send failed";
+                return result;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        // Read until the server closes the connection
+        std::string response;
+        char buffer[16384];
+        for (;;) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n < 0) {
+                close(fd);
+                result.error = "receive failed";
+                return result;
+            }
+            if (n == 0) break;
+            response.append(buffer, static_cast<size_t>(n));
+        }
+        close(fd);
+
+        // Status line: "HTTP/1.1 200 OK"
+        size_t space = response.find(' ');
+        if (response.compare(0, 5, "HTTP/") != 0 || space == std::string::npos) {
+            result.error = "malformed response";
+            return result;
+        }
+        result.status = std::atoi(response.c_str() + space + 1);
+
+        size_t headerEnd = response.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) return result;
+        result.body = response.substr(headerEnd + 4);
+
+        size_t ct = response.find("Content-Type: ");
+        if (ct != std::string::npos && ct < headerEnd) {
+            size_t eol = response.find("\r\n", ct);
+            result.contentType = response.substr(ct + 14, eol - ct - 14);
+        }
+        return result;
+    }
+};
+
+#endif // TOOLS_HTTPCLIENT_H
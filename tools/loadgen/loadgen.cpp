@@ -0,0 +1,395 @@
+/*******************************************************************************
+ * LOADGEN.CPP - Open-Loop HTTP Load Generator for the Bitea API
+ *
+ * PURPOSE:
+ * Reproducible way to put a running Bitea server under load and measure it.
+ * Drives the real REST API (register, login, post, like, comment, follow,
+ * feed) in a configurable mix and reports throughput plus latency
+ * percentiles per endpoint.
+ *
+ * OPEN-LOOP DESIGN:
+ * Requests are scheduled at a fixed aggregate rate, independent of how fast
+ * the server answers. Request i is due at start + i / rate; latency is
+ * measured from that INTENDED start time, not from when the client got
+ * around to sending it. A slow server therefore shows up as growing latency
+ * instead of silently lowering the offered load (coordinated omission).
+ *
+ * PHASES:
+ * 1. Setup: register --users accounts, log them in, seed one post each
+ * 2. Run:   --threads workers split the arrival schedule round-robin and
+ *           execute a weighted-random operation per arrival
+ * 3. Report: per-endpoint histograms are merged and printed
+ *
+ * USAGE:
+ * ./bitea_server &                        # mock DB build is fine
+ * ./bitea_loadgen --rate 200 --duration 30 \
+ *     --mix register=1,login=4,post=15,like=40,comment=20,follow=10,feed=10
+ *
+ * Run ./bitea_loadgen --help for all options.
+ ******************************************************************************/
+
+#include <algorithm>    // std::max - merging lag
+#include <atomic>       // std::atomic - shared counters
+#include <chrono>       // std::chrono - scheduling and timing
+#include <cstdio>       // printf - report formatting
+#include <cstdlib>      // std::atoi, std::atof
+#include <iostream>     // std::cout, std::cerr
+#include <map>          // std::map - endpoint histograms
+#include <mutex>        // std::mutex - shared post-id pool
+#include <random>       // std::mt19937 - operation mix, targets
+#include <sstream>      // std::stringstream - mix parsing
+#include <string>       // std::string
+#include <thread>       // std::thread - worker threads
+#include <vector>       // std::vector
+
+#include "common/HttpClient.h"        // Blocking HTTP client
+#include "utils/LatencyHistogram.h"   // HdrHistogram-style percentiles
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/**
+ * @struct LoadConfig
+ * @brief Command-line options
+ */
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    int port = 3000;
+    double rate = 100.0;          // Aggregate requests per second
+    double duration = 10.0;       // Seconds of measured load
+    int threads = 8;              // Client worker threads
+    int users = 20;               // Accounts created during setup
+    std::map<std::string, int> mix = {
+        {"register", 1}, {"login", 4}, {"post", 15}, {"like", 40},
+        {"comment", 20}, {"follow", 10}, {"feed", 10}
+    };
+};
+
+/** @brief Operations understood in --mix, in report order */
+static const std::vector<std::string> OPERATIONS = {
+    "register", "login", "post", "like", "comment", "follow", "feed"
+};
+
+static void printUsage() {
+    std::cout <<
+        "Usage: bitea_loadgen [options]\n"
+        "  --host HOST        Server host (default 127.0.0.1)\n"
+        "  --port PORT        Server port (default 3000)\n"
+        "  --rate N           Offered load, requests/second (default 100)\n"
+        "  --duration SEC     Measured run length in seconds (default 10)\n"
+        "  --threads N        Client threads (default 8)\n"
+        "  --users N          Accounts registered during setup (default 20)\n"
+        "  --mix LIST         Operation weights, e.g.\n"
+        "                     register=1,login=4,post=15,like=40,comment=20,follow=10,feed=10\n";
+}
+
+/**
+ * @brief Parses "op=weight,op=weight" into cfg.mix (replaces defaults)
+ * @return bool - false on unknown operation or malformed entry
+ */
+static bool parseMix(const std::string& text, LoadConfig& cfg) {
+    std::map<std::string, int> mix;
+    std::stringstream stream(text);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        size_t eq = entry.find('=');
+        if (eq == std::string::npos) return false;
+        std::string op = entry.substr(0, eq);
+        bool known = false;
+        for (const auto& name : OPERATIONS) known = known || name == op;
+        if (!known) return false;
+        mix[op] = std::atoi(entry.c_str() + eq + 1);
+    }
+    cfg.mix = mix;
+    return true;
+}
+
+static bool parseArgs(int argc, char** argv, LoadConfig& cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--host") cfg.host = next();
+        else if (arg == "--port") cfg.port = std::atoi(next());
+        else if (arg == "--rate") cfg.rate = std::atof(next());
+        else if (arg == "--duration") cfg.duration = std::atof(next());
+        else if (arg == "--threads") cfg.threads = std::atoi(next());
+        else if (arg == "--users") cfg.users = std::atoi(next());
+        else if (arg == "--mix") {
+            if (!parseMix(next(), cfg)) {
+                std::cerr << "Invalid --mix" << std::endl;
+                return false;
+            }
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+    if (cfg.rate <= 0 || cfg.duration <= 0 || cfg.threads <= 0 || cfg.users <= 0) {
+        std::cerr << "rate, duration, threads and users must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SHARED STATE
+// ============================================================================
+
+/**
+ * @struct Account
+ * @brief Registered user with an active session
+ */
+struct Account {
+    std::string username;
+    std::string token;
+};
+
+/**
+ * @struct EndpointStats
+ * @brief Per-thread results for one operation
+ */
+struct EndpointStats {
+    LatencyHistogram latency;   // Microseconds from intended start
+    uint64_t errors = 0;        // Non-2xx or transport failures
+};
+
+/**
+ * @class Workload
+ * @brief Accounts, known post ids and the request helpers
+ */
+class Workload {
+private:
+    const HttpClient& client;
+    std::string runPrefix;                  // Unique per run (usernames)
+    std::vector<Account> accounts;          // Read-only after setup
+    std::vector<std::string> postIds;       // Grows as posts are created
+    std::mutex postMutex;                   // Protects postIds
+    std::atomic<uint64_t> userCounter{0};   // Suffix for new usernames
+
+    /** @brief Extracts "key":"value" from a flat JSON response */
+    static std::string jsonString(const std::string& json, const std::string& key) {
+        std::string needle = "\"" + key + "\":\"";
+        size_t start = json.find(needle);
+        if (start == std::string::npos) return "";
+        start += needle.size();
+        size_t end = json.find('"', start);
+        return end == std::string::npos ? "" : json.substr(start, end - start);
+    }
+
+    static std::string credentials(const std::string& username) {
+        return "{\"username\":\"" + username + "\",\"email\":\"" + username +
+               "@loadgen.test\",\"password\":\"loadgen123\"}";
+    }
+
+    static std::map<std::string, std::string> auth(const Account& account) {
+        return {{"Authorization", "Bearer " + account.token}};
+    }
+
+    std::string nextUsername() {
+        return runPrefix + std::to_string(userCounter.fetch_add(1));
+    }
+
+    std::string randomPost(std::mt19937& rng) {
+        std::lock_guard<std::mutex> lock(postMutex);
+        if (postIds.empty()) return "missing";
+        return postIds[std::uniform_int_distribution<size_t>(0, postIds.size() - 1)(rng)];
+    }
+
+    void rememberPost(const HttpResult& result) {
+        std::string id = jsonString(result.body, "id");
+        if (id.empty()) return;
+        std::lock_guard<std::mutex> lock(postMutex);
+        postIds.push_back(id);
+    }
+
+public:
+    explicit Workload(const HttpClient& client) : client(client) {
+        // Short prefix keeps usernames within the 20-character limit
+        runPrefix = "lg" + std::to_string(
+            std::chrono::system_clock::now().time_since_epoch().count() % 1000000) + "_";
+    }
+
+    /**
+     * @brief Registers and logs in accounts, seeds one post per account
+     * @return bool - false if no account could be set up
+     */
+    bool setup(int userCount) {
+        for (int i = 0; i < userCount; i++) {
+            std::string username = nextUsername();
+            HttpResult reg = client.request("POST", "/api/register", credentials(username));
+            if (reg.status != 201) {
+                std::cerr << "register " << username << " failed: "
+                          << (reg.status ? std::to_string(reg.status) : reg.error) << std::endl;
+                continue;
+            }
+            HttpResult login = client.request("POST", "/api/login", credentials(username));
+            std::string token = jsonString(login.body, "sessionId");
+            if (login.status != 200 || token.empty()) {
+                std::cerr << "login " << username << " failed" << std::endl;
+                continue;
+            }
+            accounts.push_back(Account{username, token});
+            rememberPost(client.request("POST", "/api/posts",
+                "{\"content\":\"seed post from " + username + "\"}", auth(accounts.back())));
+        }
+        return !accounts.empty();
+    }
+
+    size_t accountCount() const { return accounts.size(); }
+
+    /**
+     * @brief Executes one operation as a random account
+     * @return HttpResult - server response
+     */
+    HttpResult execute(const std::string& op, std::mt19937& rng) {
+        const Account& me = accounts[std::uniform_int_distribution<size_t>(0, accounts.size() - 1)(rng)];
+
+        if (op == "register") {
+            return client.request("POST", "/api/register", credentials(nextUsername()));
+        }
+        if (op == "login") {
+            return client.request("POST", "/api/login", credentials(me.username));
+        }
+        if (op == "post") {
+            HttpResult result = client.request("POST", "/api/posts",
+                "{\"content\":\"load test post " + std::to_string(rng()) + "\"}", auth(me));
+            if (result.status == 201) rememberPost(result);
+            return result;
+        }
+        if (op == "like") {
+            return client.request("POST", "/api/posts/" + randomPost(rng) + "/like", "", auth(me));
+        }
+        if (op == "comment") {
+            return client.request("POST", "/api/posts/" + randomPost(rng) + "/comment",
+                "{\"content\":\"load test comment\"}", auth(me));
+        }
+        if (op == "follow") {
+            const Account& target = accounts[std::uniform_int_distribution<size_t>(0, accounts.size() - 1)(rng)];
+            return client.request("POST", "/api/users/" + target.username + "/follow", "", auth(me));
+        }
+        return client.request("GET", "/api/posts");  // feed
+    }
+};
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+static void printRow(const std::string& name, const EndpointStats& stats, double seconds) {
+    const LatencyHistogram& h = stats.latency;
+    auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+    printf("%-10s %8llu %7llu %9.1f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+           name.c_str(),
+           static_cast<unsigned long long>(h.count()),
+           static_cast<unsigned long long>(stats.errors),
+           static_cast<double>(h.count()) / seconds,
+           h.mean() / 1000.0, ms(h.percentile(50)), ms(h.percentile(90)),
+           ms(h.percentile(99)), ms(h.percentile(99.9)), ms(h.max()));
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    LoadConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) return 1;
+
+    // Weighted operation table
+    std::vector<std::string> ops;
+    std::vector<int> weights;
+    for (const auto& op : OPERATIONS) {
+        auto it = cfg.mix.find(op);
+        if (it != cfg.mix.end() && it->second > 0) {
+            ops.push_back(op);
+            weights.push_back(it->second);
+        }
+    }
+    if (ops.empty()) {
+        std::cerr << "Mix has no operations with positive weight" << std::endl;
+        return 1;
+    }
+
+    HttpClient client(cfg.host, cfg.port);
+    if (!client.isResolved()) {
+        std::cerr << "Cannot resolve " << cfg.host << std::endl;
+        return 1;
+    }
+
+    Workload workload(client);
+    std::cout << "Setting up " << cfg.users << " users on " << cfg.host << ":" << cfg.port << "..." << std::endl;
+    if (!workload.setup(cfg.users)) {
+        std::cerr << "Setup failed - is the server running?" << std::endl;
+        return 1;
+    }
+
+    const uint64_t totalRequests = static_cast<uint64_t>(cfg.rate * cfg.duration);
+    const double intervalNs = 1e9 / cfg.rate;
+    std::cout << "Running " << totalRequests << " requests at " << cfg.rate << " req/s with "
+              << cfg.threads << " threads (" << workload.accountCount() << " accounts)" << std::endl;
+
+    // Per-thread stats, merged after the run (no sharing on the hot path)
+    std::vector<std::vector<EndpointStats>> perThread(cfg.threads, std::vector<EndpointStats>(ops.size()));
+    std::vector<uint64_t> maxLagUs(cfg.threads, 0);
+    std::vector<std::thread> workers;
+    const Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+
+    for (int t = 0; t < cfg.threads; t++) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<uint32_t>(std::random_device{}() + t));
+            std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+            // Arrivals t, t + threads, t + 2*threads, ... of the global schedule
+            for (uint64_t i = static_cast<uint64_t>(t); i < totalRequests; i += cfg.threads) {
+                Clock::time_point intended = start + std::chrono::nanoseconds(
+                    static_cast<int64_t>(static_cast<double>(i) * intervalNs));
+                Clock::time_point now = Clock::now();
+                if (now < intended) {
+                    std::this_thread::sleep_until(intended);
+                } else {
+                    uint64_t lag = std::chrono::duration_cast<std::chrono::microseconds>(now - intended).count();
+                    if (lag > maxLagUs[t]) maxLagUs[t] = lag;
+                }
+
+                size_t op = pick(rng);
+                HttpResult result = workload.execute(ops[op], rng);
+
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - intended);
+                EndpointStats& stats = perThread[t][op];
+                stats.latency.record(static_cast<uint64_t>(latency.count()));
+                if (result.status < 200 || result.status >= 300) stats.errors++;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Merge and report
+    std::vector<EndpointStats> merged(ops.size());
+    EndpointStats total;
+    uint64_t worstLag = 0;
+    for (int t = 0; t < cfg.threads; t++) {
+        worstLag = std::max(worstLag, maxLagUs[t]);
+        for (size_t op = 0; op < ops.size(); op++) {
+            merged[op].latency.merge(perThread[t][op].latency);
+            merged[op].errors += perThread[t][op].errors;
+            total.latency.merge(perThread[t][op].latency);
+            total.errors += perThread[t][op].errors;
+        }
+    }
+
+    printf("\n%-10s %8s %7s %9s %9s %9s %9s %9s %9s %9s\n",
+           "endpoint", "count", "errors", "req/s", "mean ms", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+    for (size_t op = 0; op < ops.size(); op++) printRow(ops[op], merged[op], elapsed);
+    printRow("TOTAL", total, elapsed);
+    printf("\nElapsed %.2fs, offered %.1f req/s, achieved %.1f req/s, max schedule lag %.2f ms\n",
+           elapsed, cfg.rate, static_cast<double>(total.latency.count()) / elapsed,
+           static_cast<double>(worstLag) / 1000.0);
+    if (worstLag > 100000) {
+        printf("Note: client fell behind schedule; add --threads if the server is not saturated\n");
+    }
+    return 0;
+}
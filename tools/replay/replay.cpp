@@ -0,0 +1,350 @@
+/*******************************************************************************
+ * REPLAY.CPP - Replays a Captured Traffic File Against a Bitea Server
+ *
+ * PURPOSE:
+ * Re-issues requests recorded by HttpServer's capture mode (see
+ * backend/server/TrafficCapture.h) with their original inter-arrival timing,
+ * optionally sped up or slowed down, so changes can be benchmarked on real
+ * traffic shape offline.
+ *
+ * TIMING:
+ * Record i is due at replayStart + offsetMicros / speed. --speed 2 replays
+ * twice as fast, --speed 0 sends as fast as --threads allows. Latency is
+ * measured from the due time (open loop, same as bitea_loadgen).
+ *
+ * IDENTIFIER REMAPPING:
+ * Captured session tokens and post ids are meaningless to a fresh server
+ * (both are generated at runtime). When a captured response carried
+ * "sessionId":"OLD" or "id":"OLD" and the replayed response carries the
+ * same key with NEW, later requests are rewritten: the Authorization bearer
+ * token and any path segment equal to OLD become NEW. A request that uses
+ * an identifier whose creating request is still in flight waits for it (up
+ * to 5s), so concurrency does not reorder login → use. Disable with
+ * --no-remap.
+ *
+ * DETERMINISM CHECK:
+ * Each replayed status is compared with the captured status; mismatches are
+ * counted per endpoint. Replay against a server started from the same
+ * initial state as the capture to expect zero mismatches.
+ *
+ * USAGE:
+ * BITEA_CAPTURE_FILE=traffic.bcap ./bitea_server    # record
+ * ./bitea_replay traffic.bcap --speed 4 --threads 32  # replay (new server)
+ ******************************************************************************/
+
+#include <algorithm>    // std::max
+#include <atomic>       // std::atomic - shared record cursor
+#include <chrono>       // std::chrono - scheduling
+#include <condition_variable>  // std::condition_variable - wait for remapped ids
+#include <cstdio>       // printf - report
+#include <cstdlib>      // std::atof, std::atoi
+#include <iostream>     // std::cerr
+#include <map>          // std::map - per-endpoint stats, token map
+#include <mutex>        // std::mutex - token map
+#include <string>       // std::string
+#include <thread>       // std::thread
+#include <vector>       // std::vector
+
+#include "common/HttpClient.h"        // sendRaw()
+#include "server/TrafficCapture.h"    // readCapture(), CaptureRecord
+#include "utils/LatencyHistogram.h"   // Percentiles
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @struct ReplayConfig
+ * @brief Command-line options
+ */
+struct ReplayConfig {
+    std::string file;
+    std::string host = "127.0.0.1";
+    int port = 3000;
+    double speed = 1.0;       // 0 = as fast as possible
+    int threads = 16;
+    size_t limit = 0;         // 0 = all records
+    bool remap = true;
+};
+
+/**
+ * @struct ReplayStats
+ * @brief Per-thread results for one endpoint
+ */
+struct ReplayStats {
+    LatencyHistogram latency;
+    uint64_t mismatches = 0;   // Replayed status != captured status
+    uint64_t failures = 0;     // Transport errors
+};
+
+static void printUsage() {
+    std::cerr <<
+        "Usage: bitea_replay FILE [options]\n"
+        "  --host HOST      Server host (default 127.0.0.1)\n"
+        "  --port PORT      Server port (default 3000)\n"
+        "  --speed X        Time scale: 1 = original, 2 = twice as fast, 0 = unthrottled\n"
+        "  --threads N      Concurrent connections (default 16)\n"
+        "  --limit N        Replay only the first N records\n"
+        "  --no-remap       Send captured session tokens and ids unchanged\n";
+}
+
+static bool parseArgs(int argc, char** argv, ReplayConfig& cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--host") cfg.host = next();
+        else if (arg == "--port") cfg.port = std::atoi(next());
+        else if (arg == "--speed") cfg.speed = std::atof(next());
+        else if (arg == "--threads") cfg.threads = std::atoi(next());
+        else if (arg == "--limit") cfg.limit = static_cast<size_t>(std::atol(next()));
+        else if (arg == "--no-remap") cfg.remap = false;
+        else if (!arg.empty() && arg[0] != '-' && cfg.file.empty()) cfg.file = arg;
+        else {
+            printUsage();
+            return false;
+        }
+    }
+    if (cfg.file.empty() || cfg.threads <= 0 || cfg.speed < 0) {
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief "POST /api/posts/abc/like?x=1 HTTP/1.1" → "POST /api/posts/ * /like"
+ * Third path segment (ids, usernames) is collapsed so endpoints group.
+ */
+static std::string endpointKey(const std::string& raw) {
+    size_t sp1 = raw.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : raw.find(' ', sp1 + 1);
+    if (sp2 == std::string::npos) return "?";
+    std::string method = raw.substr(0, sp1);
+    std::string path = raw.substr(sp1 + 1, sp2 - sp1 - 1);
+    size_t q = path.find('?');
+    if (q != std::string::npos) path.resize(q);
+
+    std::string key;
+    int segment = 0;
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t next = path.find('/', pos + 1);
+        std::string part = path.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+        key += (++segment == 3) ? "/*" : part;
+        if (next == std::string::npos) break;
+        pos = next;
+    }
+    return method + " " + (key.empty() ? "/" : key);
+}
+
+/** @brief Top-level JSON keys whose values are server-generated identifiers */
+static const char* const IDENTIFIER_KEYS[] = {"sessionId", "id"};
+
+/** @brief First value of "key":"..." in a JSON body, or "" */
+static std::string jsonString(const std::string& body, const std::string& key) {
+    std::string needle = "\"" + key + "\":\"";
+    size_t start = body.find(needle);
+    if (start == std::string::npos) return "";
+    start += needle.size();
+    size_t end = body.find('"', start);
+    return end == std::string::npos ? "" : body.substr(start, end - start);
+}
+
+/**
+ * @class IdentifierMap
+ * @brief Captured identifier → identifier issued during replay
+ *
+ * Identifiers created by captured responses are registered up front as
+ * "expected"; a request that needs one waits until the creating request has
+ * been replayed (or gave up), instead of racing ahead with a stale value.
+ */
+class IdentifierMap {
+private:
+    std::map<std::string, std::string> mapped;   // captured → replayed
+    std::map<std::string, bool> expected;        // captured → still pending
+    std::mutex mutex;
+    std::condition_variable learned;
+
+    /** @brief Replacement for one identifier (waits if pending) */
+    std::string resolve(std::unique_lock<std::mutex>& lock, const std::string& captured) {
+        auto pending = expected.find(captured);
+        if (pending != expected.end() && pending->second) {
+            learned.wait_for(lock, std::chrono::seconds(5),
+                             [&] { return !expected[captured]; });
+        }
+        auto it = mapped.find(captured);
+        return it == mapped.end() ? captured : it->second;
+    }
+
+public:
+    /** @brief Registers identifiers the captured response will define */
+    void expect(const CaptureRecord& rec) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const char* key : IDENTIFIER_KEYS) {
+            std::string value = jsonString(rec.responseBody, key);
+            if (!value.empty()) expected[value] = true;
+        }
+    }
+
+    /** @brief Pairs captured and replayed identifiers after a response */
+    void learn(const CaptureRecord& rec, const std::string& replayedBody) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const char* key : IDENTIFIER_KEYS) {
+            std::string captured = jsonString(rec.responseBody, key);
+            if (captured.empty()) continue;
+            std::string replayed = jsonString(replayedBody, key);
+            if (!replayed.empty()) mapped[captured] = replayed;
+            expected[captured] = false;   // Resolved (or failed): stop waiting
+        }
+        learned.notify_all();
+    }
+
+    /** @brief Rewrites the bearer token and path segments of a raw request */
+    std::string rewrite(const std::string& raw) {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::string out = raw;
+
+        // Authorization: Bearer <token>
+        static const std::string header = "Authorization: Bearer ";
+        size_t start = out.find(header);
+        if (start != std::string::npos) {
+            start += header.size();
+            size_t end = out.find("\r\n", start);
+            if (end != std::string::npos) {
+                out.replace(start, end - start, resolve(lock, out.substr(start, end - start)));
+            }
+        }
+
+        // Path segments of the request line: "POST /api/posts/<id>/like HTTP/1.1"
+        size_t pathStart = out.find(' ');
+        size_t pathEnd = pathStart == std::string::npos ? std::string::npos : out.find(' ', pathStart + 1);
+        if (pathEnd == std::string::npos) return out;
+        std::string path = out.substr(pathStart + 1, pathEnd - pathStart - 1);
+        std::string rebuilt;
+        size_t pos = 0;
+        while (pos <= path.size()) {
+            size_t slash = path.find_first_of("/?", pos);
+            std::string segment = path.substr(pos, slash == std::string::npos ? std::string::npos : slash - pos);
+            rebuilt += segment.empty() ? segment : resolve(lock, segment);
+            if (slash == std::string::npos) break;
+            if (path[slash] == '?') {
+                rebuilt += path.substr(slash);
+                break;
+            }
+            rebuilt += '/';
+            pos = slash + 1;
+        }
+        out.replace(pathStart + 1, pathEnd - pathStart - 1, rebuilt);
+        return out;
+    }
+};
+
+int main(int argc, char** argv) {
+    ReplayConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) return 1;
+
+    std::vector<CaptureRecord> records;
+    uint64_t captureStart = 0;
+    if (!readCapture(cfg.file, records, captureStart)) {
+        std::cerr << "Cannot read capture file " << cfg.file << std::endl;
+        return 1;
+    }
+    if (cfg.limit && records.size() > cfg.limit) records.resize(cfg.limit);
+    if (records.empty()) {
+        std::cerr << "Capture is empty" << std::endl;
+        return 1;
+    }
+
+    HttpClient client(cfg.host, cfg.port);
+    if (!client.isResolved()) {
+        std::cerr << "Cannot resolve " << cfg.host << std::endl;
+        return 1;
+    }
+
+    double capturedSeconds = static_cast<double>(records.back().offsetMicros) / 1e6;
+    printf("Replaying %zu requests (%.1fs captured) at speed %s with %d threads\n",
+           records.size(), capturedSeconds,
+           cfg.speed > 0 ? std::to_string(cfg.speed).c_str() : "unthrottled", cfg.threads);
+
+    IdentifierMap identifiers;
+    if (cfg.remap) {
+        for (const auto& rec : records) identifiers.expect(rec);
+    }
+    std::atomic<size_t> cursor{0};
+    std::vector<std::map<std::string, ReplayStats>> perThread(cfg.threads);
+    std::vector<uint64_t> maxLagUs(cfg.threads, 0);
+    const Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < cfg.threads; t++) {
+        workers.emplace_back([&, t] {
+            for (;;) {
+                size_t i = cursor.fetch_add(1);
+                if (i >= records.size()) return;
+                const CaptureRecord& rec = records[i];
+
+                Clock::time_point due = start;
+                if (cfg.speed > 0) {
+                    due += std::chrono::microseconds(static_cast<int64_t>(
+                        static_cast<double>(rec.offsetMicros) / cfg.speed));
+                    Clock::time_point now = Clock::now();
+                    if (now < due) {
+                        std::this_thread::sleep_until(due);
+                    } else {
+                        uint64_t lag = std::chrono::duration_cast<std::chrono::microseconds>(now - due).count();
+                        maxLagUs[t] = std::max(maxLagUs[t], lag);
+                    }
+                } else {
+                    due = Clock::now();
+                }
+
+                HttpResult result = client.sendRaw(cfg.remap ? identifiers.rewrite(rec.request) : rec.request);
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due);
+
+                if (cfg.remap) identifiers.learn(rec, result.body);
+
+                ReplayStats& stats = perThread[t][endpointKey(rec.request)];
+                stats.latency.record(static_cast<uint64_t>(latency.count()));
+                if (result.status == 0) stats.failures++;
+                else if (result.status != rec.status) stats.mismatches++;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Merge per-thread results
+    std::map<std::string, ReplayStats> merged;
+    ReplayStats total;
+    uint64_t worstLag = 0;
+    for (int t = 0; t < cfg.threads; t++) {
+        worstLag = std::max(worstLag, maxLagUs[t]);
+        for (const auto& entry : perThread[t]) {
+            ReplayStats& m = merged[entry.first];
+            m.latency.merge(entry.second.latency);
+            m.mismatches += entry.second.mismatches;
+            m.failures += entry.second.failures;
+            total.latency.merge(entry.second.latency);
+            total.mismatches += entry.second.mismatches;
+            total.failures += entry.second.failures;
+        }
+    }
+
+    auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+    auto row = [&](const std::string& name, const ReplayStats& s) {
+        printf("%-32s %8llu %9llu %8llu %9.2f %9.2f %9.2f %9.2f\n", name.c_str(),
+               static_cast<unsigned long long>(s.latency.count()),
+               static_cast<unsigned long long>(s.mismatches),
+               static_cast<unsigned long long>(s.failures),
+               ms(s.latency.percentile(50)), ms(s.latency.percentile(99)),
+               ms(s.latency.percentile(99.9)), ms(s.latency.max()));
+    };
+
+    printf("\n%-32s %8s %9s %8s %9s %9s %9s %9s\n",
+           "endpoint", "count", "mismatch", "failed", "p50 ms", "p99 ms", "p99.9 ms", "max ms");
+    for (const auto& entry : merged) row(entry.first, entry.second);
+    row("TOTAL", total);
+    printf("\nElapsed %.2fs (%.1f req/s), max schedule lag %.2f ms, status mismatches %llu/%llu\n",
+           elapsed, static_cast<double>(total.latency.count()) / elapsed, ms(worstLag),
+           static_cast<unsigned long long>(total.mismatches),
+           static_cast<unsigned long long>(total.latency.count()));
+    return 0;
+}